@@ -18,6 +18,7 @@
 //  02110-1301, USA.
 
 #include <iostream>
+#include <algorithm>
 #include <assert.h>
 #include "AI_Analysis.h"
 #include "AI_Allocation.h"
@@ -33,6 +34,7 @@
 #include "path.h"
 #include "ruinlist.h"
 #include "GameMap.h"
+#include "tileset.h"
 #include "GameScenarioOptions.h"
 #include "Threatlist.h"
 #include "PathCalculator.h"
@@ -54,7 +56,8 @@ AI_Allocation* AI_Allocation::s_instance = 0;
 
 
 AI_Allocation::AI_Allocation(AI_Analysis *analysis, const Threatlist *threats, Player *owner)
-    :d_owner(owner), d_analysis(analysis), d_threats(threats)
+    :d_owner(owner), d_analysis(analysis), d_threats(threats),
+    d_only_near_changes(false), d_cheapest_tile(1)
 {
     s_instance = this;
 }
@@ -249,7 +252,7 @@ int AI_Allocation::attackNearbyEnemies()
   for (auto city: *Citylist::getInstance())
     {
       sbusy.emit();
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return count;
       if (d_stacks->size() == 0)
         break;
@@ -291,7 +294,7 @@ int AI_Allocation::attackNearbyEnemies()
   for (std::list<Vector<int> >::iterator i = pos.begin(); i != pos.end(); i++)
     {
       sbusy.emit();
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return count;
       Stack *s = GameMap::getFriendlyStack(*i);
       if (!s)
@@ -331,7 +334,7 @@ int AI_Allocation::attackNearbyEnemies()
   pos = sl->getPositions();
   for (std::list<Vector<int> >::iterator i = pos.begin(); i != pos.end(); i++)
     {
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return count;
       Stack *s = GameMap::getFriendlyStack(*i);
       if (!s)
@@ -361,7 +364,7 @@ int AI_Allocation::attackNearbyEnemies()
   pos = sl->getPositions();
   for (std::list<Vector<int> >::iterator i = pos.begin(); i != pos.end(); i++)
     {
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return count;
       Stack *s = GameMap::getFriendlyStack(*i);
       if (!s)
@@ -401,7 +404,7 @@ bool AI_Allocation::emptyOutCities()
   for (auto c: *Citylist::getInstance())
     {
       sbusy.emit();
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return false;
       if (c->getOwner() != d_owner || c->isBurnt() == true)
         continue;
@@ -457,11 +460,13 @@ int AI_Allocation::visitTemples(bool get_quests)
           bool moved;
           bool killed = false;
           bool got_quest = false;
+          Vector<int> src = s->getPos();
           moved = d_owner->AI_maybeVisitTempleForQuest(s, s->getMaxMoves(), 
                                                        got_quest, killed);
           if (moved)
             {
               count++;
+              addChange(src, killed ? src : s->getPos());
               if (!killed)
                 {
                   groupStacks(s);
@@ -475,6 +480,7 @@ int AI_Allocation::visitTemples(bool get_quests)
           bool killed = false;
           bool blessed = false;
           //debug("Player " << d_owner->getName() << " moving stack " << s->getId() << " at " <<s->getPos().x << "," << s->getPos().y << " towards a temple");
+          Vector<int> src = s->getPos();
           moved = d_owner->AI_maybeVisitTempleForBlessing(s, s->getMoves(), 
                                                           50.0, blessed, 
                                                           killed);
@@ -482,6 +488,7 @@ int AI_Allocation::visitTemples(bool get_quests)
           if (moved)
             {
               count++;
+              addChange(src, killed ? src : s->getPos());
               if (!killed)
                 {
                   groupStacks(s);
@@ -508,11 +515,13 @@ int AI_Allocation::visitRuins()
           bool moved;
           bool killed = false;
           bool visited_ruin = false;
+          Vector<int> src = s->getPos();
           moved = d_owner->AI_maybeVisitRuin(s, s->getMoves(), 
                                              visited_ruin, killed);
           if (moved)
             {
               count++;
+              addChange(src, killed ? src : s->getPos());
               if (!killed)
                 {
                   groupStacks(s);
@@ -538,9 +547,13 @@ int AI_Allocation::pickupItems()
         {
           bool picked_up = false;
           bool killed = false;
+          Vector<int> src = s->getPos();
           bool moved = d_owner->AI_maybePickUpItems(s, 8, picked_up, killed);
           if (moved)
-            count++;
+            {
+              count++;
+              addChange(src, killed ? src : s->getPos());
+            }
           if (!killed && moved)
             {
               groupStacks(s);
@@ -624,13 +637,24 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   (void) default_moved;
   // move stacks
   d_stacks = new StackReflist(d_owner->getStacklist(), true);
+  if (d_only_near_changes)
+    {
+      StackReflist::iterator it = d_stacks->begin();
+      while (it != d_stacks->end())
+        {
+          if (isNearChange(*it))
+            it++;
+          else
+            it = d_stacks->eraseStack(it);
+        }
+    }
 
   debug("Player " << d_owner->getName() << " starts with " << d_stacks->size() << " stacks to do something with");
 
   int count = 0;
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
 
   // go on a quest
@@ -641,7 +665,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   debug("Player " << d_owner->getName() << " moved " << moved << " stacks in quest mode.");
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
 
   //move stacks to temples for blessing, or ones with heroes for a quest.
@@ -652,7 +676,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   debug("Player " << d_owner->getName() << " moved " << moved << " stacks in temple-visiting mode.");
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   //move hero stacks to ruins for searching.
   ruin_alloc = d_stacks->size();
@@ -662,7 +686,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   debug("Player " << d_owner->getName() << " moved " << moved << " stacks in ruin-visiting mode.");
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   //if we're near a bag of stuff, go pick it up.
   pickup_alloc = d_stacks->size();
@@ -672,7 +696,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   debug("Player " << d_owner->getName() << " moved " << moved << " stacks in pickup-items mode.");
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   // if a stack has a path for an enemy city and is outside of a city, then keep going.
   attack_alloc = d_stacks->size();
@@ -683,7 +707,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   debug("Player " << d_owner->getName() << " moved " << moved << " stacks in continuing-attacks mode.");
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   // if a stack is 2 tiles away from another enemy city, then attack it.
   immediate_alloc = d_stacks->size();
@@ -693,7 +717,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   debug("Player " << d_owner->getName() << " moved " << moved << " stacks in attack-nearby-stacks mode.");
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   //if (take_neutrals)
     {
@@ -707,7 +731,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
     }
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   defensive_alloc = d_stacks->size();
   moved = allocateDefensiveStacks(Citylist::getInstance());
@@ -724,7 +748,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
     }
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   offensive_alloc = d_stacks->size();
   moved = allocateStacksToThreats();
@@ -741,7 +765,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
     }
       
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   default_alloc = d_stacks->size();
   moved = defaultStackMovements();
@@ -751,7 +775,7 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   count+= moved;
 
   sbusy.emit();
-  if (d_owner->abortRequested())
+  if (stopThinking())
     return count;
   //empty out the cities damnit.
   emptyOutCities();
@@ -764,6 +788,47 @@ int AI_Allocation::move(City *first_city, bool take_neutrals)
   return count;
 }
 
+bool AI_Allocation::stopThinking() const
+{
+  return d_owner->abortRequested() || d_owner->isOutOfThinkTime();
+}
+
+bool AI_Allocation::isNearChange(Stack *stack) const
+{
+  // a stack can't get further than its movement points pay for at the
+  // cheapest tile cost, and it can attack or join a tile further on.  if
+  // some tile is free, there's no telling how far it can get.
+  if (d_cheapest_tile == 0)
+    return true;
+  int reach = stack->getMoves() / d_cheapest_tile + 1;
+  for (auto pos: d_near)
+    if (dist(pos, stack->getPos()) <= reach)
+      return true;
+  return false;
+}
+
+guint32 AI_Allocation::getCheapestTileCost()
+{
+  // cities, roads and bridges cost 1, see Maptile::getMoves.
+  guint32 cheapest = 1;
+  for (auto t: *GameMap::getTileset())
+    {
+      guint32 moves = t->getMoves();
+      // open water is faster.
+      if (t->getType() == Tile::WATER)
+        moves /= 2;
+      cheapest = std::min(cheapest, moves);
+    }
+  return cheapest;
+}
+
+void AI_Allocation::addChange(Vector<int> src, Vector<int> dest)
+{
+  d_changes.push_back(src);
+  if (dest != src)
+    d_changes.push_back(dest);
+}
+
 int AI_Allocation::allocateDefensiveStacksToCity(City *city)
 {
   int count = 0;
@@ -896,7 +961,7 @@ int AI_Allocation::allocateDefensiveStacks(Citylist *cities)
 	continue;
       count += allocateDefensiveStacksToCity(city);
       sbusy.emit();
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return count;
 
     }
@@ -993,7 +1058,7 @@ int AI_Allocation::allocateStacksToThreats()
       if (d_stacks->size() == 0)
         break;
       sbusy.emit();
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return count;
 
     }
@@ -1169,7 +1234,7 @@ int AI_Allocation::defaultStackMovements()
   while (d_stacks->size() > 0)
     {
       sbusy.emit();
-      if (d_owner->abortRequested())
+      if (stopThinking())
         return count;
       Stack* s = d_stacks->front();
       debug("Player " << d_owner->getName() << " thinking about default movements for stack " << s->getId() <<" at ("<<s->getPos().x<<","<<s->getPos().y<<")");
@@ -1341,6 +1406,8 @@ bool AI_Allocation::stackReinforce(Stack *s)
 void AI_Allocation::searchRuin(Stack *stack, Ruin *ruin)
 {
   bool stack_died = false;
+  //the ruin is searched now, or the stack died trying.
+  addChange(stack->getPos(), ruin->getPos());
   Reward *reward = d_owner->stackSearchRuin(stack, ruin, stack_died);
   if (reward && ruin->isSearched() == true && stack_died == false)
     {
@@ -1445,6 +1512,7 @@ bool AI_Allocation::shuffleStack(Stack *stack, Vector<int> dest, bool split_if_n
   else
     s->getPath()->setMovesExhaustedAtPoint(0);
   bool moved;
+  Vector<int> src = s->getPos();
 
   if (split_if_necessary)
     {
@@ -1453,8 +1521,12 @@ bool AI_Allocation::shuffleStack(Stack *stack, Vector<int> dest, bool split_if_n
       moved = d_owner->stackSplitAndMove(s, new_stack);
       if (new_stack)
         {
+          //it's the new stack that went, and it might not have got to
+          //where it was going.
           if (moved)
             {
+              addChange(src, dest);
+              addChange(src, new_stack->getPos());
               groupStacks(s);
               setParked(s, true);
             }
@@ -1465,6 +1537,8 @@ bool AI_Allocation::shuffleStack(Stack *stack, Vector<int> dest, bool split_if_n
     }
   else
     moved = d_owner->stackMove(s);
+  if (moved)
+    addChange(src, s->getPos());
       
   groupStacks(s);
 
@@ -1480,6 +1554,7 @@ bool AI_Allocation::moveStack(Stack *stack, bool &stack_died)
   assert (s != NULL);
   d_owner->getStacklist()->setActivestack(s);
   bool moved;
+  Vector<int> src = s->getPos();
 
   //printf("going in, size of path for stack: %d\n", s->getPath()->size());
   MoveResult *moveResult = d_owner->stackMove(s, Vector<int>(-1,-1));
@@ -1495,9 +1570,13 @@ bool AI_Allocation::moveStack(Stack *stack, bool &stack_died)
     {
       debug("stack id " << stack_id << " died")
       stack_died = true;
+      // it died fighting, so things changed where it was going.
+      addChange(src, src);
     }
   else
     {
+      if (moved)
+        addChange(src, s->getPos());
       groupStacks(s);
       stack_died = false;
       debug("Player " << d_owner->getName() << " moveStack on stack id " << s->getId() <<" has moved from " <<
@@ -49,6 +49,19 @@ class AI_Allocation
         // make the player's moves - return the number of stacks which moved.
         int move(City *first_city, bool build_capacity);
 
+        //! Only consider stacks that can reach one of the given positions.
+        /**
+         * A stack that didn't move in the last pass, and that is nowhere
+         * near anything that changed since, would make the same decision
+         * again.  Pass in the changes from the last pass to skip them.
+         */
+        void setChanges(const std::list<Vector<int> > &changes)
+          {d_only_near_changes = true; d_near = changes;
+            d_cheapest_tile = getCheapestTileCost();}
+
+        //! Returns the positions stacks moved from and to during move().
+        const std::list<Vector<int> > &getChanges() const {return d_changes;}
+
         //! remove the stack from our consideration.
         static void deleteStack(Stack* s);
         static void deleteStack(guint32 id);
@@ -146,6 +159,18 @@ class AI_Allocation
 
         int visitRuins();
 
+        //! Whether or not the turn is over, or the time to think is up.
+        bool stopThinking() const;
+
+        //! Whether or not the stack can reach something that changed.
+        bool isNearChange(Stack *stack) const;
+
+        //! Note that a stack moved from src to dest.
+        void addChange(Vector<int> src, Vector<int> dest);
+
+        //! The fewest movement points that moving onto a tile can cost.
+        static guint32 getCheapestTileCost();
+
         static AI_Allocation* s_instance;
         
         Player *d_owner;
@@ -153,6 +178,10 @@ class AI_Allocation
         StackReflist *d_stacks;
         const Threatlist *d_threats;
         bool *abort_turn;
+        bool d_only_near_changes;
+        std::list<Vector<int> > d_near;
+        guint32 d_cheapest_tile;
+        std::list<Vector<int> > d_changes;
 };
 
 #endif // AI_ALLOCATION_H
@@ -214,7 +214,7 @@ void AI_Analysis::examineCities()
 {
   for (auto city: *Citylist::getInstance())
     if (!city->isFriend(d_owner) && !city->isBurnt())
-      d_threats->push_back(new Threat(city));
+      d_threats->addCity(city);
 }
 
 void AI_Analysis::examineStacks()
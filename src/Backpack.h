@@ -55,7 +55,7 @@ class Backpack: public std::list<Item*>
 	Backpack(const Backpack&);
 
 	//! Destructor.
-        ~Backpack();
+        virtual ~Backpack();
 
 	//! Save a backpack.
         /**
@@ -86,7 +86,7 @@ class Backpack: public std::list<Item*>
 	 *
 	 * @return True if the Item was found and removed.
 	 */
-	bool removeFromBackpack(Item* item);
+	virtual bool removeFromBackpack(Item* item);
 
 	//! Remove all items from the backpack.
 	void removeAllFromBackpack();
@@ -95,7 +95,7 @@ class Backpack: public std::list<Item*>
 	void add(Backpack *backpack);
 
 	//! Add an Item to the bottom of the hero's backpack. 
-	bool addToBackpack(Item* item);
+	virtual bool addToBackpack(Item* item);
 
         //! Add an Item to the backpack of the Hero.
 	/**
@@ -109,7 +109,7 @@ class Backpack: public std::list<Item*>
 	 *
 	 * @return Always returns true.
 	 */
-	bool addToBackpack(Item* item, int position);
+	virtual bool addToBackpack(Item* item, int position);
 
         //! Use an item in the backpack.  removes it if it's spent.
         bool useItem(Item *item);
@@ -272,6 +272,8 @@ bool CreateScenario::create(const GameParameters &g)
   GameScenario::s_military_advisor= g.military_advisor;
   GameScenario::s_random_turns = g.random_turns;
   GameScenario::s_intense_combat = g.intense_combat;
+  GameScenario::s_easy_ai_think_time = g.easy_ai_think_time;
+  GameScenario::s_hard_ai_think_time = g.hard_ai_think_time;
 
   if (!createMap())
     return false;
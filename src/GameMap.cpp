@@ -21,6 +21,7 @@
 //  02110-1301, USA.
 
 #include <sstream>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <iomanip>
@@ -53,6 +54,7 @@
 #include "shieldsetlist.h"
 #include "citysetlist.h"
 #include "MapBackpack.h"
+#include "Item.h"
 #include "stacktile.h"
 #include "armyprodbase.h"
 #include "stack.h"
@@ -109,6 +111,7 @@ void GameMap::deleteInstance()
 
 GameMap::GameMap(Glib::ustring TilesetName, Glib::ustring ShieldsetName,
 		 Glib::ustring CitysetName)
+ : d_changed_terrain(0, 0, 0, 0)
 {
   s_tileset = 0;
   s_cityset = 0;
@@ -122,9 +125,7 @@ GameMap::GameMap(Glib::ustring TilesetName, Glib::ustring ShieldsetName,
 
   Vector<int>::setMaximumWidth(s_width);
   d_map = new Maptile[s_width*s_height];
-  for (int j = 0; j < s_height; j++)
-    for (int i = 0; i < s_width; i++)
-      d_map[j*s_width + i].setPos(Vector<int>(i, j));
+  d_blocked.resize(s_width*s_height, 0);
 }
 
 bool GameMap::offmap(int x, int y)
@@ -178,6 +179,7 @@ int GameMap::determineCharsPerStyle(Glib::ustring styles)
 }
 
 GameMap::GameMap(XML_Helper* helper)
+ : d_changed_terrain(0, 0, 0, 0)
 {
     s_tileset = 0;
     s_cityset = 0;
@@ -209,13 +211,13 @@ GameMap::GameMap(XML_Helper* helper)
     Vector<int>::setMaximumWidth(s_width);
     //create the map
     d_map = new Maptile[s_width*s_height];
+    d_blocked.resize(s_width*s_height, 0);
 
     int row = 0, col = 0;
     for (const char *letter = types.c_str(); *letter; letter++)
       {
         if (*letter == '\n' || *letter == '\r')
           continue;
-        d_map[row*s_width + col].setPos(Vector<int>(col, row));
         guint32 type = *letter - '0';
         d_map[row*s_width + col].setIndex(GameMap::getTileset()->lookupIndexByType (type == 0 ? Tile::Type (type) : Tile::Type (pow(2,type-1))));
         col++;
@@ -236,6 +238,10 @@ GameMap::GameMap(XML_Helper* helper)
 GameMap::~GameMap()
 {
     delete[] d_map;
+    for (auto i: d_backpacks)
+      delete i.second;
+    for (auto i: d_stacktiles)
+      delete i.second;
 }
 
 bool GameMap::fill(MapGenerator* generator)
@@ -328,10 +334,8 @@ bool GameMap::save(XML_Helper* helper) const
     retval &= helper->saveData("styles", styles.str());
 
     // last, save all items lying around somewhere
-    for (int i = 0; i < s_width; i++)
-      for (int j = 0; j < s_height; j++)
-	if (!getTile(i,j)->getBackpack()->empty())
-	  retval &= getTile(i,j)->getBackpack()->save(helper);
+    for (auto i: d_items)
+      retval &= (*d_backpacks.find(i)).second->save(helper);
      
     retval &= helper->closeTag();
     return retval;
@@ -342,8 +346,7 @@ bool GameMap::loadItems(Glib::ustring tag, XML_Helper* helper)
     if (tag == MapBackpack::d_tag)
       {
         MapBackpack* backpack = new MapBackpack(helper);
-        Vector<int> pos = backpack->getPos();
-        getTile(pos)->setBackpack(backpack);
+        setBackpack(backpack->getPos(), backpack);
       }
 
     return true;
@@ -554,7 +557,7 @@ void GameMap::calculateBlockedAvenue(int i, int j)
 {
   int diffx = 0, diffy = 0;
   int destx = 0, desty = 0;
-  Maptile *maptile = getTile(i, j);
+  guint8 blocked = 0;
   for (int k = 0; k < 8; k++)
     {
       switch (k)
@@ -570,13 +573,10 @@ void GameMap::calculateBlockedAvenue(int i, int j)
 	}
       destx = i + diffx;
       desty = j + diffy;
-      if (offmap (destx, desty))
-	{
-	  maptile->d_blocked[k] = true;
-	  continue;
-	}
-      maptile->d_blocked[k] = isBlockedAvenue(i, j, destx, desty);
+      if (offmap (destx, desty) || isBlockedAvenue(i, j, destx, desty))
+        blocked |= 1 << k;
     }
+  d_blocked[j*s_width + i] = blocked;
 }
 void GameMap::calculateBlockedAvenues()
 {
@@ -587,23 +587,14 @@ void GameMap::calculateBlockedAvenues()
 
 Vector<int> GameMap::findPlantedStandard(Player *p)
 {
-    bool found = false;
     Vector<int> pos;
     pos.x = -1;
     pos.y = -1;
-    for (int x = 0; x < getWidth(); x++)
+    auto it = d_standards.find(p->getId());
+    if (it != d_standards.end())
       {
-        for (int y = 0; y < getHeight(); y++)
-          {
-	    MapBackpack *backpack = getTile(x, y)->getBackpack();
-	    found = backpack->getPlantedItem(p) != NULL;
-	    if (found)
-	      {
-		pos.x = x;
-		pos.y = y;
-		break;
-	      }
-          }
+        pos.x = (*it).second % s_width;
+        pos.y = (*it).second / s_width;
       }
   return pos;
 }
@@ -611,15 +602,8 @@ Vector<int> GameMap::findPlantedStandard(Player *p)
 std::list<MapBackpack*> GameMap::getBackpacks() const
 {
   std::list<MapBackpack*> bags;
-  for (int x = 0; x < getWidth(); x++)
-    {
-      for (int y = 0; y < getHeight(); y++)
-        {
-          MapBackpack *backpack = getTile(x, y)->getBackpack();
-          if (backpack->size() > 0)
-            bags.push_back(backpack);
-        }
-    }
+  for (auto i: d_items)
+    bags.push_back((*d_backpacks.find(i)).second);
   return bags;
 }
 
@@ -891,16 +875,124 @@ void GameMap::applyTileStyles (int minx, int miny, int maxx, int maxy,
   close_circles(minx, miny, maxx, maxy);
 }
 
-std::vector<Vector<int> > GameMap::getItems()
+bool GameMap::demoteLoneTile(Vector<int> pos)
 {
-  std::vector<Vector<int> > items;
-  for (int j = 0; j < s_height; j++)
-    for (int i = 0; i < s_width; i++)
-      {
-        if (d_map[j*s_width + i].getBackpack()->empty() == false)
-          items.push_back(Vector<int>(i, j));
+  Maptile *tile = getTile(pos);
+  if (tile->getBuilding())
+    return false;
+  Tile::Type outtype;
+  switch (tile->getType())
+    {
+    case Tile::FOREST: outtype = Tile::GRASS; break;
+    case Tile::MOUNTAIN: outtype = Tile::HILLS; break;
+    case Tile::HILLS: outtype = Tile::GRASS; break;
+    case Tile::WATER: outtype = Tile::SWAMP; break;
+    default: return false;
+    }
+  if (tile_is_connected_to_other_like_tiles(tile->getType(), pos.y, pos.x))
+    return false;
+  int idx = GameMap::getTileset()->getIndex(outtype);
+  if (idx == -1)
+    return false;
+  tile->setIndex((guint32)idx);
+  return true;
+}
 
+void GameMap::markNeighbourhood(Vector<int> pos, std::unordered_set<guint32> &marked, std::vector<Vector<int> > &tiles)
+{
+  for (int k = -1; k <= +1; k++)
+    for (int l = -1; l <= +1; l++)
+      {
+        Vector<int> next = pos + Vector<int>(k, l);
+        if (offmap(next.x, next.y))
+          continue;
+        if (marked.insert(next.y*s_width + next.x).second)
+          tiles.push_back(next);
       }
+}
+
+Rectangle GameMap::applyTileStyles (std::list<Vector<int> > changed, 
+                                    bool smooth_terrain)
+{
+  Tileset *tileset = GameMap::getTileset();
+  // only the tiles around the changed ones get marked, so keep track of
+  // them by offset rather than with a flag for every tile on the map.
+  std::unordered_set<guint32> marked;
+  marked.reserve(changed.size() * 9);
+  std::vector<Vector<int> > dirty;
+  dirty.reserve(changed.size() * 9);
+
+  // every tile next to a changed tile needs a new style.  demoting a lone
+  // tile can leave its neighbours lone, so keep going until nothing else
+  // gets demoted.
+  while (!changed.empty())
+    {
+      Vector<int> pos = changed.front();
+      changed.pop_front();
+      markNeighbourhood(pos, marked, dirty);
+      if (!smooth_terrain)
+        continue;
+      for (int k = -1; k <= +1; k++)
+        for (int l = -1; l <= +1; l++)
+          {
+            Vector<int> next = pos + Vector<int>(k, l);
+            if (!offmap(next.x, next.y) && demoteLoneTile(next))
+              changed.push_back(next);
+          }
+    }
+
+  // then surround the mountains we came across with hills, like
+  // surroundMountains does.
+  if (smooth_terrain)
+    {
+      int hills = tileset->getIndex(Tile::HILLS);
+      for (size_t i = 0; i < dirty.size() && hills != -1; i++)
+        {
+          Vector<int> pos = dirty[i];
+          if (getTile(pos)->getType() != Tile::MOUNTAIN)
+            continue;
+          for (int k = -1; k <= +1; k++)
+            for (int l = -1; l <= +1; l++)
+              {
+                Vector<int> next = pos + Vector<int>(k, l);
+                if (offmap(next.x, next.y))
+                  continue;
+                Tile::Type type = getTile(next)->getType();
+                if (type == Tile::MOUNTAIN)
+                  continue;
+                // water has priority, so the mountain gives way instead.
+                Vector<int> lowered = type == Tile::WATER ? pos : next;
+                if (getTile(lowered)->getType() == Tile::HILLS)
+                  continue;
+                getTile(lowered)->setIndex((guint32)hills);
+                markNeighbourhood(lowered, marked, dirty);
+              }
+        }
+    }
+
+  if (dirty.empty())
+    return Rectangle(0, 0, 0, 0);
+
+  Vector<int> top_left = dirty.front(), bottom_right = dirty.front();
+  for (auto pos: dirty)
+    {
+      applyTileStyle(pos.y, pos.x);
+      calculateBlockedAvenue(pos.x, pos.y);
+      top_left.x = std::min(top_left.x, pos.x);
+      top_left.y = std::min(top_left.y, pos.y);
+      bottom_right.x = std::max(bottom_right.x, pos.x);
+      bottom_right.y = std::max(bottom_right.y, pos.y);
+    }
+  for (auto pos: dirty)
+    close_circles(pos.y - 1, pos.x - 1, pos.y + 1, pos.x + 1);
+  return Rectangle(top_left, bottom_right - top_left + Vector<int>(1, 1));
+}
+
+std::vector<Vector<int> > GameMap::getItems()
+{
+  std::vector<Vector<int> > items;
+  for (auto i: d_items)
+    items.push_back(Vector<int>(i % s_width, i / s_width));
   return items;
 }
 
@@ -1075,19 +1167,28 @@ Signpost* GameMap::getSignpost(Vector<int> pos)
 
 Stack* GameMap::getFriendlyStack(Vector<int> pos)
 {
-  return getStacks(pos)->getFriendlyStack(Playerlist::getActiveplayer());
+  StackTile *stile = getInstance()->findStacks(pos);
+  if (!stile)
+    return NULL;
+  return stile->getFriendlyStack(Playerlist::getActiveplayer());
 }
 
 std::vector<Stack*> GameMap::getFriendlyStacks(Vector<int> pos, Player *player)
 {
+  StackTile *stile = getInstance()->findStacks(pos);
+  if (!stile)
+    return std::vector<Stack*>();
   if (player == NULL)
     player = Playerlist::getActiveplayer();
-  return getStacks(pos)->getFriendlyStacks(player);
+  return stile->getFriendlyStacks(player);
 }
 	
 Stack* GameMap::getEnemyStack(Vector<int> pos)
 {
-  return getStacks(pos)->getEnemyStack(Playerlist::getActiveplayer());
+  StackTile *stile = getInstance()->findStacks(pos);
+  if (!stile)
+    return NULL;
+  return stile->getEnemyStack(Playerlist::getActiveplayer());
 }
 	
 std::vector<Stack*> GameMap::getEnemyStacks(std::list<Vector<int> > positions)
@@ -1105,7 +1206,8 @@ std::vector<Stack*> GameMap::getEnemyStacks(std::list<Vector<int> > positions)
 
 std::vector<Stack*> GameMap::getEnemyStacks(Vector<int> pos, Player *player)
 {
-  if (!getStacks(pos))
+  StackTile *stile = getInstance()->findStacks(pos);
+  if (!stile)
     {
       std::vector<Stack*> empty;
       return empty;
@@ -1113,7 +1215,7 @@ std::vector<Stack*> GameMap::getEnemyStacks(Vector<int> pos, Player *player)
 
   if (player == NULL)
     player = Playerlist::getActiveplayer();
-  return getStacks(pos)->getEnemyStacks(player);
+  return stile->getEnemyStacks(player);
 }
 
 
@@ -1136,7 +1238,9 @@ bool GameMap::compareStackStrength(Stack *lhs, Stack *rhs)
 
 Stack* GameMap::getStrongestStack(Vector<int> pos)
 {
-  StackTile *s = getStacks(pos);
+  StackTile *s = getInstance()->findStacks(pos);
+  if (!s)
+    return NULL;
   std::vector<Stack*> stacks = s->getStacks();
   if (stacks.empty())
     return NULL;
@@ -1146,18 +1250,44 @@ Stack* GameMap::getStrongestStack(Vector<int> pos)
 
 Stack* GameMap::getStack(Vector<int> pos)
 {
-  if (getStacks(pos))
-    return getStacks(pos)->getStack();
+  StackTile *stile = getInstance()->findStacks(pos);
+  if (stile)
+    return stile->getStack();
   else
     return NULL;
 }
 	
 StackTile* GameMap::getStacks(Vector<int> pos)
 {
-  if (getInstance()->getTile(pos))
-    return getInstance()->getTile(pos)->getStacks();
-  else
+  if (offmap(pos.x, pos.y))
     return NULL;
+  std::map<guint32, StackTile*> &tiles = getInstance()->d_stacktiles;
+  StackTile *&stile = tiles[pos.y*s_width + pos.x];
+  if (!stile)
+    stile = new StackTile(pos);
+  return stile;
+}
+
+StackTile* GameMap::findStacks(Vector<int> pos) const
+{
+  if (offmap(pos.x, pos.y))
+    return NULL;
+  auto it = d_stacktiles.find(pos.y*s_width + pos.x);
+  if (it == d_stacktiles.end())
+    return NULL;
+  return (*it).second;
+}
+
+void GameMap::releaseStacks(Vector<int> pos)
+{
+  if (offmap(pos.x, pos.y))
+    return;
+  std::map<guint32, StackTile*> &tiles = getInstance()->d_stacktiles;
+  auto it = tiles.find(pos.y*s_width + pos.x);
+  if (it == tiles.end() || (*it).second->empty() == false)
+    return;
+  delete (*it).second;
+  tiles.erase(it);
 }
 
 Stack *GameMap::groupStacks(Vector<int> pos)
@@ -1167,29 +1297,25 @@ Stack *GameMap::groupStacks(Vector<int> pos)
 
 Stack *GameMap::groupStacks(Vector<int> pos, Player *player)
 {
-  if (getStacks(pos))
-    return getStacks(pos)->group(player);
+  StackTile *stile = findStacks(pos);
+  if (stile)
+    return stile->group(player);
   else
     return NULL;
 }
   
 void GameMap::groupStacks(Stack *stack)
 {
-  if (getStacks(stack->getPos()))
-    return getStacks(stack->getPos())->group(Playerlist::getActiveplayer(), stack);
+  StackTile *stile = findStacks(stack->getPos());
+  if (stile)
+    return stile->group(Playerlist::getActiveplayer(), stack);
 }
   
 void GameMap::clearStackPositions()
 {
-  for (auto i :*Playerlist::getInstance())
-    {
-      Stacklist *sl = i->getStacklist();
-      for (Stacklist::iterator s = sl->begin(); s != sl->end(); s++)
-        {
-          StackTile *st = getStacks((*s)->getPos());
-          st->clear();
-        }
-    }
+  for (auto i: d_stacktiles)
+    delete i.second;
+  d_stacktiles.clear();
 }
 void GameMap::updateStackPositions()
 {
@@ -1203,7 +1329,10 @@ void GameMap::updateStackPositions()
 
 bool GameMap::canJoin(const Stack *src, Vector<int> dest)
 {
-  return getStacks(dest)->canAdd(src);
+  StackTile *stile = getInstance()->findStacks(dest);
+  if (!stile)
+    return getInstance()->canPutStack(src->size(), src->getOwner(), dest);
+  return stile->canAdd(src);
 }
 bool GameMap::canJoin(const Stack *src, Stack *dest)
 {
@@ -1376,6 +1505,7 @@ void GameMap::switchArmysets(Armyset *armyset)
           if (s->size() == 0)
             {
               GameMap::getInstance()->getStacks(s->getPos())->leaving(s);
+              GameMap::releaseStacks(s->getPos());
               j=sl->flErase(j);//this doesn't remove the stack from the map of id->stack pointer in stacklist. XXX XXX XXX
               if (sl->size() > 0)
                 j--;
@@ -1603,9 +1733,11 @@ guint32 GameMap::getBuildingSize(Vector<int> tile)
 	
 bool GameMap::canPutStack(guint32 size, Player *p, Vector<int> to)
 {
-  StackTile *stile = GameMap::getInstance()->getStacks(to);
+  StackTile *stile = findStacks(to);
   if (!stile)
-    return true;
+    //nobody is there yet.
+    return offmap(to.x, to.y) ||
+      (size > 0 && size <= MAX_ARMIES_ON_A_SINGLE_TILE);
   if (stile->canAdd(size, p) == true)
     return true;
   return false;
@@ -1622,6 +1754,7 @@ bool GameMap::moveStack(Stack *stack, Vector<int> to)
 
 
   getStacks(stack->getPos())->leaving(stack);
+  releaseStacks(stack->getPos());
   stack->setPos(to);
   City *c = GameMap::getCity(to);
   if (c != NULL && stack->getOwner() != c->getOwner())
@@ -1634,16 +1767,100 @@ bool GameMap::moveStack(Stack *stack, Vector<int> to)
 	
 MapBackpack *GameMap::getBackpack(Vector<int> pos)
 {
-  if (getInstance()->getTile(pos))
-    return getInstance()->getTile(pos)->getBackpack();
-  else
+  if (offmap(pos.x, pos.y))
+    return NULL;
+  std::map<guint32, MapBackpack*> &bags = getInstance()->d_backpacks;
+  MapBackpack *&bag = bags[pos.y*s_width + pos.x];
+  if (!bag)
+    bag = new MapBackpack(pos);
+  return bag;
+}
+
+MapBackpack *GameMap::findBackpack(Vector<int> pos) const
+{
+  if (offmap(pos.x, pos.y))
+    return NULL;
+  auto it = d_backpacks.find(pos.y*s_width + pos.x);
+  if (it == d_backpacks.end())
     return NULL;
+  return (*it).second;
+}
+
+void GameMap::setBackpack(Vector<int> pos, MapBackpack *bag)
+{
+  if (offmap(pos.x, pos.y))
+    {
+      delete bag;
+      return;
+    }
+  guint32 offset = pos.y*s_width + pos.x;
+  auto it = d_backpacks.find(offset);
+  if (it != d_backpacks.end())
+    {
+      delete (*it).second;
+      d_backpacks.erase(it);
+    }
+  //only the bags with something in them are kept.
+  if (bag && bag->empty())
+    {
+      delete bag;
+      bag = NULL;
+    }
+  if (bag)
+    d_backpacks[offset] = bag;
+  indexBackpack(offset, bag);
+}
+
+void GameMap::releaseBackpack(Vector<int> pos)
+{
+  if (offmap(pos.x, pos.y))
+    return;
+  std::map<guint32, MapBackpack*> &bags = getInstance()->d_backpacks;
+  auto it = bags.find(pos.y*s_width + pos.x);
+  if (it == bags.end() || (*it).second->empty() == false)
+    return;
+  delete (*it).second;
+  bags.erase(it);
+}
+
+void GameMap::updateBackpack(MapBackpack *bag)
+{
+  if (!s_instance)
+    return;
+  Vector<int> pos = bag->getPos();
+  if (s_instance->findBackpack(pos) != bag)
+    return;
+  s_instance->indexBackpack(pos.y*s_width + pos.x, bag);
+}
+
+void GameMap::indexBackpack(guint32 offset, MapBackpack *bag)
+{
+  for (auto it = d_standards.begin(); it != d_standards.end();)
+    {
+      if ((*it).second == offset)
+        it = d_standards.erase(it);
+      else
+        it++;
+    }
+  if (!bag || bag->empty())
+    {
+      d_items.erase(offset);
+      return;
+    }
+  d_items.insert(offset);
+  for (auto i: *bag)
+    if (i->getPlanted() && i->getPlantableOwner())
+      d_standards[i->getPlantableOwner()->getId()] = offset;
 }
 		    
 void GameMap::moveBackpack(Vector<int> from, Vector<int> to)
 {
-  getBackpack(to)->add(getBackpack(from));
-  getBackpack(from)->clear();
+  MapBackpack *bag = findBackpack(from);
+  if (!bag || bag->empty())
+    return;
+  getBackpack(to)->add(bag);
+  bag->removeAllFromBackpack();
+  releaseBackpack(from);
 }
 
 bool GameMap::removeRuin(Vector<int> pos)
@@ -1830,7 +2047,7 @@ bool GameMap::putBridge(Bridge *b)
 
 Rectangle GameMap::putTerrain(Rectangle r, Tile::Type type, int tile_style_id, bool always_alter_tilestyles)
 {
-  bool replaced = false;
+  std::list<Vector<int> > changed;
   Tileset *tileset = GameMap::getTileset();
   int index = tileset->getIndex(type);
   if (index == -1)
@@ -1854,31 +2071,39 @@ Rectangle GameMap::putTerrain(Rectangle r, Tile::Type type, int tile_style_id, b
             else
               t->setIndex(index);
             updateShips(Vector<int>(x,y));
-            replaced = true;
+            changed.push_back(Vector<int>(x, y));
           }
       }
-  if (replaced)
-    {
-      for (int x = r.x - 2; x < r.x + r.w + 2; ++x)
-        for (int y = r.y - 2; y < r.y + r.h + 2; ++y)
-          {
-            if (offmap(x,y))
-              continue;
-            calculateBlockedAvenue(x, y);
-          }
-    }
   if (tile_style_id == -1)
     {
-      if (replaced || always_alter_tilestyles)
+      if (always_alter_tilestyles)
+        {
+          changed.clear();
+          for (int x = r.x; x < r.x + r.w; ++x)
+            for (int y = r.y; y < r.y + r.h; ++y)
+              if (!offmap(x,y))
+                changed.push_back(Vector<int>(x, y));
+        }
+      if (!changed.empty())
         {
-          guint32 border = 1;
-          r.pos -= Vector<int>(border, border);
-          r.dim += Vector<int>(border * 2, border * 2);
-          applyTileStyles(r, true);
+          // only the tiles around the ones we changed get restyled, but
+          // smoothing can spread beyond that.
+          Rectangle restyled = applyTileStyles(changed, true);
+          Vector<int> bottom_right = 
+            Vector<int>(std::max(r.x + r.w, restyled.x + restyled.w),
+                        std::max(r.y + r.h, restyled.y + restyled.h));
+          r.pos = Vector<int>(std::min(r.x, restyled.x), 
+                              std::min(r.y, restyled.y));
+          r.dim = bottom_right - r.pos;
         }
     }
   else
     {
+      for (auto pos: changed)
+        for (int x = pos.x - 1; x <= pos.x + 1; ++x)
+          for (int y = pos.y - 1; y <= pos.y + 1; ++y)
+            if (!offmap(x,y))
+              calculateBlockedAvenue(x, y);
       for (int x = r.x; x < r.x + r.w; ++x)
         for (int y = r.y; y < r.y + r.h; ++y)
           {
@@ -1889,9 +2114,27 @@ Rectangle GameMap::putTerrain(Rectangle r, Tile::Type type, int tile_style_id, b
           }
     }
 
+  if (d_changed_terrain.w <= 0 || d_changed_terrain.h <= 0)
+    d_changed_terrain = r;
+  else if (r.w > 0 && r.h > 0)
+    {
+      Vector<int> top_left(std::min(r.x, d_changed_terrain.x),
+                           std::min(r.y, d_changed_terrain.y));
+      Vector<int> bottom_right
+        (std::max(r.x + r.w, d_changed_terrain.x + d_changed_terrain.w),
+         std::max(r.y + r.h, d_changed_terrain.y + d_changed_terrain.h));
+      d_changed_terrain = Rectangle(top_left, bottom_right - top_left);
+    }
   return r;
 }
 
+Rectangle GameMap::takeChangedTerrain()
+{
+  Rectangle changed = d_changed_terrain;
+  d_changed_terrain = Rectangle(0, 0, 0, 0);
+  return changed;
+}
+
 void GameMap::clearBuilding(Vector<int> pos, guint32 width)
 {
   for (unsigned int x = pos.x; x < pos.x + width; ++x)
@@ -2019,7 +2262,10 @@ bool GameMap::putCity(City *c, bool keep_owner)
 //the ground changed, and now we need all stacks on a tile to react.
 void GameMap::updateShips(Vector<int> pos)
 {
-  std::vector<Stack*> stks = getStacks(pos)->getStacks();
+  StackTile *stile = findStacks(pos);
+  if (!stile)
+    return;
+  std::vector<Stack*> stks = stile->getStacks();
   for (std::vector<Stack *>::iterator it = stks.begin(); it != stks.end(); it++)
     {
       for (Stack::iterator sit = (*it)->begin(); sit != (*it)->end(); sit++)
@@ -2064,14 +2310,17 @@ bool GameMap::putStack(Stack *s)
 
 void GameMap::removeStack(Stack *s)
 {
-  getStacks(s->getPos())->leaving(s);
+  Vector<int> pos = s->getPos();
+  getStacks(pos)->leaving(s);
   s->getOwner()->deleteStack(s);
+  releaseStacks(pos);
 }
 	
 guint32 GameMap::countArmyUnits(Vector<int> pos)
 {
-  if (getStacks(pos))
-    return getStacks(pos)->countNumberOfArmies(Playerlist::getActiveplayer());
+  StackTile *stile = getInstance()->findStacks(pos);
+  if (stile)
+    return stile->countNumberOfArmies(Playerlist::getActiveplayer());
   return 0;
 }
 
@@ -2321,9 +2570,10 @@ bool GameMap::eraseTile(Vector<int> tile)
   erased |= removeCity(tile);
 
   // ... or a bag
-  if (getTile(tile)->getBackpack()->size() > 0)
+  MapBackpack *bag = findBackpack(tile);
+  if (bag && bag->size() > 0)
     {
-      getTile(tile)->getBackpack()->removeAllFromBackpack();
+      bag->removeAllFromBackpack();
       erased = true;
     }
   return erased;
@@ -2427,11 +2677,10 @@ bool GameMap::can_plant_flag(Stack *stack)
                   Signpost *sign = getSignpost(stack);
                   if (!city && !temple && !ruin && !sign)
                     {
-                      MapBackpack *backpack;
-                      Vector<int> pos = stack->getPos();
-                      backpack = getInstance()->getTile(pos)->getBackpack();
+                      MapBackpack *backpack =
+                        getInstance()->findBackpack(stack->getPos());
                       bool standard_already_planted =
-                        backpack->getFirstPlantedItem() != NULL;
+                        backpack && backpack->getFirstPlantedItem() != NULL;
                       //are there any other standards here?
                       if (standard_already_planted == false)
                         return true;
@@ -2458,8 +2707,12 @@ bool GameMap::burnBridge(Vector<int> pos)
         {
           dest = other->getPos();
           GameMap::getInstance()->removeBridge(dest);
-          std::vector<Stack*> s = GameMap::getStacks(src)->getStacks();
-          stacks.insert(std::end(stacks), std::begin(s), std::end(s));
+          StackTile *stile = GameMap::getInstance()->findStacks(src);
+          if (stile)
+            {
+              std::vector<Stack*> s = stile->getStacks();
+              stacks.insert(std::end(stacks), std::begin(s), std::end(s));
+            }
         }
       std::vector<Stack*> s =
         GameMap::getFriendlyStacks(src, Playerlist::getActiveplayer());
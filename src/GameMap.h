@@ -26,6 +26,10 @@
 #include <sigc++/trackable.h>
 
 #include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_set>
 
 #include <gtkmm.h>
 #include "vector.h"
@@ -51,6 +55,7 @@ class Signpost;
 class LocationBox;
 class Tileset;
 class Army;
+class StackTile;
 
 //! The model of the map and an interface to interacting with everything on it.
 /** Class representing the map in the game
@@ -323,8 +328,9 @@ class GameMap: public sigc::trackable
          *
          * @param pos The position on the map to return the Stacktile for.
          *
-         * \note Every tile has a Stacktile object on it, even if it does not
-         * contain any stacks.
+         * \note The Stacktile object is made the first time it is asked
+         * for, so this always returns one for a position on the map.  Use
+         * findStacks to look without making one.
          * \note This method is one way to return all of the stacks on a tile.
          *
          * @return A pointer to the Stacktile object, or NULL if the position 
@@ -332,6 +338,17 @@ class GameMap: public sigc::trackable
          */
 	static StackTile* getStacks(Vector<int> pos);
 
+        //! Returns the Stacktile at the given position, without making one.
+        StackTile* findStacks(Vector<int> pos) const;
+
+        //! Delete the Stacktile at the given position if nothing's on it.
+        /**
+         * Call this after a stack leaves a tile, so that only the tiles
+         * with stacks on them are kept.  Pointers to the Stacktile are no
+         * good afterwards.
+         */
+        static void releaseStacks(Vector<int> pos);
+
         /** Merge all the stacks at the given position on the map into a single Stack.
          *
          * @param pos The position on the map to merge Stack objects on.
@@ -536,14 +553,39 @@ class GameMap: public sigc::trackable
          *
          * @param pos The position on the map to get the Backpack object for.
          *
-         * \note There is a Backpack object on every tile.  However it is 
-         * usually empty of Item objects.
+         * \note The Backpack object is made the first time it is asked
+         * for, so this is for putting items down.  Use findBackpack to look
+         * without making one.
          *
          * @return Returns NULL if pos is out of range.  Otherwise a pointer 
          * to a MapBackpack object is returned.
          */
 	static MapBackpack *getBackpack(Vector<int> pos);
 
+        //! Returns the Backpack at the given position, without making one.
+        MapBackpack *findBackpack(Vector<int> pos) const;
+
+        //! Put a new Backpack at the given position, deleting the old one.
+        /**
+         * An empty or NULL bag just takes the old one away.
+         */
+        void setBackpack(Vector<int> pos, MapBackpack *bag);
+
+        //! Delete the Backpack at the given position if it's empty.
+        /**
+         * Call this after taking items out of a bag on the map, so that
+         * only the bags with items in them are kept.  Pointers to the
+         * Backpack are no good afterwards.
+         */
+        static void releaseBackpack(Vector<int> pos);
+
+        //! Bring the index of bags and planted standards up to date.
+        /**
+         * MapBackpack calls this whenever an Item goes into it or comes out
+         * of it.  Bags that aren't on the map are left out of the index.
+         */
+        static void updateBackpack(MapBackpack *bag);
+
         /** Check if the given Stack is able to search the Maptile it is on.
          *
          * @param stack A pointer to the stack to check if it can search.
@@ -734,6 +776,28 @@ class GameMap: public sigc::trackable
          */
 	void calculateBlockedAvenue(int i, int j);
 
+        /** Whether or not a non-flying Stack is blocked from stepping from 
+         * pos onto the adjacent tile next.
+         *
+         * This reads the bit per direction that calculateBlockedAvenue 
+         * keeps for every tile, so path finding doesn't have to visit the 
+         * Maptile objects.
+         */
+        inline bool isBlockedDir(Vector<int> pos, Vector<int> next) const
+          {
+            static const guint8 bits[3][3] =
+              {
+                  { 1 << 0, 1 << 1, 1 << 2 },
+                  { 1 << 4,      0, 1 << 3 },
+                  { 1 << 5, 1 << 6, 1 << 7 },
+              };
+            int diffx = next.x - pos.x;
+            int diffy = next.y - pos.y;
+            if (diffx < -1 || diffx > 1 || diffy < -1 || diffy > 1)
+              return false;
+            return d_blocked[pos.y*s_width + pos.x] & bits[diffx+1][diffy+1];
+          }
+
         /** Load the Stack objects from Stacklist objects into StackTile objects.
          * Loop over all players and all of their stacks, adding the stacks to
          * the state of the StackTile objects associated with every square of
@@ -741,7 +805,8 @@ class GameMap: public sigc::trackable
          */
 	void updateStackPositions();
 
-        /** Forget the state of all of the StackTile objects.
+        /** Forget all of the StackTile objects, until
+         * updateStackPositions makes them again.
          */
         void clearStackPositions();
 
@@ -777,6 +842,22 @@ class GameMap: public sigc::trackable
 	void applyTileStyles (int minx, int miny, int maxx, int maxy,
 			      bool smooth_terrain);
 
+	/** Smooth the terrain around tiles whose terrain type has changed.
+	 *
+         * @param changed The positions of the tiles that were changed.
+         * @param smooth_terrain Whether or not we want to demote lone tiles 
+         * to be similar to the terrain of nearby tiles.
+         *
+         * Only the tiles next to a changed tile get a new TileStyle and have
+         * their blocked avenues recalculated.  When a lone tile is demoted
+         * it counts as changed too, so smoothing carries on until no more
+         * tiles are demoted.
+         *
+         * @return Returns the region that was restyled.
+	 */
+	Rectangle applyTileStyles (std::list<Vector<int> > changed, 
+                                   bool smooth_terrain);
+
 	/** Change how the terrain looks at given position on the big map.
 	 *
          * @param i The horizontal index of the map.
@@ -980,9 +1061,6 @@ class GameMap: public sigc::trackable
          * @param from The source position of a bag of stuff.
          * @param to The destination position.
          *
-         * \note Every square has a Backpack object, but only some of them
-         * contain Item objects.
-         *
          * If there are items in the Backpack located at the source position, 
          * they are removed and added to the destination position.
          */
@@ -1322,7 +1400,7 @@ class GameMap: public sigc::trackable
          * This method erases a City, Road, Ruin, Temple, Port, Bridge, 
          * Signpost, Stack or Backpack from the given position on the map.
          *
-         * \note Every tile has a MapBackpack object.  It is not removed, but
+         * \note The MapBackpack object is not removed, but
          * the Item objects held within it are.
          *
          * @return Returns True if anything was removed.  Otherwise, False.
@@ -1336,7 +1414,7 @@ class GameMap: public sigc::trackable
          * This method erases any City, Road, Ruin, Temple, Port, Bridge, 
          * Signpost, Stack or Backpack objects from the given region of the map.
          *
-         * \note Every tile has a MapBackpack object.  It is not removed, but
+         * \note The MapBackpack object is not removed, but
          * the Item objects held within it are.
          *
          * @return Returns True if anything was removed.  Otherwise, False.
@@ -1398,6 +1476,14 @@ class GameMap: public sigc::trackable
                              int tile_style_id = -1, 
                              bool always_alter_tilestyles = false);
 
+        //! Return the region that putTerrain has altered since last time.
+        /**
+         * Putting a building down changes the terrain under it, and the
+         * smoothing can spread from there, so the editor asks here to find
+         * out how far.
+         */
+        Rectangle takeChangedTerrain();
+
 
         static int calculateTilesPerOverviewMapTile(int width, int height);
         static int calculateTilesPerOverviewMapTile();
@@ -1434,6 +1520,12 @@ class GameMap: public sigc::trackable
 
 	int tile_is_connected_to_other_like_tiles (Tile::Type tile, int i, 
 						   int j);
+        //! Demote the tile at pos if it is a lone tile.  Returns true if it was.
+        bool demoteLoneTile(Vector<int> pos);
+        //! Add the unmarked tiles around pos to tiles, and mark them.
+        void markNeighbourhood(Vector<int> pos,
+                               std::unordered_set<guint32> &marked,
+                               std::vector<Vector<int> > &tiles);
 	bool are_those_tiles_similar(Tile::Type outer_tile,Tile::Type inner_tile, bool checking_loneliness);
 	Vector<int> findNearestObjectInDir(Vector<int> pos, Vector<int> dir);
 	void putBuilding(LocationBox *b, Maptile::Building building);
@@ -1452,6 +1544,8 @@ class GameMap: public sigc::trackable
 
         static bool compareStackStrength(Stack *lhs, Stack *rhs);
 
+        void indexBackpack(guint32 offset, MapBackpack *bag);
+
         // Data
         static GameMap* s_instance;
         static int s_width;
@@ -1465,6 +1559,24 @@ class GameMap: public sigc::trackable
         Glib::ustring d_cityset; //the basename, not the friendly name.
 
         Maptile* d_map;
+
+        //! The bags of items on the map, by y*s_width+x.
+        std::map<guint32, MapBackpack*> d_backpacks;
+
+        //! The stacktiles on the map, by y*s_width+x.
+        std::map<guint32, StackTile*> d_stacktiles;
+
+        //! What putTerrain has altered since the last takeChangedTerrain.
+        Rectangle d_changed_terrain;
+
+        //! Where the bags that have items in them are, by y*s_width+x.
+        std::set<guint32> d_items;
+
+        //! Where each player's standard is planted, by player id.
+        std::map<guint32, guint32> d_standards;
+
+        //! One bit per direction for each tile, set when the way is blocked.
+        std::vector<guint8> d_blocked;
 };
 
 #endif
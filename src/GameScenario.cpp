@@ -26,6 +26,7 @@
 #include <errno.h>
 #include <sigc++/functors/mem_fun.h>
 #include <string.h>
+#include <map>
 
 #include "ucompose.hpp"
 #include "GameScenario.h"
@@ -60,6 +61,7 @@
 #include "ai_fast.h"
 #include "counter.h"
 #include "army.h"
+#include "armyprodbase.h"
 #include "QuestsManager.h"
 #include "Itemlist.h"
 #include "vectoredunitlist.h"
@@ -118,6 +120,8 @@ GameScenario::GameScenario(Glib::ustring savegame, bool& broken)
       t.Close();
       if (broken)
         cleanup();
+      else
+        prefetchArmyImages();
     }
   else
     {
@@ -136,11 +140,45 @@ bool GameScenario::loadArmysets(Tar_Helper *t)
     {
       guint32 id = Armysetlist::getInstance()->import(t, *it, broken);
       if (!broken)
-        Armysetlist::getInstance()->get(id)->instantiateImages(broken);
+        Armysetlist::getInstance()->get(id)->instantiateImagesOnDemand(broken);
     }
   return !broken;
 }
 
+void GameScenario::prefetchArmyImages()
+{
+  //the pictures we're sure to need are the armies on the map and the ones
+  //the cities can make, in the colours of the players who own them.
+  std::map<guint32, std::list<std::pair<guint32, Shield::Colour> > > images;
+  for (auto p: *Playerlist::getInstance())
+    {
+      Shield::Colour c = Shield::Colour(p->getId());
+      for (auto s: *p->getStacklist())
+        for (auto a: *s)
+          images[a->getArmyset()].push_back(std::make_pair(a->getTypeId(), c));
+    }
+  for (auto city: *Citylist::getInstance())
+    {
+      Shield::Colour c = Shield::Colour(city->getOwner()->getId());
+      for (guint32 i = 0; i < city->getMaxNoOfProductionBases(); i++)
+        {
+          const ArmyProdBase *a = city->getProductionBase(i);
+          if (a)
+            images[a->getArmyset()].push_back
+              (std::make_pair(a->getTypeId(), c));
+        }
+    }
+  for (auto &i: images)
+    {
+      Armyset *armyset = Armysetlist::getInstance()->get(i.first);
+      if (!armyset)
+        continue;
+      i.second.sort();
+      i.second.unique();
+      armyset->prefetchArmyImages(i.second);
+    }
+}
+
 bool GameScenario::loadTilesets(Tar_Helper *t)
 {
   bool broken = false;
@@ -233,8 +271,10 @@ void GameScenario::quickStartEvenlyDivided()
 		{
 		  for (unsigned int y = 0; y < c->getSize(); y++)
 		    {
-		      StackTile *stile = 
-			GameMap::getStacks(c->getPos() + Vector<int>(x,y));
+		      StackTile *stile = GameMap::getInstance()->findStacks
+			(c->getPos() + Vector<int>(x,y));
+		      if (!stile)
+			continue;
 		      std::vector<Stack*> stks = stile->getStacks();
 		      for (std::vector<Stack *>::iterator k = stks.begin();
 			   k != stks.end(); k++)
@@ -281,8 +321,10 @@ void GameScenario::quickStartAIHeadStart()
 		{
 		  for (unsigned int y = 0; y < c->getSize(); y++)
 		    {
-		      StackTile *stile = 
-			GameMap::getStacks(c->getPos() + Vector<int>(x,y));
+		      StackTile *stile = GameMap::getInstance()->findStacks
+			(c->getPos() + Vector<int>(x,y));
+		      if (!stile)
+			continue;
 		      std::vector<Stack*> stks = stile->getStacks();
 		      for (std::vector<Stack *>::iterator k = stks.begin();
 			   k != stks.end(); k++)
@@ -751,6 +793,8 @@ bool GameScenario::saveWithHelper(XML_Helper &helper) const
   retval &= helper.saveData("intense_combat", s_intense_combat);
   retval &= helper.saveData("military_advisor", s_military_advisor);
   retval &= helper.saveData("random_turns", s_random_turns);
+  retval &= helper.saveData("easy_ai_think_time", s_easy_ai_think_time);
+  retval &= helper.saveData("hard_ai_think_time", s_hard_ai_think_time);
   retval &= helper.saveData("surrender_already_offered", 
 			    s_surrender_already_offered);
   Glib::ustring playmode_str = playModeToString(GameScenario::PlayMode(d_playmode));
@@ -811,6 +855,10 @@ bool GameScenario::load(Glib::ustring tag, XML_Helper* helper)
       helper->getData(s_intense_combat, "intense_combat");
       helper->getData(s_military_advisor, "military_advisor");
       helper->getData(s_random_turns, "random_turns");
+      s_easy_ai_think_time = 0;
+      helper->getData(s_easy_ai_think_time, "easy_ai_think_time");
+      s_hard_ai_think_time = 0;
+      helper->getData(s_hard_ai_think_time, "hard_ai_think_time");
       helper->getData(s_surrender_already_offered, 
 		      "surrender_already_offered");
       Glib::ustring playmode_str;
@@ -1237,6 +1285,10 @@ public:
 	    helper->getData(game_params.military_advisor, 
 			    "military_advisor");
 	    helper->getData(game_params.random_turns, "random_turns");
+	    helper->getData(game_params.easy_ai_think_time, 
+			    "easy_ai_think_time");
+	    helper->getData(game_params.hard_ai_think_time, 
+			    "hard_ai_think_time");
 	    return true;
 	  }
 	return false;
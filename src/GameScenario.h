@@ -175,6 +175,9 @@ class GameScenario: public GameScenarioOptions
 	  bool loadCitysets(Tar_Helper *t);
 	  bool loadShieldsets(Tar_Helper *t);
 
+          //! Load the army pictures that we'll need first, when we're idle.
+          void prefetchArmyImages();
+
 	  // DATA
 	  Glib::ustring d_name;
 	  Glib::ustring d_comment;
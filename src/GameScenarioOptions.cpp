@@ -41,6 +41,8 @@ unsigned int GameScenarioOptions::s_round = 0;
 GameParameters::VectoringMode GameScenarioOptions::s_vectoring_mode = GameParameters::VECTORING_ALWAYS_TWO_TURNS;
 GameParameters::BuildProductionMode GameScenarioOptions::s_build_production_mode = GameParameters::BUILD_PRODUCTION_ALWAYS;
 GameParameters::SackingMode GameScenarioOptions::s_sacking_mode = GameParameters::SACKING_ALWAYS;
+guint32 GameScenarioOptions::s_easy_ai_think_time = 0;
+guint32 GameScenarioOptions::s_hard_ai_think_time = 0;
 
 GameScenarioOptions::GameScenarioOptions()
 {
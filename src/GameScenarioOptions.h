@@ -49,6 +49,8 @@ class GameScenarioOptions: public sigc::trackable
         static GameParameters::VectoringMode s_vectoring_mode;
         static GameParameters::BuildProductionMode s_build_production_mode;
         static GameParameters::SackingMode s_sacking_mode;
+        static guint32 s_easy_ai_think_time;
+        static guint32 s_hard_ai_think_time;
 
         static unsigned int s_round;
 
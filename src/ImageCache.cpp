@@ -1512,6 +1512,9 @@ PixMask *ArmyPixMaskCacheItem::generate(ArmyPixMaskCacheItem i)
   // copy the pixmap including player colors
   Player *p = Playerlist::getInstance()->getPlayer(i.player_id);
   Shield::Colour c = Shield::Colour(i.player_id);
+  // the armysets in a game load their pictures when they're first needed.
+  Armysetlist::getInstance()->get(i.armyset)->instantiateArmyImages
+    (i.army_id, c);
   if (basearmy->getImage(c) == NULL || basearmy->getMask(c) == NULL)
     return NULL;
   PixMask *coloured = ImageCache::applyMask(basearmy->getImage(c), 
@@ -101,8 +101,7 @@ bool LocationBox::isFull(Player *p) const
     for (unsigned int j = 0; j < d_size; j++)
       {
 	Vector<int> pos = getPos() + Vector<int>(j,i);
-	StackTile *stile = GameMap::getInstance()->getTile(pos)->getStacks();
-	if (stile->canAdd(1, p) == true)
+	if (GameMap::getInstance()->canPutStack(1, p, pos) == true)
 	  return false;
       }
   return true;
@@ -116,8 +115,8 @@ Stack* LocationBox::getFreeStack(Player *p, Vector<int> &tile) const
 	Vector<int> pos = getPos() + Vector<int>(j,i);
 	if (GameMap::canAddArmy(pos) == false)
 	  continue;
-	StackTile *stile = GameMap::getInstance()->getTile(pos)->getStacks();
-	Stack *stack = stile->getFriendlyStack(p);
+	StackTile *stile = GameMap::getInstance()->findStacks(pos);
+	Stack *stack = stile ? stile->getFriendlyStack(p) : NULL;
 	if (stack == NULL)
 	  {
 	    tile = pos;
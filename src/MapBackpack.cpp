@@ -18,6 +18,7 @@
 #include "MapBackpack.h"
 #include "Item.h"
 #include "xmlhelper.h"
+#include "GameMap.h"
 
 Glib::ustring MapBackpack::d_tag = "itemstack";
 
@@ -54,6 +55,27 @@ bool MapBackpack::save(XML_Helper* helper) const
   return retval;
 }
 
+bool MapBackpack::addToBackpack(Item* item)
+{
+  bool retval = Backpack::addToBackpack(item);
+  GameMap::updateBackpack(this);
+  return retval;
+}
+
+bool MapBackpack::addToBackpack(Item* item, int position)
+{
+  bool retval = Backpack::addToBackpack(item, position);
+  GameMap::updateBackpack(this);
+  return retval;
+}
+
+bool MapBackpack::removeFromBackpack(Item* item)
+{
+  bool retval = Backpack::removeFromBackpack(item);
+  GameMap::updateBackpack(this);
+  return retval;
+}
+
 Item *MapBackpack::getFirstPlantedItem()
 {
   for (MapBackpack::iterator it = begin(); it != end(); it++)
@@ -51,6 +51,15 @@ class MapBackpack: public Backpack, public Immovable, public UniquelyIdentified
      //! Destructor.
     ~MapBackpack() {};
 
+    //! Add an Item to the bag, and let the GameMap know.
+    bool addToBackpack(Item* item);
+
+    //! Add an Item to the bag at the given position, and let the GameMap know.
+    bool addToBackpack(Item* item, int position);
+
+    //! Remove an Item from the bag, and let the GameMap know.
+    bool removeFromBackpack(Item* item);
+
     //! Save the MapBackpack object to an opened saved-game file.
     bool save(XML_Helper* helper) const;
 
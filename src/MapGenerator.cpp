@@ -24,6 +24,10 @@
 #include <iostream>
 #include <math.h>  
 #include <set>
+#include <map>
+#include <queue>
+#include <algorithm>
+#include <random>
 
 #include "MapGenerator.h"
 #include "army.h"
@@ -61,7 +65,7 @@ MapGenerator::MapGenerator()
     //set reasonable default values
     :d_terrain(0), d_building(0), d_pswamp(2), d_pwater(25), d_pforest(3),
     d_phills(5), d_pmountains(5), d_nocities(11), d_notemples(9), d_noruins(20),
-    d_nosignposts(30), cityset(NULL)
+    d_nosignposts(30), cityset(NULL), d_seed(Rnd::rand()), d_rand(d_seed)
 
 {
     d_xdir[0]=0;d_xdir[1]=-1;d_xdir[2]=-1;d_xdir[3]=-1;d_xdir[4]=0;d_xdir[5]=1;d_xdir[6]=1;d_xdir[7]=1;
@@ -170,6 +174,10 @@ void MapGenerator::makeMap(int width, int height, bool roads)
     d_width = width;
     d_height = height;
 
+    // start from the seed every time, so that the same seed and settings
+    // always give the same map.
+    d_rand.set_seed(d_seed);
+
     //initialize terrain and building arrays
     d_terrain = new Tile::Type[width*height];
     d_building = new Maptile::Building[width*height];
@@ -391,7 +399,7 @@ void MapGenerator::makeBridges()
                  when it is stupefyingly needless */
               construct_bridge_and_roads = false;
               if (original_route / 2 < shortcut)
-                if (Rnd::rand() % 2 == 0)
+                if (rnd() % 2 == 0)
                   construct_bridge_and_roads = true;
             }
 
@@ -484,15 +492,15 @@ void MapGenerator::connectWithWater(Vector<int> from, Vector<int> to)
         // we don't want to mess up whole map with straight lines
         return;
 
-    int kind(Rnd::rand()%4);
+    int kind(rnd()%4);
     delta /= length(delta)*2;
     for(Vector<float>path = Vector<float>(from)+delta*4 ; dist<float>(path,Vector<float>(to)-delta*4) > 0.5 ; path -= delta)
     {
         int j = (int)(path.x);
         int i = (int)(path.y);
 
-        if(Rnd::rand()%3 == 0) 
-            kind = Rnd::rand()%4;
+        if(rnd()%3 == 0) 
+            kind = rnd()%4;
         switch(kind)
         {
             case 0:
@@ -534,80 +542,113 @@ void MapGenerator::connectWithWater(Vector<int> from, Vector<int> to)
     }
 }
 
-void MapGenerator::findAreasOf(Tile::Type THIS_TILE,std::vector<std::vector<int> >& box,int& how_many)
+//! Returns the representative of the area containing pos.
+static int findAreaRoot(std::vector<int>& parent, int pos)
 {
-    box.resize(d_height);
-    for(int j = 0; j < d_height; j++)
-        box[j].resize(d_width,0);
+    while (parent[pos] != pos)
+    {
+        parent[pos] = parent[parent[pos]];
+        pos = parent[pos];
+    }
+    return pos;
+}
+
+static void joinAreas(std::vector<int>& parent, int a, int b)
+{
+    a = findAreaRoot(parent, a);
+    b = findAreaRoot(parent, b);
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+void MapGenerator::findAreasOf(Tile::Type THIS_TILE,std::vector<int>& box,std::vector<Area>& areas)
+{
+    const int size = d_width * d_height;
+    box.assign(size, 0);
+    areas.assign(1, Area());
+
+    // first pass: join every inner tile of THIS_TILE with its west and
+    // north neighbours.  tiles that aren't part of any area stay at -1.
+    std::vector<int> parent(size, -1);
+    for(int j = 1; j < d_height-1; j++)
+        for(int i = 1; i < d_width-1; i++)
+        {
+            int pos = j*d_width + i;
+            if (d_terrain[pos] != THIS_TILE)
+                continue;
+            parent[pos] = pos;
+            if (parent[pos-1] != -1)
+                joinAreas(parent, pos, pos-1);
+            if (parent[pos-d_width] != -1)
+                joinAreas(parent, pos, pos-d_width);
+        }
 
-    // find all enclosed areas by scanning the map
-    // distinct areas have different numbers in box
+    // second pass: an area only counts when it holds a tile that is part
+    // of a 2x2 block of THIS_TILE.  areas are numbered in the order their
+    // first such tile is found, scanning row by row.
+    std::vector<int> number(size, 0);
+    const int w = d_width;
     for(int j = 1; j < d_height-1; j++)
         for(int i = 1; i < d_width-1; i++)
-            if (box[j][i]==0 &&
-                    d_terrain[j*d_width + i] == THIS_TILE &&
-                    (
-                     (d_terrain[(j-1)*d_width + i-1] == THIS_TILE &&
-                      d_terrain[(j  )*d_width + i-1] == THIS_TILE &&
-                      d_terrain[(j-1)*d_width + i  ] == THIS_TILE)  ||
-
-                     (d_terrain[(j-1)*d_width + i  ] == THIS_TILE &&
-                      d_terrain[(j-1)*d_width + i+1] == THIS_TILE &&
-                      d_terrain[(j  )*d_width + i+1] == THIS_TILE) ||
-
-                     (d_terrain[(j  )*d_width + i+1] == THIS_TILE &&
-                      d_terrain[(j+1)*d_width + i+1] == THIS_TILE &&
-                      d_terrain[(j+1)*d_width + i  ] == THIS_TILE) ||
-
-                     (d_terrain[(j+1)*d_width + i  ] == THIS_TILE &&
-                      d_terrain[(j+1)*d_width + i-1] == THIS_TILE &&
-                      d_terrain[(j  )*d_width + i-1] == THIS_TILE))
-               )
+        {
+            int pos = j*w + i;
+            if (d_terrain[pos] != THIS_TILE)
+                continue;
+            int root = findAreaRoot(parent, pos);
+            if (number[root] != 0)
+                continue;
+            const Tile::Type *t = &d_terrain[pos];
+            if ((t[-w-1] == THIS_TILE && t[  -1] == THIS_TILE && t[-w  ] == THIS_TILE) ||
+                (t[-w  ] == THIS_TILE && t[-w+1] == THIS_TILE && t[  +1] == THIS_TILE) ||
+                (t[  +1] == THIS_TILE && t[+w+1] == THIS_TILE && t[+w  ] == THIS_TILE) ||
+                (t[+w  ] == THIS_TILE && t[+w-1] == THIS_TILE && t[  -1] == THIS_TILE))
             {
-                box[j][i]=++how_many+3000;
-                int counter=1;
-                while(counter != 0)
-                {
-                    counter=0;
-                    for(int J = 1; J < d_height-1; J++)
-                        for(int I = 1; I < d_width-1; I++)
-                        {
-                            if(d_terrain[J*d_width + I] == THIS_TILE &&
-                                    box[J][I]    ==0 &&
-                                    (box[J-1][I  ]==how_many+3000 ||
-                                     box[J  ][I-1]==how_many+3000 ||
-                                     box[J  ][I+1]==how_many+3000 ||
-                                     box[J+1][I  ]==how_many+3000))
-                            {
-                                ++counter;
-                                box[J][I]=how_many+2000;
-                            }
-                        }
-                    for(int J = 0; J < d_height; J++)
-                        for(int I = 0; I < d_width; I++)
-                        {
-                            if (box[J][I]==how_many+3000)
-                                box[J][I]=how_many;
-                            if (box[J][I]==how_many+2000)
-                                box[J][I]=how_many+3000;
-                        }
-                }
+                number[root] = areas.size();
+                areas.push_back(Area());
+            }
+        }
+
+    // third pass: hand out the numbers, and measure each area.
+    for(int j = 1; j < d_height-1; j++)
+        for(int i = 1; i < d_width-1; i++)
+        {
+            int pos = j*w + i;
+            if (parent[pos] == -1)
+                continue;
+            int h = number[findAreaRoot(parent, pos)];
+            if (h == 0)
+                continue;
+            box[pos] = h;
+            Area &area = areas[h];
+            if (area.size == 0)
+            {
+                area.minx = area.maxx = i;
+                area.miny = area.maxy = j;
+            }
+            else
+            {
+                area.minx = std::min(area.minx, i);
+                area.maxx = std::max(area.maxx, i);
+                area.maxy = j;
             }
+            area.size++;
+        }
 }
 
 void MapGenerator::verifyIslands()
 {
-    int how_many=0;
-    std::vector<std::vector<int> > box;
-    findAreasOf(Tile::GRASS,box,how_many);
+    std::vector<int> box;
+    std::vector<Area> areas;
+    findAreasOf(Tile::GRASS,box,areas);
+    int how_many = areas.size() - 1;
 
-    // count the size of each area
+    // the size of each area
     std::vector<float> counts;
     counts.resize(how_many+2,0);
-    for(int j = 0; j < d_height; j++)
-        for(int i = 0; i < d_width; i++)
-            if(box[j][i] != 0)
-                counts[box[j][i]] += 1;
+    for(int h = 1; h <= how_many; h++)
+        counts[h] = areas[h].size;
 
     // find four largest land areas
     std::set<int> largest;largest.clear();
@@ -626,16 +667,22 @@ void MapGenerator::verifyIslands()
     // largest are good. Also one/third of all others is good:
     std::set<int> good(largest);
     for(size_t i=0 ; i<counts.size() ; ++i)
-        if(Rnd::rand()%3 == 0) // that's one/third here
+        if(rnd()%3 == 0) // that's one/third here
             good.insert(counts[i]);
 
     // now, eliminate all land that is not good
-    for(int I=0 ; I<(int)(counts.size()) ; ++I)
-        if(good.find(counts[I]) == good.end())
-            for(int j = 1; j < d_height-1; j++)
-                for(int i = 1; i < d_width-1; i++)
-                    if(box[j][i] == I)
-                        d_terrain[j*d_width + i] = Tile::WATER;
+    for(int j = 1; j < d_height-1; j++)
+        for(int i = 1; i < d_width-1; i++)
+            if(good.find(counts[box[j*d_width + i]]) == good.end())
+                d_terrain[j*d_width + i] = Tile::WATER;
+}
+
+//! Returns the first of 1, 1+step, 1+2*step... that isn't less than from.
+static int firstStep(int from, int step)
+{
+    if (from <= 1)
+        return 1;
+    return 1 + ((from - 1 + step - 1) / step) * step;
 }
 
 void MapGenerator::makeRivers()
@@ -644,7 +691,7 @@ void MapGenerator::makeRivers()
     //  1 - plenty of short rivers and islands
     //  2 - longer rivers, less islands
     //  3 - even longer rivers, even less islands
-    int river_style=Rnd::rand()%3+1;
+    int river_style=rnd()%3+1;
 
     // count how many separate bodies of water were found
     int how_many;
@@ -653,11 +700,10 @@ void MapGenerator::makeRivers()
     //while(++iter < 20)
     while(++iter < 4)
     {
-        how_many=0;
-
-        std::vector<std::vector<int> > box;
-        
-        findAreasOf(Tile::WATER,box,how_many);
+        std::vector<int> box;
+        std::vector<Area> areas;
+        findAreasOf(Tile::WATER,box,areas);
+        how_many = areas.size() - 1;
 
         // this loop allows maximum 3 distinctly separated bodies of water
         // so no need to continue the algorithm
@@ -669,15 +715,14 @@ void MapGenerator::makeRivers()
         centers.resize(how_many+2,Vector<float>(0,0));
         std::vector<float> counts;
         counts.resize(how_many+2,0);
+        for(int h = 1; h <= how_many; h++)
+            counts[h] = areas[h].size;
         if (how_many > 40) //trying to speed things up by adding this limit
           how_many = 40;
         for(int j = 0; j < d_height; j++)
             for(int i = 0; i < d_width; i++)
-                if(box[j][i] != 0)
-                {
-                    counts[box[j][i]] += 1;
-                    centers[box[j][i]] += Vector<float>(j,i);
-                }
+                if(box[j*d_width + i] != 0)
+                    centers[box[j*d_width + i]] += Vector<float>(j,i);
         // divide sum by counts to get a center
         int max_count=0,max_count_2=0;
         for(int h = 0; h < how_many+2; ++h)
@@ -690,14 +735,14 @@ void MapGenerator::makeRivers()
                 if(max_count_2 < (int)(counts[h]) && (int)(counts[h]) != max_count)
                     max_count_2 = (int)(counts[h]);
                 int J=(int)(centers[h].x), I=(int)(centers[h].y);
-                if(box[J][I] != h)
+                if(box[J*d_width + I] != h)
                 // center doesn't necessarily fall on water tile, so fix this.
                 {
                     int i_up=0,i_dn=0,j_up=0,j_dn=0;
-                    while((I+i_up <  d_width-1 ) && (box[J     ][I+i_up] != h)) ++i_up;
-                    while((I-i_dn >  0         ) && (box[J     ][I-i_dn] != h)) ++i_dn;
-                    while((J+j_up <  d_height-1) && (box[J+j_up][I     ] != h)) ++j_up;
-                    while((J-j_dn >  0         ) && (box[J-j_dn][I     ] != h)) ++j_dn;
+                    while((I+i_up <  d_width-1 ) && (box[J*d_width + I+i_up] != h)) ++i_up;
+                    while((I-i_dn >  0         ) && (box[J*d_width + I-i_dn] != h)) ++i_dn;
+                    while((J+j_up <  d_height-1) && (box[(J+j_up)*d_width + I] != h)) ++j_up;
+                    while((J-j_dn >  0         ) && (box[(J-j_dn)*d_width + I] != h)) ++j_dn;
 
                     int shortest = std::min( std::min(i_up,i_dn) , std::min(j_up,j_dn));
 
@@ -747,9 +792,10 @@ void MapGenerator::makeRivers()
                     // find tile from area h closest to the center of k 
                     float min_dist = d_height*d_height;
                     float min_h_j=0,min_h_i=0;
-                    for(int j = 1; j < d_height-1; j+=step)
-                        for(int i = 1; i < d_width-1; i+=step)
-                            if(box[j][i] == h)
+                    // only the bounding box of h can hold tiles of h
+                    for(int j = firstStep(areas[h].miny, step); j <= areas[h].maxy; j+=step)
+                        for(int i = firstStep(areas[h].minx, step); i <= areas[h].maxx; i+=step)
+                            if(box[j*d_width + i] == h)
                             {
                                 float dj = j - centers[k].x;
                                 float di = i - centers[k].y;
@@ -765,9 +811,9 @@ void MapGenerator::makeRivers()
                     // then find tile from area k closest to that tile from h
                     min_dist = d_height * d_height;
                     float min_k_j=0,min_k_i=0;
-                    for(int j = 1; j < d_height-1; j+=step)
-                        for(int i = 1; i < d_width-1; i+=step)
-                            if(box[j][i] == k)
+                    for(int j = firstStep(areas[k].miny, step); j <= areas[k].maxy; j+=step)
+                        for(int i = firstStep(areas[k].minx, step); i <= areas[k].maxx; i+=step)
+                            if(box[j*d_width + i] == k)
                             {
                                 float dj = j - min_h_j;
                                 float di = i - min_h_i;
@@ -850,8 +896,8 @@ void MapGenerator::makeTerrain(Tile::Type t, int percent, bool contin)
     while(placed != terrain)
     {
         // find a random starting position
-        int x = Rnd::rand() % d_width;
-        int y = Rnd::rand() % d_height;
+        int x = rnd() % d_width;
+        int y = rnd() % d_height;
         if (seekPlain(x, y) == false)
         {
           tries++;
@@ -874,7 +920,7 @@ void MapGenerator::makeTerrain(Tile::Type t, int percent, bool contin)
             
             // from a random direction, check all directions for further progress
             int loop = 0;
-            for (int dir = Rnd::rand()%8; loop < 8; loop++, dir = (dir+1)%8)
+            for (int dir = rnd()%8; loop < 8; loop++, dir = (dir+1)%8)
             {
                 int tmpx = x + d_xdir[dir];
                 int tmpy = y + d_ydir[dir];
@@ -937,11 +983,11 @@ void MapGenerator::makeStreamer(Tile::Type t, int percent, int thick)
     while(placed < terrain)
     {
         // find a random starting position
-        int x = Rnd::rand() % d_width;
-        int y = Rnd::rand() % d_height;
+        int x = rnd() % d_width;
+        int y = rnd() % d_height;
         if (seekPlain(x, y) == false)
           continue;
-        dir = Rnd::rand()%8; // pick a random direction
+        dir = rnd()%8; // pick a random direction
         // now go on until we hit a dead end
         while (placed < terrain)
         {
@@ -953,9 +999,9 @@ void MapGenerator::makeStreamer(Tile::Type t, int percent, int thick)
                 continue;
             }
             
-            if (Rnd::rand() % 2 == 0)
+            if (rnd() % 2 == 0)
               {
-                if (Rnd::rand() % 2 == 0)
+                if (rnd() % 2 == 0)
                   {
                     dir++;
                     if (dir > 7)
@@ -1033,7 +1079,7 @@ bool MapGenerator::seekPlain(int& x, int& y)
     
     // fill the list with initial values; the rand is there to avoid a bias
     // (i.e. prefer a certain direction)
-    for (int dir = Rnd::rand() % 8, i = 0; i < 8; i++, dir = (dir+1)%8)
+    for (int dir = rnd() % 8, i = 0; i < 8; i++, dir = (dir+1)%8)
         tiles.push_back(Vector<int>(x + d_xdir[dir], y + d_ydir[dir]));
     
     // now loop until all tiles were checked (should hardly happen)
@@ -1124,8 +1170,8 @@ void MapGenerator::makeCities(int cities)
     // place the cities
     while(city_count < cities)
     {
-        int x = Rnd::rand()%(d_width-2);
-        int y = Rnd::rand()%(d_height-2);
+        int x = rnd()%(d_width-2);
+        int y = rnd()%(d_height-2);
         if (inhospitableTerrain(x, y, cityset->getCityTileWidth()) && (iterations < 1000))
         {
             iterations++;
@@ -1204,8 +1250,8 @@ void MapGenerator::makeBuildings(Maptile::Building b, int building)
     {        
 	for (j = 0; j < iterations; j++)
 	{
-             x = Rnd::rand()%d_width;
-             y = Rnd::rand()%d_height;
+             x = rnd()%d_width;
+             y = rnd()%d_height;
         
 	     found_place = true;
 	     for (unsigned int k = 0; k < width; k++)
@@ -1292,7 +1338,7 @@ void MapGenerator::normalize()
     Tile::Type curTer=Tile::NONE, ajTer=Tile::NONE;
 
     // that was 40 before. Now with rivers, the smaller the value - the more connected rivers we got.
-    unsigned int center_tiles = Rnd::rand()%40;
+    unsigned int center_tiles = rnd()%40;
     //std::cerr << center_tiles << "\% chance of disconnecting rivers.\n";
 
     // Go through every tile bar the outer edge
@@ -1324,20 +1370,20 @@ void MapGenerator::normalize()
             {
                 if (ajacentTer[curTer]==0)
                     d_terrain[globy*d_width +globx] = Tile::GRASS;
-                else if ((ajacentTer[curTer]==1) && (Rnd::rand()%100 < 95 ))
+                else if ((ajacentTer[curTer]==1) && (rnd()%100 < 95 ))
                     d_terrain[globy*d_width +globx] = Tile::GRASS;
-                else if ((ajacentTer[curTer]==2) && (Rnd::rand()%100 < 70 ))
+                else if ((ajacentTer[curTer]==2) && (rnd()%100 < 70 ))
                     d_terrain[globy*d_width +globx] = Tile::GRASS;
-                else if ((ajacentTer[curTer]==3) && (Rnd::rand()%100 < center_tiles ))
+                else if ((ajacentTer[curTer]==3) && (rnd()%100 < center_tiles ))
                     d_terrain[globy*d_width +globx] = Tile::GRASS;
             }
             else 
             {
                 if (ajacentTer[Tile::WATER]==8)
                     d_terrain[globy*d_width +globx] = Tile::WATER;
-                else if ((ajacentTer[Tile::WATER]==7) && (Rnd::rand()%100 < 70 ))
+                else if ((ajacentTer[Tile::WATER]==7) && (rnd()%100 < 70 ))
                     d_terrain[globy*d_width +globx] = Tile::WATER;
-                else if ((ajacentTer[Tile::WATER]==6) && (Rnd::rand()%100 < 40 ))
+                else if ((ajacentTer[Tile::WATER]==6) && (rnd()%100 < 40 ))
                     d_terrain[globy*d_width +globx] = Tile::WATER;
              }
         }
@@ -1373,42 +1419,6 @@ bool MapGenerator::placePort(int x, int y)
   return false;
 }
 
-bool MapGenerator::makeRoad(Vector<int> src, Vector<int>dest)
-{
-  bool retval = true;
-
-  RoadPathCalculator rpc(src);
-  Path *p = rpc.calculate(dest);
-
-  if (p->size() > 0)
-    {
-      for (auto it: *p)
-	{
-	  if (GameMap::getInstance()->getTile(it)->getType() == Tile::WATER &&
-	      GameMap::getInstance()->getTile(it)->getBuilding() != Maptile::BRIDGE)
-	    {
-	      retval = false;
-	      break;
-	    }
-	  if (Citylist::getInstance()->getObjectAt(it) == NULL)
-	    {
-	      if (d_building[it.y*d_width + it.x] == Maptile::NONE)
-		{
-		  d_building[it.y*d_width + it.x] = Maptile::ROAD;
-                  Roadlist::getInstance()->add(new Road(Vector<int>(it)));
-		  calculateBlockedAvenue(it.x, it.y);
-		}
-	    }
-	}
-
-    }
-  else
-    retval = false;
-  delete p;
-
-  return retval;
-}
-
 bool MapGenerator::makeRoad2(Path *p)
 {
   bool retval = true;
@@ -1443,7 +1453,7 @@ bool MapGenerator::makeRoad2(Path *p)
 
 bool MapGenerator::makeAccessible(RoadPathCalculator *pc_land, RoadPathCalculator *pc_fly, Vector<int> dest)
 {
-  bool retval = true;
+  bool retval = false;
 
   Path *p = pc_fly->calculate (dest);
 
@@ -1494,8 +1504,6 @@ bool MapGenerator::makeAccessible(RoadPathCalculator *pc_land, RoadPathCalculato
 	}
       delete p;
     }
-  else
-    retval = false;
 
   return retval;
 }
@@ -1588,8 +1596,9 @@ std::vector<std::pair<int , Vector<int> > > MapGenerator::findBridgePlaces()
                     result.push_back(std::make_pair(EAST_WEST_BRIDGE, Vector<int>(i,j) ));
             }
         }
-    // randomize
-    std::random_shuffle(result.begin(),result.end());
+    // randomize, from our own random numbers so that the seed decides the
+    // bridges too.
+    std::shuffle(result.begin(),result.end(), std::mt19937(rnd()));
 
     // remove those that are too close to each other
     std::set<int> bad;bad.clear();
@@ -1644,9 +1653,11 @@ void MapGenerator::makeCitiesAccessible()
 	continue;
       if (pc_land.calculate_moves (it->getPos()) == 0)
         {
-          makeAccessible(&pc_land, &pc_fly, it->getPos());
-          pc_land.regenerate();
-          pc_fly.regenerate();
+          // flying costs the same over hills as over mountains, and ports
+          // don't matter to a flyer, so only the land paths go stale.
+          // they're already fresh when a new port made the city reachable.
+          if (makeAccessible(&pc_land, &pc_fly, it->getPos()) == false)
+            pc_land.regenerate();
         }
     }
 
@@ -1657,6 +1668,26 @@ void MapGenerator::makeCitiesAccessible()
   GameMap::getInstance(orig_tileset, orig_shieldset, orig_cityset);
 }
 
+int MapGenerator::roadMoves(Vector<int> pos, Vector<int> next) const
+{
+  const Maptile *tile = GameMap::getInstance()->getTile(next);
+  if (tile->getType() == Tile::WATER && tile->getBuilding() != Maptile::BRIDGE)
+    return -1;
+  if (GameMap::getInstance()->isBlockedDir(pos, next))
+    return -1;
+  return tile->getMoves();
+}
+
+void MapGenerator::paveRoad(int idx)
+{
+  if (d_building[idx] != Maptile::NONE)
+    return;
+  Vector<int> pos(idx % d_width, idx / d_width);
+  if (Citylist::getInstance()->getObjectAt(pos) != NULL)
+    return;
+  d_building[idx] = Maptile::ROAD;
+}
+
 void MapGenerator::makeRoads()
 {
   Glib::ustring orig_tileset = GameMap::getInstance()->getTilesetBaseName();
@@ -1685,22 +1716,102 @@ void MapGenerator::makeRoads()
       }
   GameMap::getInstance()->calculateBlockedAvenues();
 
-  guint32 roads_built = 0;
+  // grow one cost field out of every city at once.  each tile remembers
+  // the city that gets there the cheapest, and the tile it came from.
+  std::vector<City*> cities;
   for (auto it: *Citylist::getInstance())
+    cities.push_back(it);
+  const int size = d_width * d_height;
+  std::vector<guint32> cost(size, G_MAXUINT32);
+  std::vector<int> owner(size, -1);
+  std::vector<int> came_from(size, -1);
+  typedef std::pair<guint32, int> Step;
+  std::priority_queue<Step, std::vector<Step>, std::greater<Step> > queue;
+  for (size_t i = 0; i < cities.size(); i++)
     {
-      City *c = Citylist::getInstance()->getNearestCityPast(it->getPos(), 13);
-      Vector<int> dest = c->getPos();
-      Vector<int> src = it->getPos();
-      //does it already have a road going to it?
-      if (Roadlist::getInstance()->getNearestObjectBefore(dest, c->getSize() + 1))
-	continue;
+      Vector<int> pos = cities[i]->getPos();
+      int idx = pos.y*d_width + pos.x;
+      cost[idx] = 0;
+      owner[idx] = i;
+      queue.push(Step(0, idx));
+    }
+  while (!queue.empty())
+    {
+      Step step = queue.top();
+      queue.pop();
+      int idx = step.second;
+      if (step.first != cost[idx])
+        continue;
+      Vector<int> pos(idx % d_width, idx / d_width);
+      for (int dir = 0; dir < 8; dir++)
+        {
+          Vector<int> next(pos.x + d_xdir[dir], pos.y + d_ydir[dir]);
+          if (offmap(next.x, next.y))
+            continue;
+          int moves = roadMoves(pos, next);
+          if (moves < 0)
+            continue;
+          int nidx = next.y*d_width + next.x;
+          if (cost[idx] + moves < cost[nidx])
+            {
+              cost[nidx] = cost[idx] + moves;
+              owner[nidx] = owner[idx];
+              came_from[nidx] = idx;
+              queue.push(Step(cost[nidx], nidx));
+            }
+        }
+    }
 
-      if (makeRoad(src, dest))
+  // wherever the fields of two cities meet, there is a road between them.
+  // keep the cheapest one for every pair of cities.
+  std::map<std::pair<int, int>, RoadLink> cheapest;
+  for (int idx = 0; idx < size; idx++)
+    {
+      if (owner[idx] == -1)
+        continue;
+      Vector<int> pos(idx % d_width, idx / d_width);
+      for (int dir = 0; dir < 8; dir++)
         {
-          roads_built++;
-          if (roads_built > Citylist::getInstance()->size()/3)
-            break;
+          Vector<int> next(pos.x + d_xdir[dir], pos.y + d_ydir[dir]);
+          if (offmap(next.x, next.y))
+            continue;
+          int nidx = next.y*d_width + next.x;
+          if (owner[nidx] == -1 || owner[nidx] == owner[idx])
+            continue;
+          int moves = roadMoves(pos, next);
+          if (moves < 0)
+            continue;
+          RoadLink link;
+          link.cost = cost[idx] + moves + cost[nidx];
+          link.src = idx;
+          link.dest = nidx;
+          std::pair<int, int> key(std::min(owner[idx], owner[nidx]),
+                                  std::max(owner[idx], owner[nidx]));
+          std::map<std::pair<int, int>, RoadLink>::iterator it =
+            cheapest.find(key);
+          if (it == cheapest.end() || link.cost < it->second.cost)
+            cheapest[key] = link;
         }
+    }
+  std::vector<RoadLink> links;
+  for (auto it: cheapest)
+    links.push_back(it.second);
+  std::stable_sort(links.begin(), links.end(), RoadLink::cheaper);
+
+  // pave the cheapest roads that join cities that aren't joined yet.
+  std::vector<int> joined(cities.size());
+  for (size_t i = 0; i < cities.size(); i++)
+    joined[i] = i;
+  for (auto link: links)
+    {
+      int a = owner[link.src], b = owner[link.dest];
+      if (findAreaRoot(joined, a) == findAreaRoot(joined, b))
+        continue;
+      joinAreas(joined, a, b);
+      for (int idx = link.src; idx != -1; idx = came_from[idx])
+        paveRoad(idx);
+      for (int idx = link.dest; idx != -1; idx = came_from[idx])
+        paveRoad(idx);
       progress.emit(.810, _("paving roads..."));
     }
 
@@ -1832,11 +1943,11 @@ void MapGenerator::rescueLoneTiles(Tile::Type FIND_THIS, Tile::Type REPLACE, boo
                     if ( box[0][2] && !box[1][2] &&  box[2][2] &&  
                          box[0][1] &&  box[1][1] &&  box[2][1] && 
                          box[0][0] && !box[1][0] &&  box[2][0])
-                            d_terrain[j*d_width + i+(Rnd::rand()%2?+1:-1)] = FIND_THIS;
+                            d_terrain[j*d_width + i+(rnd()%2?+1:-1)] = FIND_THIS;
                     if ( box[0][2] &&  box[1][2] &&  box[2][2] &&  
                         !box[0][1] &&  box[1][1] && !box[2][1] && 
                          box[0][0] &&  box[1][0] &&  box[2][0])
-                            d_terrain[(j+(Rnd::rand()%2?+1:-1))*d_width + i] = FIND_THIS;
+                            d_terrain[(j+(rnd()%2?+1:-1))*d_width + i] = FIND_THIS;
 
                     if ( box[0][2] && !box[1][2] && !box[2][2] &&  
                          box[0][1] &&  box[1][1] && !box[2][1] && 
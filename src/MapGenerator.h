@@ -29,6 +29,7 @@
 #include "vector.h"
 #include <vector>
 #include <sigc++/signal.h>
+#include <glibmm/random.h>
 
 // we need the enums from these classes
 #include "Tile.h"
@@ -97,6 +98,16 @@ class MapGenerator
                             int phills, int pmountains);
 
 
+        /** Set the seed for the random numbers used to generate the map.
+          *
+          * Two generators with the same seed and the same settings make
+          * the same map.  By default the seed is taken from Rnd.
+          */
+        void setSeed(guint32 seed) {d_seed = seed;}
+
+        //! Get the seed that the next call to makeMap() will use.
+        guint32 getSeed() const {return d_seed;}
+
         //! Get number of cities
         int getNoCities() const {return d_nocities;}
 
@@ -178,13 +189,23 @@ class MapGenerator
           * others with it, using rivers. Ponds are allowed, but not too much of them.
           */
         void makeRivers();
+
+        //! The extent of one area found by findAreasOf().
+        struct Area
+        {
+            Area() : size(0), minx(0), miny(0), maxx(-1), maxy(-1) {}
+            int size; // number of tiles
+            int minx, miny, maxx, maxy; // bounding box, inclusive
+        };
+
         /**
           * This helper function searches whole map for enclosed ares of
           * THIS_TILE. Each such area gets a subsequent number which is
-          * assigned to corresponding cell in box. Maximum number of areas
-          * found is how_many and equals to highest number found in box.
+          * assigned to corresponding cell in box (indexed like d_terrain).
+          * The size and bounding box of area h is areas[h]; areas[0] is
+          * left empty, so the number of areas found is areas.size() - 1.
           */ 
-        void findAreasOf(Tile::Type THIS_TILE,std::vector<std::vector<int> >& box,int& how_many);
+        void findAreasOf(Tile::Type THIS_TILE,std::vector<int>& box,std::vector<Area>& areas);
         /**
           * Too much randomness and rivers can create too many small islands
           * which normally would be eroded by water along the centuries of
@@ -282,9 +303,43 @@ class MapGenerator
         void normalize();
 
         void cleanupRoads();
-	bool makeRoad(Vector<int> src, Vector<int>dest);
         bool makeRoad2(Path *p);
+
+        //! The cheapest known road between the cost fields of two cities.
+        struct RoadLink
+        {
+            guint32 cost;
+            int src; // tile index in the field of one city
+            int dest; // the neighbouring tile in the field of the other
+            static bool cheaper(const RoadLink &a, const RoadLink &b)
+              {return a.cost < b.cost;}
+        };
+
+        /** Returns how many movement points a road builder needs to step
+          * from pos onto next, or -1 if it can't.
+          */
+        int roadMoves(Vector<int> pos, Vector<int> next) const;
+
+        //! Puts a road on the tile at index idx if there's nothing there.
+        void paveRoad(int idx);
+
+        /** Turns mountains into hills and places ports along the flying
+          * path to dest, until a port is placed that can be reached over
+          * land.
+          *
+          * @return true if a port was placed that pcl can reach.  pcl has
+          * been regenerated then.  This says nothing about dest itself,
+          * which the caller has to check again.
+          */
 	bool makeAccessible(RoadPathCalculator *pcl, RoadPathCalculator *pcf, Vector<int> dest);
+
+        /** Paves a minimum spanning network of roads between the cities.
+          *
+          * One search grows a cost field out of every city at the same time.
+          * Wherever the fields of two cities meet we have a candidate road
+          * between them, and the cheapest candidates that join cities not
+          * already joined get paved.
+          */
 	void makeRoads();
         void makeCitiesAccessible();
 
@@ -334,6 +389,11 @@ class MapGenerator
         int d_pswamp, d_pwater, d_pforest, d_phills, d_pmountains;
         unsigned int d_nocities, d_notemples, d_noruins, d_nosignposts;
 	Cityset *cityset;
+        guint32 d_seed;
+        Glib::Rand d_rand; // seeded with d_seed at the start of makeMap()
+
+        //! Returns the next random number for this map.
+        guint32 rnd() {return d_rand.get_int();}
 };
 
 #endif
@@ -385,20 +385,7 @@ PathCalculator::~PathCalculator()
 //am i blocked from entering destx,desty from x,y when i'm not flying?
 bool PathCalculator::isBlockedDir(Vector<int> pos, Vector<int> next)
 {
-  int diffx = next.x - pos.x;
-  int diffy = next.y - pos.y;
-  if (diffx >= -1 && diffx <= 1 && diffy >= -1 && diffy <= 1) 
-    {
-      int idxs[3][3] =
-        {
-            { 0, 1, 2 },
-            { 4, 0, 3 },
-            { 5, 6, 7 },
-        };
-      return GameMap::getInstance()->getTile(pos)->d_blocked[idxs[diffx+1][diffy+1]];
-    }
-
-  return false;
+  return GameMap::getInstance()->isBlockedDir(pos, next);
 }
 
 bool PathCalculator::isBlocked(const Stack *s, Vector<int> pos, bool enemy_cities_block, bool enemy_stacks_block)
@@ -85,6 +85,15 @@ PixMask::PixMask(Cairo::RefPtr<Cairo::Surface> p, Cairo::RefPtr<Cairo::Surface>
   unscaled_height = height;
 }
 
+PixMask::PixMask(Cairo::RefPtr<Cairo::ImageSurface> p, int unscaled_w,
+                 int unscaled_h)
+    : pixmap(p), width(p->get_width()), height(p->get_height()),
+    unscaled_width(unscaled_w), unscaled_height(unscaled_h)
+{
+  gc = Cairo::Context::create(pixmap);
+  mask = Cairo::ImageSurface::create (Cairo::FORMAT_ARGB32, width, height);
+}
+
 PixMask::PixMask(const PixMask&p)
 {
   width = p.width;
@@ -160,11 +169,24 @@ PixMask* PixMask::create(Glib::RefPtr<Gdk::Pixbuf> pixbuf)
   return new PixMask(pixbuf);
 }
 
+PixMask* PixMask::create(Glib::RefPtr<Gdk::Pixbuf> pixbuf, int unscaled_w, int unscaled_h)
+{
+  PixMask *pix = new PixMask(pixbuf);
+  pix->set_unscaled_width(unscaled_w);
+  pix->set_unscaled_height(unscaled_h);
+  return pix;
+}
+
 PixMask* PixMask::create(Cairo::RefPtr<Cairo::Surface> pixmap, Cairo::RefPtr<Cairo::Surface> mask)
 {
   return new PixMask(pixmap, mask);
 }
 
+PixMask* PixMask::create(Cairo::RefPtr<Cairo::ImageSurface> pixmap, int unscaled_w, int unscaled_h)
+{
+  return new PixMask(pixmap, unscaled_w, unscaled_h);
+}
+
 PixMask* PixMask::copy()
 {
   return new PixMask(*this);
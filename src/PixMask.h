@@ -42,8 +42,17 @@ class PixMask
 
      static PixMask* create(Glib::ustring file, bool &broken);
      static PixMask* create(Glib::RefPtr<Gdk::Pixbuf> buf);
+     //! make a pixmask out of a pixbuf that has already been scaled.
+     static PixMask* create(Glib::RefPtr<Gdk::Pixbuf> buf,
+                            int unscaled_width, int unscaled_height);
      static PixMask* create(Cairo::RefPtr<Cairo::Surface> pixmap,
 					 Cairo::RefPtr<Cairo::Surface> mask);
+     //! make a pixmask out of a surface that has already been scaled.
+     /**
+      * The pixmask draws with the given surface instead of a copy of it.
+      */
+     static PixMask* create(Cairo::RefPtr<Cairo::ImageSurface> pixmap,
+                            int unscaled_width, int unscaled_height);
      PixMask* copy();
 
      //! convert this pixmask to a pixbuf.
@@ -71,6 +80,10 @@ class PixMask
      //! Alternative constructor.
      PixMask(Cairo::RefPtr<Cairo::Surface> pixmap, Cairo::RefPtr<Cairo::Surface> mask);
 
+     //! Constructor that takes over a surface.
+     PixMask(Cairo::RefPtr<Cairo::ImageSurface> pixmap, int unscaled_width,
+             int unscaled_height);
+
      //! Copy constructor.
      PixMask(const PixMask&);
 
@@ -91,7 +91,7 @@ bool Threat::Near(Vector<int> pos, Player *p) const
             it != d_stacks->end(); ++it)
         {
             Vector<int> spos = (*it)->getPos();
-            if (abs(pos.x - spos.x) <= 1 && abs(pos.y - spos.y <= 1))
+            if (abs(pos.x - spos.x) <= 1 && abs(pos.y - spos.y) <= 1)
                 return true;
         }
 
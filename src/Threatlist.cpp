@@ -19,10 +19,13 @@
 //  02110-1301, USA.
 
 #include <iostream>
+#include <algorithm>
 
 #include "Threatlist.h"
 #include "stack.h"
 #include "ruin.h"
+#include "city.h"
+#include "sortedview.h"
 #include "player.h"
 #include "AICityInfo.h"
 
@@ -30,6 +33,7 @@
 #define debug(x)
 
 Threatlist::Threatlist()
+ : d_next_added(0)
 {
 }
 
@@ -82,69 +86,77 @@ void Threatlist::sortByValue()
 
 void Threatlist::sortByDistance(Vector<int> pos)
 {
-    // A simple bubble sort is propably too computationally expensive here.
-    // To reduce the overhead, we first calculate all distances, store them
-    // in another list and sort both lists together.
-
-    std::list<int> distances;
-
+    SortedView<int, Threat*> view;
     for (iterator it = begin(); it != end(); it++)
-    {
-        //int dist = abs((*it)->getClosestPoint(pos).x - pos.x);
-        //if (dist < abs((*it)->getClosestPoint(pos).y - pos.y))
-            //dist = abs((*it)->getClosestPoint(pos).y - pos.y);
-        distances.push_back(dist((*it)->getClosestPoint(pos), pos));
-    }
+        view.add(dist((*it)->getClosestPoint(pos), pos), *it);
+    view.sort();
 
-    // now again a bubble sort :)
-    bool sorted = false;
-
-    while (!sorted)
-    {
-        sorted = true;
+    std::list<Threat*>::clear();
+    view.copyTo(*this);
+}
 
-        // setup
-        std::list<int>::iterator dit = distances.begin();
-        std::list<int>::iterator dnextit = distances.begin();
-        dnextit++;
+std::pair<int, int> Threatlist::getSquare(Vector<int> pos)
+{
+  return std::make_pair(pos.x / SQUARE_SIZE, pos.y / SQUARE_SIZE);
+}
 
-        iterator it = begin();
-        iterator nextit = it;
-        nextit++;
+void Threatlist::index(Threat *threat, Vector<int> pos)
+{
+  std::vector<Threat*> &threats = d_squares[getSquare(pos)];
+  if (std::find(threats.begin(), threats.end(), threat) == threats.end())
+    threats.push_back(threat);
+}
 
-        for (; nextit != end(); it++, nextit++, dit++, dnextit++)
-            if ((*dit) > (*dnextit))
-            {
-                // exchange the items in both lists
-                sorted = false;
-                
-                Threat* tmp = (*nextit);
-                erase(nextit);
-                nextit = it;
-                it = insert(nextit, tmp);
+void Threatlist::add(Threat *threat)
+{
+  d_added[threat] = d_next_added++;
+  push_back(threat);
+}
 
-                int val = (*dnextit);
-                distances.erase(dnextit);
-                dnextit = dit;
-                dit = distances.insert(dnextit, val);
-            }
-    }
+std::vector<Threat*> Threatlist::getThreatsAround(Vector<int> pos, int radius) const
+{
+  std::vector<Threat*> threats;
+  std::pair<int, int> from = getSquare(pos - Vector<int>(radius, radius));
+  std::pair<int, int> to = getSquare(pos + Vector<int>(radius, radius));
+  for (int x = from.first; x <= to.first; x++)
+    for (int y = from.second; y <= to.second; y++)
+      {
+        std::map<std::pair<int, int>, std::vector<Threat*> >::const_iterator it
+          = d_squares.find(std::make_pair(x, y));
+        if (it == d_squares.end())
+          continue;
+        for (auto threat: it->second)
+          if (d_added.find(threat) != d_added.end())
+            threats.push_back(threat);
+      }
+
+  // put them back in the order they were added, without duplicates.
+  const std::map<const Threat*, guint32> &added = d_added;
+  std::sort(threats.begin(), threats.end(), 
+            [&added](const Threat *lhs, const Threat *rhs)
+            {return added.find(lhs)->second < added.find(rhs)->second;});
+  threats.erase(std::unique(threats.begin(), threats.end()), threats.end());
+  return threats;
 }
 
 void Threatlist::addStack(Stack *stack)
 {
-    for (iterator it = begin(); it != end(); it++)
+    // the first threat near the stack takes it.  a stack is near the
+    // threats on the tiles around it.
+    std::vector<Threat*> threats = getThreatsAround(stack->getPos(), 1);
+    for (auto threat: threats)
     {
-        Threat *threat = *it;
         if (threat->Near(stack->getPos(), stack->getOwner()))
         {
             threat->addStack(stack);
+            index(threat, stack->getPos());
             return;
         }
     }
 
     Threat *t = new Threat(stack);
-    push_back(t);
+    add(t);
+    index(t, stack->getPos());
 }
 
 void Threatlist::addRuin(Ruin *ruin)
@@ -154,7 +166,17 @@ void Threatlist::addRuin(Ruin *ruin)
         return;
 
     Threat *t = new Threat(ruin);
-    push_back(t);
+    add(t);
+    index(t, ruin->getPos());
+}
+
+void Threatlist::addCity(City *city)
+{
+    Threat *t = new Threat(city);
+    add(t);
+    for (unsigned int i = 0; i < city->getSize(); i++)
+      for (unsigned int j = 0; j < city->getSize(); j++)
+        index(t, city->getPos() + Vector<int>(i, j));
 }
 
 void Threatlist::findThreats(AICityInfo *info) const
@@ -162,9 +184,11 @@ void Threatlist::findThreats(AICityInfo *info) const
     //shortcut
     Vector<int> location = info->getPos();
 
-    for (const_iterator it = begin(); it != end(); it++)
+    // threats more than 64 tiles away are more than 10 moves away, and
+    // get ignored below.
+    std::vector<Threat*> threats = getThreatsAround(location, 64);
+    for (auto threat: threats)
     {
-        Threat *threat = *it;
         Vector<int> closestPoint = threat->getClosestPoint(location);
 
         //This happens only if a threat doesn't contain any stacks any longer.
@@ -237,10 +261,13 @@ void Threatlist::flClear()
         delete (*it);
 
     clear();
+    d_squares.clear();
+    d_added.clear();
 }
 
 Threatlist::iterator Threatlist::flErase(iterator object)
 {
+    d_added.erase(*object);
     delete (*object);
     return erase(object);
 }
@@ -250,6 +277,7 @@ bool Threatlist::flRemove(Threat* object)
     iterator threatit = find(begin(), end(), object);
     if (threatit != end())
     {
+        d_added.erase(object);
         delete object;
         erase(threatit);
         return true;
@@ -23,10 +23,13 @@
 #define THREATLIST_H
 
 #include <list>
+#include <map>
+#include <vector>
 #include "Threat.h"
 
 class Stack;
 class Ruin;
+class City;
 class AICityInfo;
 
 //! Artificial intelligence for representing a list of threats to a Player.
@@ -46,6 +49,9 @@ class Threatlist : public std::list<Threat*>
 
         //! Add a ruin as a threat
         void addRuin(Ruin *ruin);
+
+        //! Add an enemy city as a threat
+        void addCity(City *city);
         
         //! Adds a stack as a threat. 
 	/**
@@ -91,6 +97,36 @@ class Threatlist : public std::list<Threat*>
     private:
 
         static bool compareValue(const Threat *lhs, const Threat *rhs);
+
+        //! Add a threat to the end of the list, and index it.
+        void add(Threat *threat);
+
+        //! Note that the threat covers the tile at pos.
+        void index(Threat *threat, Vector<int> pos);
+
+        //! Get the indexed threats covering tiles within radius of pos.
+        /**
+         * The threats come back in the order they were added.  Threats that
+         * used to cover a tile may also show up, so callers have to check.
+         */
+        std::vector<Threat*> getThreatsAround(Vector<int> pos, int radius) const;
+
+        //! Returns the square of the index that the given position is in.
+        static std::pair<int, int> getSquare(Vector<int> pos);
+
+        //! How many tiles wide and high the squares of the index are.
+        static const int SQUARE_SIZE = 8;
+
+        // DATA
+
+        //! The threats covering each square of the map.
+        std::map<std::pair<int, int>, std::vector<Threat*> > d_squares;
+
+        //! When each threat in the list was added.
+        std::map<const Threat*, guint32> d_added;
+
+        //! How many threats have ever been added, so the order never repeats.
+        guint32 d_next_added;
 };
 
 #endif // THREATLIST_H
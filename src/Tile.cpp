@@ -22,7 +22,6 @@
 #include <iostream>
 #include "File.h"
 #include "tileset.h"
-#include "tarhelper.h"
 #include "xmlhelper.h"
 #include "rnd.h"
 
@@ -244,23 +243,6 @@ void Tile::uninstantiateImages()
     (*it)->uninstantiateImages();
 }
 
-void Tile::instantiateImages(int tilesize, Tar_Helper *t, bool &broken)
-{
-  broken = false;
-  for (iterator it = begin(); it != end(); it++)
-    {
-      Glib::ustring file = "";
-      if ((*it)->getName().empty() == false && !broken)
-        {
-          file = t->getFile((*it)->getName() + ".png", broken);
-          if (!broken)
-            (*it)->instantiateImages(tilesize, file, broken);
-          if (file.empty() == false)
-            File::erase(file);
-        }
-    }
-}
-
 guint32 Tile::countTileStyles(TileStyle::Type type) const
 {
   guint32 count = 0;
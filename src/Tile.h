@@ -27,7 +27,6 @@
 
 class XML_Helper;
 class SmallTile;
-class Tar_Helper;
 //! Describes a kind of tile that a Stack can traverse.
 /** 
  * Many tiles are put together to form a tileset. Thus, a tile describes a
@@ -156,9 +155,6 @@ class Tile : public std::list<TileStyleSet*>
 	//! Destroy the images associated with this tile.
 	void uninstantiateImages();
 
-	//! Load the images associated with this tile.
-	void instantiateImages(int tilesize, Tar_Helper *t, bool &broken);
-
 
 	// Static Methods
 
@@ -108,6 +108,7 @@ void AI_Fast::abortTurn()
 
 bool AI_Fast::startTurn()
 {
+    startThinking(GameScenarioOptions::s_easy_ai_think_time);
 
     sbusy.emit();
 
@@ -216,6 +217,8 @@ bool AI_Fast::startTurn()
 	  found = false;
 	if (abort_requested)
 	  break;
+	if (isOutOfThinkTime())
+	  break;
       }
 
     delete d_analysis;
@@ -415,8 +418,17 @@ bool AI_Fast::computerTurn()
     // way round.
  
   std::list<Vector<int> > points = d_stacklist->getPositions();
+
+  // when we might run out of time, first move the stacks that are already
+  // on their way to an enemy city.  they're cheap to move and they matter.
+  if (GameScenarioOptions::s_easy_ai_think_time)
+    points.sort([] (const Vector<int> &a, const Vector<int> &b)
+                {return isOnTheAttack(a) && !isOnTheAttack(b);});
+
   for (auto it: points)
     {
+      if (isOutOfThinkTime())
+        break;
       Stack *s = GameMap::getFriendlyStack(it);
       if (!s)
         continue;
@@ -801,6 +813,15 @@ bool AI_Fast::computerTurn()
     return stack_moved;
 }
 
+bool AI_Fast::isOnTheAttack(Vector<int> pos)
+{
+  Stack *s = GameMap::getFriendlyStack(pos);
+  if (!s || s->hasPath() == false || s->getParked() == true)
+    return false;
+  City *enemy = GameMap::getEnemyCity(s->getLastPointInPath());
+  return enemy && enemy->isBurnt() == false;
+}
+
 bool AI_Fast::chooseTreachery (Stack *stack, Player *player, Vector <int> pos)
 {
   (void) stack;
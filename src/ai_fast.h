@@ -113,6 +113,9 @@ class AI_Fast : public RealPlayer
 
         int scoreArmyType(const ArmyProdBase *a);
 
+        //! Whether or not our stack at pos is on its way to an enemy city.
+        static bool isOnTheAttack(Vector<int> pos);
+
 	//! Determines whether to join units or move them separately.
         bool d_join;
 
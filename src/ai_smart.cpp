@@ -39,6 +39,7 @@
 #include "SightMap.h"
 #include "Sage.h"
 #include "GameMap.h"
+#include "GameScenarioOptions.h"
 
 //#define debug(x) {std::cerr<<__FILE__<<": "<<__LINE__<<": "<<x<<std::flush<<std::endl;}
 #define debug(x)
@@ -62,6 +63,7 @@ AI_Smart::AI_Smart(XML_Helper* helper)
 
 bool AI_Smart::startTurn()
 {
+  startThinking(GameScenarioOptions::s_hard_ai_think_time);
   sbusy.emit();
 
   if (getStacklist()->getHeroes().size() == 0 &&
@@ -104,6 +106,10 @@ bool AI_Smart::startTurn()
     }
   if (getGold() < 30)
     build_capacity = true;
+  // after the first pass, only the stacks near something that changed in
+  // the previous pass get another look.
+  std::list<Vector<int> > changes;
+  bool first_pass = true;
   while (true)
     {
       sbusy.emit();
@@ -111,7 +117,11 @@ bool AI_Smart::startTurn()
       AI_Allocation *allocation = new AI_Allocation(analysis, threats, this);
       allocation->sbusy.connect 
         (sigc::mem_fun (sbusy, &sigc::signal<void>::emit));
+      if (!first_pass)
+        allocation->setChanges(changes);
       int moveCount = allocation->move(first_city, build_capacity);
+      changes = allocation->getChanges();
+      first_pass = false;
 
       // tidying up
       delete allocation;
@@ -121,6 +131,10 @@ bool AI_Smart::startTurn()
         break;
       if (abort_requested)
         break;
+      // the passes get the most important moves out of the way first, so
+      // when time is up we go with what we've got.
+      if (isOutOfThinkTime())
+        break;
     }
 
   delete analysis;
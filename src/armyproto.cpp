@@ -164,14 +164,27 @@ void ArmyProto::instantiateImages(guint32 tilesize, Tar_Helper *t, bool &broken)
 {
   broken = false;
   for (unsigned int c = Shield::WHITE; c <= Shield::NEUTRAL; c++)
+    if (!broken)
+      instantiateImages(tilesize, t, Shield::Colour(c), broken);
+}
+
+void ArmyProto::instantiateImages(guint32 tilesize, Tar_Helper *t, Shield::Colour c, bool &broken)
+{
+  //decode straight from the archive, without going through a file.
+  const std::string *data = NULL;
+  if (getImageName(c).empty() == false)
+    data = t->getFileContents(getImageName(c) + ".png");
+  if (data)
+    instantiateImages(tilesize, c, data, broken);
+}
+
+void ArmyProto::instantiateImages(guint32 tilesize, Shield::Colour c, const std::string *data, bool &broken)
+{
+  std::vector<PixMask*> half = load_row(data, 2, broken, tilesize, tilesize);
+  if (!broken)
     {
-      Glib::ustring file = "";
-      if (getImageName(Shield::Colour(c)).empty() == false)
-	file = t->getFile(getImageName(Shield::Colour(c)) + ".png", broken);
-      if (!broken && file.empty() == false)
-        instantiateImages(tilesize, Shield::Colour(c), file, broken);
-      if (file.empty() == false)
-        File::erase(file);
+      setImage(c, half[0]);
+      setMask(c, half[1]);
     }
 }
 
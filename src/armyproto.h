@@ -122,6 +122,12 @@ class ArmyProto : public ArmyProtoBase
 	//! Load the pictures associated with this ArmyProto object.
 	void instantiateImages(guint32 tilesize, Tar_Helper *t, bool &broken);
 
+	//! Load the picture for one colour from the armyset's archive.
+	void instantiateImages(guint32 tilesize, Tar_Helper *t, Shield::Colour c, bool &broken);
+
+	//! Load the picture for one colour from a picture in memory.
+	void instantiateImages(guint32 tilesize, Shield::Colour c, const std::string *data, bool &broken);
+
 	//! Load the ArmyProto image in the given filename.
 	void instantiateImages(int tilesize, Shield::Colour c, Glib::ustring image_filename, bool &broken);
 
@@ -43,7 +43,8 @@ Glib::ustring Armyset::file_extension = ARMYSET_EXT;
 #define DEFAULT_ARMY_TILE_SIZE 40
 Armyset::Armyset(guint32 id, Glib::ustring name)
  : Set(ARMYSET_EXT, id, name, DEFAULT_ARMY_TILE_SIZE), 
-        d_ship(0), d_shipmask(0), d_standard(0), d_standard_mask(0), d_bag(0)
+        d_ship(0), d_shipmask(0), d_standard(0), d_standard_mask(0), d_bag(0),
+        d_on_demand(false)
 {
   d_bag_name = "";
   d_stackship_name = "";
@@ -52,7 +53,7 @@ Armyset::Armyset(guint32 id, Glib::ustring name)
 
 Armyset::Armyset(XML_Helper *helper, Glib::ustring directory)
  : Set(ARMYSET_EXT, helper), d_ship(0), d_shipmask(0), d_standard(0), 
-    d_standard_mask(0), d_bag(0)
+    d_standard_mask(0), d_bag(0), d_on_demand(false)
 {
   d_bag_name = "";
   d_stackship_name = "";
@@ -70,7 +71,8 @@ Armyset::Armyset(XML_Helper *helper, Glib::ustring directory)
 
 Armyset::Armyset(const Armyset& a)
  : std::list<ArmyProto*>(), sigc::trackable(a), Set(a), d_ship(0), 
-    d_shipmask(0), d_standard(0), d_standard_mask(0), d_bag(0)
+    d_shipmask(0), d_standard(0), d_standard_mask(0), d_bag(0),
+    d_on_demand(false)
 {
 
   if (a.d_ship)
@@ -495,6 +497,115 @@ void Armyset::getFilenames(std::list<Glib::ustring> &files)
     }
 }
 	
+void Armyset::instantiateImagesOnDemand(bool &broken)
+{
+  uninstantiateImages();
+  broken = false;
+  Tar_Helper t(getConfigurationFile(), std::ios::in, broken);
+  if (broken)
+    return;
+  d_on_demand = true;
+
+  //just these three, rather than everything in the archive.
+  std::list<Glib::ustring> names;
+  if (getShipImageName().empty() == false)
+    names.push_back(getShipImageName() + ".png");
+  if (getStandardImageName().empty() == false)
+    names.push_back(getStandardImageName() + ".png");
+  if (getBagImageName().empty() == false)
+    names.push_back(getBagImageName() + ".png");
+  std::map<Glib::ustring, std::string> files = t.readFiles(names);
+  t.Close();
+
+  std::map<Glib::ustring, std::string>::iterator i;
+  i = files.find(getShipImageName() + ".png");
+  if (i != files.end())
+    loadShipPic(&(*i).second, broken);
+  i = files.find(getStandardImageName() + ".png");
+  if (i != files.end() && !broken)
+    loadStandardPic(&(*i).second, broken);
+  i = files.find(getBagImageName() + ".png");
+  if (i != files.end() && !broken)
+    loadBagPic(&(*i).second, broken);
+}
+
+void Armyset::instantiateArmyImages(guint32 type_id, Shield::Colour c)
+{
+  if (!d_on_demand)
+    return;
+  ArmyProto *a = lookupArmyByType(type_id);
+  if (!a || a->getImage(c) != NULL || a->getImageName(c).empty() == true)
+    return;
+  bool broken = false;
+  Glib::ustring name = a->getImageName(c) + ".png";
+  std::map<Glib::ustring, std::string>::iterator i = d_prefetched.find(name);
+  if (i != d_prefetched.end())
+    {
+      a->instantiateImages(getTileSize(), c, &(*i).second, broken);
+      d_prefetched.erase(i);
+    }
+  else
+    {
+      Tar_Helper t(getConfigurationFile(), std::ios::in, broken);
+      if (!broken)
+        {
+          std::map<Glib::ustring, std::string> files = 
+            t.readFiles(std::list<Glib::ustring>(1, name));
+          t.Close();
+          if (files.empty() == false)
+            a->instantiateImages(getTileSize(), c, &files.begin()->second, 
+                                 broken);
+        }
+    }
+  if (broken)
+    std::cerr << String::ucompose(_("Could not load the picture of `%1' from armyset `%2'."), a->getName(), getName()) << std::endl;
+}
+
+void Armyset::prefetchArmyImages(std::list<std::pair<guint32, Shield::Colour> > images)
+{
+  if (!d_on_demand || Gtk::Main::instance() == NULL)
+    return;
+  //read the pictures in one go, but only the ones we're going to want.
+  std::list<Glib::ustring> names;
+  for (auto i: images)
+    {
+      ArmyProto *a = lookupArmyByType(i.first);
+      if (!a || a->getImage(i.second) != NULL || 
+          a->getImageName(i.second).empty() == true)
+        continue;
+      Glib::ustring name = a->getImageName(i.second) + ".png";
+      if (d_prefetched.find(name) == d_prefetched.end())
+        names.push_back(name);
+    }
+  if (names.empty() == false)
+    {
+      bool broken = false;
+      Tar_Helper t(getConfigurationFile(), std::ios::in, broken);
+      if (!broken)
+        {
+          std::map<Glib::ustring, std::string> files = t.readFiles(names);
+          d_prefetched.insert(files.begin(), files.end());
+        }
+      t.Close();
+    }
+  d_prefetch.insert(d_prefetch.end(), images.begin(), images.end());
+  if (d_prefetch_connection.connected() == false)
+    d_prefetch_connection = Glib::signal_idle().connect
+      (sigc::mem_fun(*this, &Armyset::on_prefetch_idle));
+}
+
+bool Armyset::on_prefetch_idle()
+{
+  if (d_prefetch.empty())
+    return false;
+  std::pair<guint32, Shield::Colour> i = d_prefetch.front();
+  d_prefetch.pop_front();
+  instantiateArmyImages(i.first, i.second);
+  if (d_prefetch.empty())
+    d_prefetched.clear();
+  return d_prefetch.empty() == false;
+}
+
 void Armyset::instantiateImages(bool &broken)
 {
   uninstantiateImages();
@@ -503,40 +614,64 @@ void Armyset::instantiateImages(bool &broken)
   if (broken)
     return;
 
+  //decode every unit in every colour at once, and then hand out the
+  //pictures in order.
+  std::vector<DecodeJob> jobs;
+  std::vector<std::pair<ArmyProto*, Shield::Colour> > owners;
   for (iterator it = begin(); it != end(); ++it)
-    (*it)->instantiateImages(getTileSize(), &t, broken);
+    for (unsigned int c = Shield::WHITE; c <= Shield::NEUTRAL; c++)
+      {
+        Glib::ustring name = (*it)->getImageName(Shield::Colour(c));
+        const std::string *data = NULL;
+        if (name.empty() == false)
+          data = t.getFileContents(name + ".png");
+        if (!data)
+          continue;
+        jobs.push_back(DecodeJob(data, 2, getTileSize(), getTileSize()));
+        owners.push_back(std::make_pair(*it, Shield::Colour(c)));
+      }
+  decode_rows(jobs);
+  for (unsigned int i = 0; i < jobs.size() && !broken; i++)
+    {
+      std::vector<PixMask*> half = to_pixmasks(jobs[i]);
+      if (jobs[i].broken)
+        broken = true;
+      else
+        {
+          owners[i].first->setImage(owners[i].second, half[0]);
+          owners[i].first->setMask(owners[i].second, half[1]);
+        }
+    }
 
-  Glib::ustring ship_filename = "";
-  Glib::ustring flag_filename = "";
-  Glib::ustring bag_filename = "";
+  const std::string *ship_data = NULL;
+  const std::string *flag_data = NULL;
+  const std::string *bag_data = NULL;
   if (getShipImageName().empty() == false && !broken)
-    ship_filename = t.getFile(getShipImageName() + ".png", broken);
+    ship_data = t.getFileContents(getShipImageName() + ".png");
   if (getStandardImageName().empty() == false && !broken)
-    flag_filename = t.getFile(getStandardImageName() + ".png", broken);
+    flag_data = t.getFileContents(getStandardImageName() + ".png");
   if (getBagImageName().empty() == false && !broken)
-    bag_filename = t.getFile(getBagImageName() + ".png", broken);
+    bag_data = t.getFileContents(getBagImageName() + ".png");
 
   if (!broken)
     {
-      if (ship_filename.empty() == false)
-        loadShipPic(ship_filename, broken);
-      if (flag_filename.empty() == false)
-        loadStandardPic(flag_filename, broken);
-      if (bag_filename.empty() == false)
-        loadBagPic(bag_filename, broken);
+      if (ship_data)
+        loadShipPic(ship_data, broken);
+      if (flag_data && !broken)
+        loadStandardPic(flag_data, broken);
+      if (bag_data && !broken)
+        loadBagPic(bag_data, broken);
     }
 
-  if (ship_filename.empty() == false)
-    File::erase(ship_filename);
-  if (flag_filename.empty() == false)
-    File::erase(flag_filename);
-  if (bag_filename.empty() == false)
-    File::erase(bag_filename);
   t.Close();
 }
 
 void Armyset::uninstantiateImages()
 {
+  d_prefetch_connection.disconnect();
+  d_prefetch.clear();
+  d_prefetched.clear();
+  d_on_demand = false;
   for (iterator it = begin(); it != end(); it++)
     (*it)->uninstantiateImages();
 
@@ -610,6 +745,35 @@ void Armyset::loadStandardPic(Glib::ustring image_filename, bool &broken)
     }
 }
 
+void Armyset::loadShipPic(const std::string *data, bool &broken)
+{
+  int s = getTileSize();
+  std::vector<PixMask*> half = load_row(data, 2, broken, s, s);
+  if (!broken)
+    {
+      setShipImage(half[0]);
+      setShipMask(half[1]);
+    }
+}
+
+void Armyset::loadBagPic(const std::string *data, bool &broken)
+{
+  std::vector<PixMask*> pic = load_row(data, 1, broken);
+  if (!broken)
+    setBagPic(pic[0]);
+}
+
+void Armyset::loadStandardPic(const std::string *data, bool &broken)
+{
+  int s = getTileSize();
+  std::vector<PixMask*> half = load_row(data, 2, broken, s, s);
+  if (!broken)
+    {
+      setStandardPic(half[0]);
+      setStandardMask(half[1]);
+    }
+}
+
 void Armyset::switchArmysetForRuinKeeper(Army *army, const Armyset *armyset)
 {
   //do our best to change the armyset for the given ruin keeper.
@@ -194,9 +194,27 @@ class Armyset: public std::list<ArmyProto *>, public sigc::trackable, public Set
 
 	void instantiateImages(bool &broken);
 	void uninstantiateImages();
+
+        //! Get ready to load the army unit pictures as they're needed.
+        /**
+         * This loads the ship, standard and bag pictures straight away, but
+         * an army unit's picture in a given colour isn't decoded until
+         * instantiateArmyImages is called for it.  Most of the colours and
+         * units in an armyset never make it on to the screen.
+         */
+        void instantiateImagesOnDemand(bool &broken);
+
+        //! Load the picture of an army unit in a colour, if we haven't yet.
+        void instantiateArmyImages(guint32 type_id, Shield::Colour c);
+
+        //! Load the given army unit pictures a few at a time when idle.
+        void prefetchArmyImages(std::list<std::pair<guint32, Shield::Colour> > images);
 	void loadStandardPic(Glib::ustring image_filename, bool &broken);
 	void loadShipPic(Glib::ustring image_filename, bool &broken);
 	void loadBagPic(Glib::ustring image_filename, bool &broken);
+	void loadStandardPic(const std::string *data, bool &broken);
+	void loadShipPic(const std::string *data, bool &broken);
+	void loadBagPic(const std::string *data, bool &broken);
 
 	static void switchArmyset(Army *army, const Armyset *armyset);
 	static void switchArmyset(ArmyProdBase *army, const Armyset *armyset);
@@ -216,6 +234,9 @@ class Armyset: public std::list<ArmyProto *>, public sigc::trackable, public Set
 
         //! Callback function for the army tag (see XML_Helper)
         bool loadArmyProto(Glib::ustring tag, XML_Helper* helper);
+
+        //! Callback to load the next of the prefetched army unit pictures.
+        bool on_prefetch_idle();
         
 	//! The unshaded picture of the stack when it's in a boat.
 	PixMask* d_ship;
@@ -240,6 +261,22 @@ class Armyset: public std::list<ArmyProto *>, public sigc::trackable, public Set
 
 	//! The name of the file that holds the picture of the sack of items.
 	Glib::ustring d_bag_name;
+
+        //! Whether army unit pictures are loaded as they're needed.
+        bool d_on_demand;
+
+        //! Prefetched army unit pictures that haven't been decoded yet.
+        /**
+         * Each one is thrown away as soon as it is decoded, and pictures
+         * that weren't prefetched are read from the armyset file when
+         * they're asked for.
+         */
+        std::map<Glib::ustring, std::string> d_prefetched;
+
+        //! The army unit pictures still to be prefetched.
+        std::list<std::pair<guint32, Shield::Colour> > d_prefetch;
+
+        sigc::connection d_prefetch_connection;
 };
 
 bool weakest_quickest (const ArmyProto* first, const ArmyProto* second);
@@ -463,7 +463,7 @@ void BigMap::draw_buffer_tile(Vector<int> tile, Cairo::RefPtr<Cairo::Surface> su
       pixmask->blit(surface, tile_to_buffer_pos(tile));
       return;
     }
-  MapBackpack *backpack = GameMap::getInstance()->getTile(tile)->getBackpack();
+  MapBackpack *backpack = GameMap::getInstance()->findBackpack(tile);
   if (backpack && backpack->empty() == false)
     {
       bool standard_planted = false;
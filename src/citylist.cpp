@@ -35,6 +35,7 @@
 #include "citysetlist.h"
 #include "PathCalculator.h"
 #include "rnd.h"
+#include "sortedview.h"
 
 //#define debug(x) {std::cerr<<__FILE__<<": "<<__LINE__<<": "<<x<<std::endl<<std::flush;}
 #define debug(x)
@@ -69,10 +70,12 @@ void Citylist::deleteInstance()
 }
 
 Citylist::Citylist()
+ : d_by_distance_size(0)
 {
 }
 
 Citylist::Citylist(XML_Helper* helper)
+ : d_by_distance_size(0)
 {
     // simply ask the helper to inform us when a city tag is opened
     helper->registerTag(City::d_tag, sigc::mem_fun(this, &Citylist::load));
@@ -145,36 +148,46 @@ void Citylist::nextTurn(Player* p)
     //we've already collected taxes this round, so hopefully our
     //treasury has enough money to pay our city upkeep.
 
-    guint32 cost_of_new_armies = calculateUpcomingUpkeep(p);
+    // pick out the player's cities once, and work on them as a batch.
+    std::vector<City*> cities;
+    guint32 cost_of_new_armies = 0;
+    for (iterator it = begin(); it != end(); it++)
+      {
+        City *c = *it;
+        if (c->getOwner() != p || c->isBurnt() == true)
+          continue;
+        cities.push_back(c);
+        int slot = c->getActiveProductionSlot();
+        if (c->getDuration() == 1 && slot != -1)
+          {
+	    const ArmyProdBase *a = c->getProductionBase(slot);
+	    cost_of_new_armies += a->getUpkeep();
+	    cost_of_new_armies += a->getProductionCost();
+          }
+      }
+
     if (p->getGold() < (int)cost_of_new_armies)
       {
 	int diff = cost_of_new_armies - p->getGold();
 	//then we have to turn off enough production to make up for diff
 	//gold pieces.
-	for (iterator it = begin(); it != end(); it++)
+	for (auto c: cities)
 	  {
-	    if ((*it)->isBurnt() == true)
-	      continue;
-	    if ((*it)->getOwner() != p)
-	      continue;
-	    int slot =(*it)->getActiveProductionSlot();
+	    int slot = c->getActiveProductionSlot();
 	    if (slot == -1)
 	      continue;
-	    const ArmyProdBase *a = (*it)->getProductionBase(slot);
+	    const ArmyProdBase *a = c->getProductionBase(slot);
 	    diff -= a->getUpkeep();
     
-	    p->cityTooPoorToProduce((*it), slot);
+	    p->cityTooPoorToProduce(c, slot);
 	    if (diff < 0)
 	      break;
 	  }
       }
 
     // This iteration adds the city production to the player    
-    for (iterator it = begin(); it != end(); it++)
-      {
-        if ((*it)->getOwner() == p)
-            (*it)->nextTurn();
-      }
+    for (auto c: cities)
+      c->nextTurn();
 
 }
 
@@ -418,6 +431,66 @@ City* Citylist::getNearestFriendlyVectorableCity(const Vector<int>& pos) const
   return getNearestObject(pos, &filters);
 }
 
+City* Citylist::getNearestEnemyCity(const City *city) const
+{
+  std::list<bool (*)(void *)> filters;
+  filters.push_back(isBurnt);
+  filters.push_back(isNotOwnedByEnemy);
+  return getNearestCity(city, &filters);
+}
+
+City* Citylist::getNearestFriendlyVectorableCity(const City *city) const
+{
+  std::list<bool (*)(void *)> filters;
+  filters.push_back(isBurnt);
+  filters.push_back(isNotOwnedByActivePlayer);
+  filters.push_back(canNotAcceptMoreVectoring);
+  return getNearestCity(city, &filters);
+}
+
+City* Citylist::getNearestCity(const City *city, std::list<bool (*)(void*)> *filters) const
+{
+  for (auto c: getCitiesByDistance(city))
+    {
+      bool filtered = false;
+      for (auto f: *filters)
+        if (f(c) == true)
+          {
+            filtered = true;
+            break;
+          }
+      if (!filtered)
+        return c;
+    }
+  return NULL;
+}
+
+const std::vector<City*> &Citylist::getCitiesByDistance(const City *city) const
+{
+  if (d_by_distance_size != size())
+    {
+      d_by_distance.clear();
+      d_by_distance_size = size();
+    }
+  std::vector<City*> &row = d_by_distance[city->getId()];
+  if (row.empty())
+    {
+      Vector<int> pos = city->getPos();
+      row.assign(begin(), end());
+      //ties go to the city that comes first in the list, like they do in
+      //getNearestObject.
+      std::stable_sort(row.begin(), row.end(), 
+                       [pos] (const City *a, const City *b)
+                       {
+                         Vector<int> p = a->getPos();
+                         Vector<int> q = b->getPos();
+                         return abs(p.x - pos.x) + abs(p.y - pos.y) <
+                           abs(q.x - pos.x) + abs(q.y - pos.y);
+                       });
+    }
+  return row;
+}
+
 bool Citylist::save(XML_Helper* helper) const
 {
     bool retval = true;
@@ -546,46 +619,16 @@ std::list<City*> Citylist::getNearestFriendlyCities(Player *player, Vector<int>
     }
   if (cities.size() == 0)
     return cities;
-  std::list<int> distances;
-
   if (pos == Vector<int>(-1,-1))
     pos = player->getFirstCity()->getPos();
 
+  SortedView<int, City*> view;
   for (std::list<City*>::iterator it = cities.begin(); it != cities.end(); it++)
-    distances.push_back(dist((*it)->getNearestPos(pos), pos));
-
-  bool sorted = false;
+    view.add(dist((*it)->getNearestPos(pos), pos), *it);
+  view.sort();
 
-  while (!sorted)
-    {
-      sorted = true;
-
-      // setup
-      std::list<int>::iterator dit = distances.begin();
-      std::list<int>::iterator dnextit = distances.begin();
-      dnextit++;
-
-      std::list<City*>::iterator it = cities.begin();
-      std::list<City*>::iterator nextit = it;
-      nextit++;
-
-      for (; nextit != cities.end(); it++, nextit++, dit++, dnextit++)
-        if ((*dit) > (*dnextit))
-          {
-            // exchange the items in both lists
-            sorted = false;
-
-            City* tmp = (*nextit);
-            cities.erase(nextit);
-            nextit = it;
-            it = cities.insert(nextit, tmp);
-
-            int val = (*dnextit);
-            distances.erase(dnextit);
-            dnextit = dit;
-            dit = distances.insert(dnextit, val);
-          }
-    }
+  cities.clear();
+  view.copyTo(cities);
   return cities;
 }
 
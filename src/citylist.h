@@ -23,6 +23,7 @@
 #ifndef CITYLIST_H
 #define CITYLIST_H
 
+#include <vector>
 #include "LocationList.h"
 #include <sigc++/trackable.h>
 
@@ -345,6 +346,26 @@ class Citylist : public LocationList<City*>, public sigc::trackable
 	//! Get the nearest city to POS that can be vectored to.
 	City* getNearestFriendlyVectorableCity(const Vector<int>& pos) const;
 
+        //! Returns the closest enemy city to the given city.
+        /**
+         * This gives the same answer as getNearestEnemyCity(pos), but it
+         * walks the cities in order of distance from the given city and
+         * stops at the first enemy.
+         */
+        City* getNearestEnemyCity(const City *city) const;
+
+	//! Get the nearest city to the given city that can be vectored to.
+	City* getNearestFriendlyVectorableCity(const City *city) const;
+
+        //! Return every city, nearest to the given city first.
+        /**
+         * The rows are worked out when they're first asked for, and are
+         * kept until the number of cities changes.  Cities don't move
+         * during a game, and a change of owner only changes which of the
+         * cities a search is looking for, not the order they're in.
+         */
+        const std::vector<City*> &getCitiesByDistance(const City *city) const;
+
         //! Get our nearest cities in order of distance from our capital.
         std::list<City*> getNearestFriendlyCities(Player *player, Vector<int> pos = Vector<int>(-1,-1)) const;
 
@@ -385,6 +406,15 @@ class Citylist : public LocationList<City*>, public sigc::trackable
         //! A callback for loading City objects into the list of cities.
         bool load(Glib::ustring tag, XML_Helper* helper);
 
+        //! Return the nearest city to CITY that gets through the filters.
+        City* getNearestCity(const City *city, std::list<bool (*)(void*)> *filters) const;
+
+        //! Every city by distance from a city, keyed by city id.
+        mutable std::map<guint32, std::vector<City*> > d_by_distance;
+
+        //! How many cities there were when d_by_distance was filled.
+        mutable guint32 d_by_distance_size;
+
         //! A static pointer for the singleton instance.
         static Citylist* s_instance;
 };
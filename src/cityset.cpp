@@ -328,149 +328,80 @@ void Cityset::uninstantiateImages()
     }
 }
 
-void Cityset::instantiateImages(Glib::ustring port_filename,
-				Glib::ustring signpost_filename,
-				Glib::ustring cities_filename,
-				Glib::ustring razed_cities_filename,
-				Glib::ustring towers_filename,
-				Glib::ustring ruins_filename,
-				Glib::ustring temples_filename,
-                                bool &broken)
+void Cityset::instantiateImages(bool &broken)
 {
-  if (port_filename.empty() == false && !broken)
-    setPortImage (PixMask::create(port_filename, broken));
-  if (signpost_filename.empty() == false && !broken)
-    setSignpostImage (PixMask::create(signpost_filename, broken));
+  debug("Loading images for cityset " << getName());
+  uninstantiateImages();
+  broken = false;
+  Tar_Helper t(getConfigurationFile(), std::ios::in, broken);
+  if (broken)
+    return;
 
-      
+  //decode the pictures all at once, and then hand them out.
+  enum {PORT, SIGNPOST, CITIES, RAZED_CITIES, TOWERS, RUINS, TEMPLES, PICS};
+  Glib::ustring names[PICS] = 
+    {getPortFilename(), getSignpostFilename(), getCitiesFilename(),
+      getRazedCitiesFilename(), getTowersFilename(), getRuinsFilename(),
+      getTemplesFilename()};
+  int nos[PICS] = 
+    {1, 1, MAX_PLAYERS + 1, MAX_PLAYERS, MAX_PLAYERS, RUIN_TYPES, 
+      TEMPLE_TYPES};
   int citysize = getTileSize() * d_city_tile_width;
-  if (cities_filename.empty() == false && !broken)
-    {
-      std::vector<PixMask* > pics;
-      pics = disassemble_row(cities_filename, MAX_PLAYERS + 1, broken);
-      if (!broken)
-        {
-          for (unsigned int i = 0; i < MAX_PLAYERS + 1; i++)
-            {
-              if (pics[i]->get_width() != citysize)
-                PixMask::scale(pics[i], citysize, citysize);
-              setCityImage(i, pics[i]);
-            }
-        }
-    }
-
-  if (razed_cities_filename.empty() == false && !broken)
-    {
-      std::vector<PixMask* > pics;
-      pics = disassemble_row(razed_cities_filename, MAX_PLAYERS, broken);
-      if (!broken)
-        {
-          for (unsigned int i = 0; i < MAX_PLAYERS; i++)
-            {
-              if (pics[i]->get_width() != citysize)
-                PixMask::scale(pics[i], citysize, citysize);
-              setRazedCityImage(i, pics[i]);
-            }
-        }
-    }
-
-  if (towers_filename.empty() == false && !broken)
+  int sizes[PICS] = 
+    {0, 0, citysize, citysize, (int)getTileSize(), 
+      (int)(getTileSize() * d_ruin_tile_width), 
+      (int)(getTileSize() * d_temple_tile_width)};
+  std::vector<DecodeJob> jobs;
+  int job[PICS];
+  for (int i = 0; i < PICS; i++)
     {
-      std::vector<PixMask* > pics = disassemble_row(towers_filename,
-                                                    MAX_PLAYERS, broken);
-      if (!broken)
+      job[i] = -1;
+      if (names[i].empty() == true || broken)
+        continue;
+      const std::string *data = t.getFileContents(names[i] + ".png");
+      if (!data)
         {
-          for (unsigned int i = 0; i < MAX_PLAYERS; i++)
-            {
-              if (pics[i]->get_width() != (int)getTileSize())
-                PixMask::scale(pics[i], getTileSize(), getTileSize());
-              setTowerImage(i, pics[i]);
-            }
-        }
-    }
-
-  if (ruins_filename.empty() == false && !broken)
-    {
-      std::vector<PixMask* > pics = disassemble_row(ruins_filename,
-                                                        RUIN_TYPES, broken);
-      if (!broken)
-        {
-          int ruinsize = getTileSize() * d_ruin_tile_width;
-          for (unsigned int i = 0; i < RUIN_TYPES ; i++)
-            {
-              if (pics[i]->get_width() != ruinsize)
-                PixMask::scale(pics[i], ruinsize, ruinsize);
-              setRuinImage(i, pics[i]);
-            }
+          broken = true;
+          continue;
         }
+      job[i] = jobs.size();
+      jobs.push_back(DecodeJob(data, nos[i], sizes[i], sizes[i]));
+      jobs.back().always_scale = false;
     }
+  if (!broken)
+    decode_rows(jobs);
 
-  if (temples_filename.empty() == false && !broken)
+  std::vector<PixMask*> pics[PICS];
+  for (int i = 0; i < PICS && !broken; i++)
+    if (job[i] >= 0)
+      {
+        pics[i] = to_pixmasks(jobs[job[i]]);
+        if (jobs[job[i]].broken)
+          broken = true;
+      }
+  t.Close();
+  if (broken)
     {
-      std::vector<PixMask* > pics;
-      pics = disassemble_row(temples_filename, TEMPLE_TYPES, broken);
-      if (!broken)
-        {
-          int templesize = getTileSize() * d_temple_tile_width;
-          for (unsigned int i = 0; i < TEMPLE_TYPES ; i++)
-            {
-              if (pics[i]->get_width() != templesize)
-                PixMask::scale(pics[i], templesize, templesize);
-              setTempleImage(i, pics[i]);
-            }
-        }
+      for (int i = 0; i < PICS; i++)
+        for (unsigned int j = 0; j < pics[i].size(); j++)
+          delete pics[i][j];
+      return;
     }
-}
 
-void Cityset::instantiateImages(bool &broken)
-{
-  debug("Loading images for cityset " << getName());
-  uninstantiateImages();
-  broken = false;
-  Tar_Helper t(getConfigurationFile(), std::ios::in, broken);
-  if (broken)
-    return;
-  Glib::ustring port_filename = "";
-  Glib::ustring signpost_filename = "";
-  Glib::ustring cities_filename = "";
-  Glib::ustring razed_cities_filename = "";
-  Glib::ustring towers_filename = "";
-  Glib::ustring ruins_filename = "";
-  Glib::ustring temples_filename = "";
-
-  if (getPortFilename().empty() == false && !broken)
-    port_filename = t.getFile(getPortFilename() + ".png", broken);
-  if (getSignpostFilename().empty() == false && !broken)
-    signpost_filename = t.getFile(getSignpostFilename() + ".png", broken);
-  if (getCitiesFilename().empty() == false && !broken)
-    cities_filename = t.getFile(getCitiesFilename() + ".png", broken);
-  if (getRazedCitiesFilename().empty() == false && !broken)
-    razed_cities_filename = t.getFile(getRazedCitiesFilename() + ".png", broken);
-  if (getTowersFilename().empty() == false && !broken)
-    towers_filename = t.getFile(getTowersFilename() + ".png", broken);
-  if (getRuinsFilename().empty() == false && !broken)
-    ruins_filename = t.getFile(getRuinsFilename() + ".png", broken);
-  if (getTemplesFilename().empty() == false && !broken)
-    temples_filename = t.getFile(getTemplesFilename() + ".png", broken);
-  if (!broken)
-    instantiateImages(port_filename, signpost_filename, cities_filename,
-                      razed_cities_filename, towers_filename, ruins_filename,
-                      temples_filename, broken);
-  if (port_filename != "")
-    File::erase(port_filename);
-  if (signpost_filename != "")
-    File::erase(signpost_filename);
-  if (cities_filename != "")
-    File::erase(cities_filename);
-  if (razed_cities_filename != "")
-    File::erase(razed_cities_filename);
-  if (towers_filename != "")
-    File::erase(towers_filename);
-  if (ruins_filename != "")
-    File::erase(ruins_filename);
-  if (temples_filename != "")
-    File::erase(temples_filename);
-  t.Close();
+  if (pics[PORT].empty() == false)
+    setPortImage(pics[PORT][0]);
+  if (pics[SIGNPOST].empty() == false)
+    setSignpostImage(pics[SIGNPOST][0]);
+  for (unsigned int i = 0; i < pics[CITIES].size(); i++)
+    setCityImage(i, pics[CITIES][i]);
+  for (unsigned int i = 0; i < pics[RAZED_CITIES].size(); i++)
+    setRazedCityImage(i, pics[RAZED_CITIES][i]);
+  for (unsigned int i = 0; i < pics[TOWERS].size(); i++)
+    setTowerImage(i, pics[TOWERS][i]);
+  for (unsigned int i = 0; i < pics[RUINS].size(); i++)
+    setRuinImage(i, pics[RUINS][i]);
+  for (unsigned int i = 0; i < pics[TEMPLES].size(); i++)
+    setTempleImage(i, pics[TEMPLES][i]);
 }
 
 bool Cityset::validate()
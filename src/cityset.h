@@ -118,14 +118,6 @@ class Cityset : public sigc::trackable, public Set
 	void getFilenames(std::list<Glib::ustring> &files);
 
 	void instantiateImages(bool &broken);
-	void instantiateImages(Glib::ustring port_filename,
-			       Glib::ustring signpost_filename,
-			       Glib::ustring cities_filename,
-			       Glib::ustring razed_cities_filename,
-			       Glib::ustring towers_filename,
-			       Glib::ustring ruins_filename,
-			       Glib::ustring temples_filename,
-                               bool &broken);
 	void uninstantiateImages();
 
         guint32 countEmptyImageNames() const;
@@ -0,0 +1,490 @@
+//  Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+#include <algorithm>
+
+#include "editor-journal.h"
+#include "GameMap.h"
+#include "stack.h"
+#include "stacktile.h"
+#include "player.h"
+#include "MapBackpack.h"
+#include "city.h"
+#include "ruin.h"
+#include "temple.h"
+#include "road.h"
+#include "bridge.h"
+#include "signpost.h"
+#include "port.h"
+#include "rewardlist.h"
+#include "reward.h"
+
+EditorJournal::EditorJournal()
+ : d_entry(NULL), d_pending(NULL)
+{
+  sync();
+}
+
+EditorJournal::~EditorJournal()
+{
+  clear();
+}
+
+void EditorJournal::sync()
+{
+  GameMap::getInstance()->takeChangedTerrain();
+  guint32 size = GameMap::getWidth() * GameMap::getHeight();
+  d_shadow.resize(size);
+  for (guint32 i = 0; i < size; i++)
+    d_shadow[i] = getState(i);
+}
+
+void EditorJournal::clear()
+{
+  if (d_pending)
+    {
+      deleteObjects(d_pending->before);
+      delete d_pending;
+      d_pending = NULL;
+    }
+  if (d_entry)
+    {
+      deleteEntry(d_entry);
+      d_entry = NULL;
+    }
+  for (auto e: d_undo)
+    deleteEntry(e);
+  d_undo.clear();
+  for (auto e: d_redo)
+    deleteEntry(e);
+  d_redo.clear();
+  sync();
+}
+
+EditorJournal::TileState EditorJournal::getState(guint32 offset) const
+{
+  Maptile *t = GameMap::getInstance()->getTile(offset % GameMap::getWidth(),
+                                               offset / GameMap::getWidth());
+  TileState state;
+  state.index = t->getIndex();
+  state.style = t->getTileStyle();
+  state.building = t->getBuilding();
+  return state;
+}
+
+void EditorJournal::setState(guint32 offset, const TileState &state)
+{
+  Maptile *t = GameMap::getInstance()->getTile(offset % GameMap::getWidth(),
+                                               offset / GameMap::getWidth());
+  t->setIndex(state.index);
+  t->setTileStyle(state.style);
+  t->setBuilding(state.building);
+}
+
+bool EditorJournal::same(const TileState &a, const TileState &b)
+{
+  return a.index == b.index && a.style == b.style && a.building == b.building;
+}
+
+static Rectangle clip_to_map(Rectangle r)
+{
+  int x1 = std::max(r.x, 0);
+  int y1 = std::max(r.y, 0);
+  int x2 = std::min(r.x + r.w, GameMap::getWidth());
+  int y2 = std::min(r.y + r.h, GameMap::getHeight());
+  if (x2 <= x1 || y2 <= y1)
+    return Rectangle(0, 0, 0, 0);
+  return Rectangle(x1, y1, x2 - x1, y2 - y1);
+}
+
+static Rectangle unite(Rectangle a, Rectangle b)
+{
+  if (a.w <= 0 || a.h <= 0)
+    return b;
+  if (b.w <= 0 || b.h <= 0)
+    return a;
+  int x1 = std::min(a.x, b.x);
+  int y1 = std::min(a.y, b.y);
+  int x2 = std::max(a.x + a.w, b.x + b.w);
+  int y2 = std::max(a.y + a.h, b.y + b.h);
+  return Rectangle(x1, y1, x2 - x1, y2 - y1);
+}
+
+Rectangle EditorJournal::grow(Rectangle region) const
+{
+  //take in the whole of any building that sticks out of the region.
+  region = clip_to_map(region);
+  Rectangle grown = region;
+  GameMap *gm = GameMap::getInstance();
+  for (int y = region.y; y < region.y + region.h; y++)
+    for (int x = region.x; x < region.x + region.w; x++)
+      {
+        Location *l = gm->getLocation(Vector<int>(x, y));
+        if (l)
+          grown = unite(grown, Rectangle(l->getPos(),
+                                         Vector<int>(l->getSize(),
+                                                     l->getSize())));
+      }
+  return clip_to_map(grown);
+}
+
+static Location *copy_location(Maptile::Building building, const Location *l)
+{
+  switch (building)
+    {
+    case Maptile::CITY: return new City(*static_cast<const City*>(l));
+    case Maptile::RUIN:
+        {
+          //the ruin deletes its reward, so our copy needs one of its own.
+          Ruin *r = new Ruin(*static_cast<const Ruin*>(l));
+          if (r->getReward())
+            r->setReward(Reward::copy(r->getReward()));
+          return r;
+        }
+    case Maptile::TEMPLE: return new Temple(*static_cast<const Temple*>(l));
+    case Maptile::ROAD: return new Road(*static_cast<const Road*>(l));
+    case Maptile::BRIDGE: return new Bridge(*static_cast<const Bridge*>(l));
+    case Maptile::SIGNPOST:
+      return new Signpost(*static_cast<const Signpost*>(l));
+    case Maptile::PORT: return new Port(*static_cast<const Port*>(l));
+    case Maptile::NONE: break;
+    }
+  return NULL;
+}
+
+void EditorJournal::copyObjects(Rectangle region, Objects &objects) const
+{
+  GameMap *gm = GameMap::getInstance();
+  for (int y = region.y; y < region.y + region.h; y++)
+    for (int x = region.x; x < region.x + region.w; x++)
+      {
+        Vector<int> pos(x, y);
+        Location *l = gm->getLocation(pos);
+        if (l && l->getPos() == pos)
+          {
+            Maptile::Building building = gm->getBuilding(pos);
+            objects.locations.push_back
+              (std::make_pair(building, copy_location(building, l)));
+            if (building == Maptile::RUIN)
+              for (auto r: *Rewardlist::getInstance())
+                if (r->getType() == Reward::RUIN &&
+                    static_cast<Reward_Ruin*>(r)->getRuin() == l)
+                  objects.rewards.push_back(Reward::copy(r));
+          }
+        StackTile *stile = gm->findStacks(pos);
+        if (stile)
+          for (auto s: stile->getStacks())
+            objects.stacks.push_back(new Stack(*s));
+        MapBackpack *b = gm->findBackpack(pos);
+        if (b && b->empty() == false)
+          objects.backpacks.push_back(new MapBackpack(*b));
+      }
+}
+
+bool EditorJournal::sameObjects(const Objects &a, const Objects &b) const
+{
+  if (a.locations.size() != b.locations.size() ||
+      a.stacks.size() != b.stacks.size() ||
+      a.backpacks.size() != b.backpacks.size() ||
+      a.rewards.size() != b.rewards.size())
+    return false;
+  for (auto i = a.locations.begin(), j = b.locations.begin();
+       i != a.locations.end(); i++, j++)
+    {
+      if ((*i).first != (*j).first ||
+          (*i).second->getId() != (*j).second->getId() ||
+          (*i).second->getPos() != (*j).second->getPos())
+        return false;
+      if ((*i).first == Maptile::ROAD &&
+          static_cast<Road*>((*i).second)->getType() !=
+          static_cast<Road*>((*j).second)->getType())
+        return false;
+    }
+  for (auto i = a.stacks.begin(), j = b.stacks.begin();
+       i != a.stacks.end(); i++, j++)
+    if ((*i)->getId() != (*j)->getId() || (*i)->getPos() != (*j)->getPos() ||
+        (*i)->size() != (*j)->size() || (*i)->getOwner() != (*j)->getOwner())
+      return false;
+  for (auto i = a.backpacks.begin(), j = b.backpacks.begin();
+       i != a.backpacks.end(); i++, j++)
+    if ((*i)->getPos() != (*j)->getPos() || (*i)->size() != (*j)->size())
+      return false;
+  return true;
+}
+
+void EditorJournal::removeObjects(Rectangle region)
+{
+  GameMap *gm = GameMap::getInstance();
+  for (int y = region.y; y < region.y + region.h; y++)
+    for (int x = region.x; x < region.x + region.w; x++)
+      {
+        Vector<int> pos(x, y);
+        while (GameMap::getStack(pos) != NULL)
+          gm->removeStack(GameMap::getStack(pos));
+        Ruin *ruin = GameMap::getRuin(pos);
+        if (ruin)
+          {
+            //don't leave any rewards pointing at the ruin we're deleting.
+            Rewardlist *rl = Rewardlist::getInstance();
+            for (Rewardlist::iterator it = rl->begin(); it != rl->end();)
+              {
+                Reward *r = *it;
+                it++;
+                if (r->getType() == Reward::RUIN &&
+                    static_cast<Reward_Ruin*>(r)->getRuin() == ruin)
+                  rl->remove(r);
+              }
+          }
+        gm->removeLocation(pos);
+        if (gm->findBackpack(pos))
+          gm->setBackpack(pos, NULL);
+      }
+}
+
+void EditorJournal::putObjects(Rectangle region, const Objects &objects)
+{
+  removeObjects(region);
+  GameMap *gm = GameMap::getInstance();
+  for (auto i: objects.locations)
+    {
+      Location *l = copy_location(i.first, i.second);
+      switch (i.first)
+        {
+        case Maptile::CITY: gm->putCity(static_cast<City*>(l), true); break;
+        case Maptile::RUIN: gm->putRuin(static_cast<Ruin*>(l)); break;
+        case Maptile::TEMPLE: gm->putTemple(static_cast<Temple*>(l)); break;
+        case Maptile::ROAD: gm->putRoad(static_cast<Road*>(l), false); break;
+        case Maptile::BRIDGE: gm->putBridge(static_cast<Bridge*>(l)); break;
+        case Maptile::SIGNPOST:
+          gm->putSignpost(static_cast<Signpost*>(l));
+          break;
+        case Maptile::PORT: gm->putPort(static_cast<Port*>(l)); break;
+        case Maptile::NONE: delete l; break;
+        }
+    }
+  for (auto i: objects.stacks)
+    {
+      //putStack would give the stack to the active player.
+      Stack *s = new Stack(*i);
+      s->getOwner()->addStack(s);
+      GameMap::getStacks(s->getPos())->add(s);
+    }
+  for (auto i: objects.backpacks)
+    gm->setBackpack(i->getPos(), new MapBackpack(*i));
+  for (auto i: objects.rewards)
+    Rewardlist::getInstance()->push_back(Reward::copy(i));
+}
+
+void EditorJournal::deleteObjects(Objects &objects)
+{
+  for (auto i: objects.locations)
+    delete i.second;
+  objects.locations.clear();
+  for (auto i: objects.stacks)
+    delete i;
+  objects.stacks.clear();
+  for (auto i: objects.backpacks)
+    delete i;
+  objects.backpacks.clear();
+  for (auto i: objects.rewards)
+    delete i;
+  objects.rewards.clear();
+}
+
+void EditorJournal::deleteEntry(Entry *entry)
+{
+  for (auto &i: entry->objects)
+    {
+      deleteObjects(i.before);
+      deleteObjects(i.after);
+    }
+  delete entry;
+}
+
+void EditorJournal::begin()
+{
+  if (d_entry)
+    end();
+  d_entry = new Entry();
+  d_entry_tiles.clear();
+}
+
+Rectangle EditorJournal::record(Rectangle region)
+{
+  if (!d_entry)
+    return grow(region);
+  if (d_pending)
+    commit(d_pending->region);
+  d_pending = new ObjectDelta();
+  d_pending->region = grow(region);
+  copyObjects(d_pending->region, d_pending->before);
+  return d_pending->region;
+}
+
+void EditorJournal::commit(Rectangle changed)
+{
+  if (!d_entry)
+    {
+      //a change that isn't going in the history.
+      sync();
+      return;
+    }
+
+  if (d_pending)
+    {
+      copyObjects(d_pending->region, d_pending->after);
+      if (sameObjects(d_pending->before, d_pending->after))
+        {
+          deleteObjects(d_pending->before);
+          deleteObjects(d_pending->after);
+        }
+      else
+        d_entry->objects.push_back(*d_pending);
+      delete d_pending;
+      d_pending = NULL;
+    }
+
+  //the terrain under new buildings gets changed and smoothed too.
+  Rectangle r = changed;
+  Rectangle terrain = GameMap::getInstance()->takeChangedTerrain();
+  if (r.w <= 0 || r.h <= 0)
+    r = Rectangle(0, 0, GameMap::getWidth(), GameMap::getHeight());
+  else
+    r = unite(r, terrain);
+  r = clip_to_map(r);
+  for (int y = r.y; y < r.y + r.h; y++)
+    for (int x = r.x; x < r.x + r.w; x++)
+      {
+        guint32 offset = y * GameMap::getWidth() + x;
+        TileState now = getState(offset);
+        TileState &then = d_shadow[offset];
+        if (same(now, then))
+          continue;
+        auto it = d_entry_tiles.find(offset);
+        if (it == d_entry_tiles.end())
+          {
+            d_entry_tiles[offset] = d_entry->tiles.size();
+            TileDelta delta;
+            delta.offset = offset;
+            delta.before = then;
+            delta.after = now;
+            d_entry->tiles.push_back(delta);
+          }
+        else
+          d_entry->tiles[(*it).second].after = now;
+        then = now;
+      }
+}
+
+void EditorJournal::end()
+{
+  if (!d_entry)
+    return;
+  if (d_pending)
+    commit(d_pending->region);
+
+  //drop the tiles that got changed back again.
+  std::vector<TileDelta> tiles;
+  for (auto &i: d_entry->tiles)
+    if (!same(i.before, i.after))
+      tiles.push_back(i);
+  d_entry->tiles.swap(tiles);
+  d_entry_tiles.clear();
+
+  Entry *entry = d_entry;
+  d_entry = NULL;
+  if (entry->tiles.empty() && entry->objects.empty())
+    {
+      deleteEntry(entry);
+      return;
+    }
+
+  d_undo.push_back(entry);
+  for (auto e: d_redo)
+    deleteEntry(e);
+  d_redo.clear();
+  while (d_undo.size() > MAX_ENTRIES)
+    {
+      deleteEntry(d_undo.front());
+      d_undo.pop_front();
+    }
+}
+
+Rectangle EditorJournal::apply(Entry *entry, bool undoing)
+{
+  Rectangle changed(0, 0, 0, 0);
+  if (undoing)
+    for (auto i = entry->objects.rbegin(); i != entry->objects.rend(); i++)
+      {
+        putObjects((*i).region, (*i).before);
+        changed = unite(changed, (*i).region);
+      }
+  else
+    for (auto i = entry->objects.begin(); i != entry->objects.end(); i++)
+      {
+        putObjects((*i).region, (*i).after);
+        changed = unite(changed, (*i).region);
+      }
+
+  guint32 width = GameMap::getWidth();
+  for (auto &i: entry->tiles)
+    {
+      setState(i.offset, undoing ? i.before : i.after);
+      changed = unite(changed, Rectangle(i.offset % width, i.offset / width,
+                                         1, 1));
+    }
+
+  //putting the buildings back can touch the tiles around them.
+  GameMap *gm = GameMap::getInstance();
+  Rectangle around = clip_to_map(Rectangle(changed.x - 1, changed.y - 1,
+                                           changed.w + 2, changed.h + 2));
+  for (int y = around.y; y < around.y + around.h; y++)
+    for (int x = around.x; x < around.x + around.w; x++)
+      {
+        gm->calculateBlockedAvenue(x, y);
+        d_shadow[y * width + x] = getState(y * width + x);
+      }
+  return around;
+}
+
+Rectangle EditorJournal::undo()
+{
+  if (d_entry)
+    end();
+  if (d_undo.empty())
+    return Rectangle(0, 0, 0, 0);
+  Entry *entry = d_undo.back();
+  d_undo.pop_back();
+  Rectangle changed = apply(entry, true);
+  d_redo.push_back(entry);
+  return changed;
+}
+
+Rectangle EditorJournal::redo()
+{
+  if (d_entry)
+    end();
+  if (d_redo.empty())
+    return Rectangle(0, 0, 0, 0);
+  Entry *entry = d_redo.back();
+  d_redo.pop_back();
+  Rectangle changed = apply(entry, false);
+  d_undo.push_back(entry);
+  return changed;
+}
+
+// End of file
@@ -0,0 +1,176 @@
+//  Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+#pragma once
+#ifndef EDITOR_JOURNAL_H
+#define EDITOR_JOURNAL_H
+
+#include <gtkmm.h>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "rectangle.h"
+#include "maptile.h"
+
+class Location;
+class Stack;
+class MapBackpack;
+class TileStyle;
+class Reward;
+
+//! The undo and redo history of the changes made to the map in the editor.
+/**
+ * Each entry in the journal holds what the changed tiles were before and
+ * after the change: the terrain, the tile style and the building.  Only the
+ * tiles that actually changed are kept, so an entry costs memory in
+ * proportion to the edit rather than to the map.
+ *
+ * To find the tiles that changed, the journal keeps its own copy of the
+ * terrain, styles and buildings of every tile, and compares it with the map
+ * after each change.  Putting an entry back writes the tiles directly, so
+ * nothing gets re-styled or smoothed.
+ *
+ * Cities, ruins and the other buildings, stacks and bags of items are
+ * copied out of the region around the change beforehand, and out of it
+ * again afterwards.  The rewards that point at a ruin go along with it.
+ */
+class EditorJournal
+{
+    public:
+
+        //! The most entries that are kept around for undoing.
+        static const guint32 MAX_ENTRIES = 100;
+
+        //! Make a new, empty journal of the map as it is now.
+        EditorJournal();
+
+        //! Destructor.
+        ~EditorJournal();
+
+        //! Start a new entry.  Changes until end() are undone all at once.
+        void begin();
+
+        //! Copy the buildings, stacks and bags in a region before changing it.
+        /**
+         * @return The region that got copied, which takes in the whole of
+         *         any building that sticks out of the given one.
+         */
+        Rectangle record(Rectangle region);
+
+        //! Note the changes made to the map since the call to record().
+        /**
+         * @param changed  The tiles that may have changed, or an empty
+         *                 rectangle to look over the whole map.  Whatever
+         *                 GameMap::putTerrain altered is looked over too.
+         */
+        void commit(Rectangle changed);
+
+        //! Finish the entry started by begin().
+        void end();
+
+        //! Forget the whole history, and take the map as it is now.
+        void clear();
+
+        //! Take the map as it is now, without touching the history.
+        void sync();
+
+        bool canUndo() const {return !d_undo.empty();};
+        bool canRedo() const {return !d_redo.empty();};
+
+        //! Put the map back to how it was before the last entry.
+        /**
+         * @return The tiles that got changed.
+         */
+        Rectangle undo();
+
+        //! Put the map back to how it was after the last undone entry.
+        Rectangle redo();
+
+    private:
+
+        //! The things we keep about a tile.
+        struct TileState
+          {
+            guint32 index;
+            TileStyle *style;
+            Maptile::Building building;
+          };
+
+        //! A tile before and after a change.
+        struct TileDelta
+          {
+            guint32 offset;
+            TileState before;
+            TileState after;
+          };
+
+        //! The objects in a region of the map at one time.
+        struct Objects
+          {
+            std::list<std::pair<Maptile::Building, Location*> > locations;
+            std::list<Stack*> stacks;
+            std::list<MapBackpack*> backpacks;
+            //! The rewards in the Rewardlist that point at the ruins.
+            std::list<Reward*> rewards;
+          };
+
+        //! The objects in a region of the map before and after a change.
+        struct ObjectDelta
+          {
+            Rectangle region;
+            Objects before;
+            Objects after;
+          };
+
+        struct Entry
+          {
+            std::vector<TileDelta> tiles;
+            std::list<ObjectDelta> objects;
+          };
+
+        static bool same(const TileState &a, const TileState &b);
+        TileState getState(guint32 offset) const;
+        void setState(guint32 offset, const TileState &state);
+        Rectangle grow(Rectangle region) const;
+        void copyObjects(Rectangle region, Objects &objects) const;
+        bool sameObjects(const Objects &a, const Objects &b) const;
+        void putObjects(Rectangle region, const Objects &objects);
+        void removeObjects(Rectangle region);
+        void deleteObjects(Objects &objects);
+        void deleteEntry(Entry *entry);
+        Rectangle apply(Entry *entry, bool undoing);
+
+        //! The map as of the last change we know about.
+        std::vector<TileState> d_shadow;
+
+        //! The entry being built between begin() and end().
+        Entry *d_entry;
+
+        //! What record() copied, waiting for commit().
+        ObjectDelta *d_pending;
+
+        //! Where the tiles of the entry being built are in its tile list.
+        std::map<guint32, size_t> d_entry_tiles;
+
+        std::list<Entry*> d_undo;
+        std::list<Entry*> d_redo;
+};
+
+#endif // EDITOR_JOURNAL_H
+
+// End of file
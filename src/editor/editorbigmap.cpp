@@ -19,6 +19,7 @@
 #include <config.h>
 
 #include <assert.h>
+#include <algorithm>
 
 #include "editorbigmap.h"
 
@@ -99,14 +100,22 @@ void EditorBigMap::mouse_button_event(MouseButtonEvent e)
   if (e.button == MouseButtonEvent::LEFT_BUTTON
       && e.state == MouseButtonEvent::PRESSED &&
       mouse_state == NONE)
-    change_map_under_cursor();
+    {
+      //everything drawn until the button comes up is undone all at once.
+      journal.begin();
+      change_map_under_cursor();
+    }
   else if (e.button == MouseButtonEvent::LEFT_BUTTON &&
            e.state == MouseButtonEvent::RELEASED &&
            mouse_state == MOVE_DRAGGING && pointer == MOVE)
     {
       mouse_state = NONE;
       change_map_under_cursor();
+      end_change();
     }
+  else if (e.button == MouseButtonEvent::LEFT_BUTTON &&
+           e.state == MouseButtonEvent::RELEASED)
+    end_change();
   else if (e.button == MouseButtonEvent::RIGHT_BUTTON
            && e.state == MouseButtonEvent::PRESSED)
     bring_up_details();
@@ -291,7 +300,42 @@ void EditorBigMap::change_map_under_cursor()
     return;
   Vector<int> tile = tiles.front();
   Rectangle changed_tiles(tile, Vector<int>(-1, -1));
+  Rectangle recorded(0, 0, 0, 0);
   Maptile* maptile = GameMap::getInstance()->getTile(tile);
+
+  // copy out the buildings, stacks and bags that might get changed.
+  switch (pointer)
+    {
+    case POINTER:
+    case TERRAIN:
+    case BAG:
+      break;
+    case MOVE:
+      if (moving_objects_from != Vector<int>(-1,-1) &&
+          mouse_state != MOVE_DRAGGING)
+        {
+          Vector<int> from = moving_objects_from;
+          int size = std::max(GameMap::getInstance()->getBuildingSize(from),
+                              guint32(1));
+          Vector<int> top_left(std::min(from.x, tile.x),
+                               std::min(from.y, tile.y));
+          Vector<int> bottom_right(std::max(from.x, tile.x) + size,
+                                   std::max(from.y, tile.y) + size);
+          recorded = journal.record(Rectangle(top_left,
+                                              bottom_right - top_left));
+        }
+      break;
+    case ERASE:
+      recorded = journal.record(Rectangle(tile, Vector<int>(1, 1)));
+      break;
+    default:
+      // new buildings go down at the tile, and roads and bridges change
+      // the roads around them.
+      recorded = journal.record(Rectangle(tile - Vector<int>(1, 1),
+                                          Vector<int>(4, 4)));
+      break;
+    }
+
   switch (pointer)
     {
     case POINTER:
@@ -308,9 +352,10 @@ void EditorBigMap::change_map_under_cursor()
     case MOVE:
       if (moving_objects_from == Vector<int>(-1,-1))
         {
+          MapBackpack *bag = GameMap::getInstance()->findBackpack(tile);
           if (GameMap::getInstance()->getBuilding(tile) != Maptile::NONE ||
               GameMap::getStack(tile) != NULL ||
-              GameMap::getBackpack(tile)->empty() == false)
+              (bag && bag->empty() == false))
             moving_objects_from = tile;
         }
       else
@@ -348,7 +393,8 @@ void EditorBigMap::change_map_under_cursor()
                     }
                 }
             }
-          else if (gm->getBackpack(from)->empty() == false)
+          else if (gm->findBackpack(from) &&
+                   gm->findBackpack(from)->empty() == false)
             gm->moveBackpack(from, tile);
           else if (gm->getBuilding(from) != Maptile::NONE)
             {
@@ -533,12 +579,56 @@ void EditorBigMap::change_map_under_cursor()
 
     }
 
+  // only look over the tiles we touched, this happens on every motion event.
+  if (pointer == TERRAIN)
+    journal.commit(changed_tiles);
+  else if (recorded.w > 0 && recorded.h > 0)
+    journal.commit(recorded);
+
   if (changed_tiles.w > 0 && changed_tiles.h > 0)
     map_tiles_changed.emit(changed_tiles);
 
   draw();
 }
 
+void EditorBigMap::end_change()
+{
+  bool could_undo = journal.canUndo(), could_redo = journal.canRedo();
+  journal.end();
+  if (could_undo != journal.canUndo() || could_redo != journal.canRedo())
+    history_changed.emit();
+}
+
+void EditorBigMap::undo()
+{
+  Rectangle changed = journal.undo();
+  if (changed.w > 0 && changed.h > 0)
+    {
+      map_tiles_changed.emit(changed);
+      map_water_changed.emit();
+    }
+  history_changed.emit();
+  draw();
+}
+
+void EditorBigMap::redo()
+{
+  Rectangle changed = journal.redo();
+  if (changed.w > 0 && changed.h > 0)
+    {
+      map_tiles_changed.emit(changed);
+      map_water_changed.emit();
+    }
+  history_changed.emit();
+  draw();
+}
+
+void EditorBigMap::forget_history()
+{
+  journal.clear();
+  history_changed.emit();
+}
+
 void EditorBigMap::bring_up_details()
 {
   Vector<int> tile = mouse_pos_to_tile(mouse_pos);
@@ -556,8 +646,8 @@ void EditorBigMap::bring_up_details()
     seq.push_back(t);
   if (Road* rd = GameMap::getRoad(tile))
     seq.push_back(rd);
-  MapBackpack *b = GameMap::getInstance()->getTile(tile)->getBackpack();
-  if (b->empty() == false)
+  MapBackpack *b = GameMap::getInstance()->findBackpack(tile);
+  if (b && b->empty() == false)
     seq.push_back(b);
 
   if (!seq.empty())
@@ -566,11 +656,21 @@ void EditorBigMap::bring_up_details()
 
 void EditorBigMap::smooth_view()
 {
+  journal.begin();
+  // the styles get applied with x and y the other way around, and the
+  // smoothing reaches a tile past the edge.
+  int lo = std::min(view.x, view.y) - 1;
+  int hi = std::max(view.x + view.w, view.y + view.h) + 1;
+  // the roads all get their types worked out again, so they go in the
+  // same entry as the smoothing.
+  journal.record(Rectangle(0, 0, GameMap::getWidth(), GameMap::getHeight()));
   GameMap::getInstance()->applyTileStyles(view.y, view.x, view.y+view.h, 
 					  view.x+view.w, true);
   Roadlist::iterator i = Roadlist::getInstance()->begin();
   for (; i != Roadlist::getInstance()->end(); i++)
     (*i)->setType(CreateScenario::calculateRoadType((*i)->getPos()));
+  journal.commit(Rectangle(lo, lo, hi - lo, hi - lo));
+  end_change();
   draw();
 }
 
@@ -696,7 +796,8 @@ void EditorBigMap::after_draw()
                         pic->blit(buffer, pos);
                       }
                   }
-                else if (gm->getBackpack(from)->empty() == false)
+                else if (gm->findBackpack(from) &&
+                         gm->findBackpack(from)->empty() == false)
                   {
                     pic = ImageCache::getInstance()->getBagPic();
                     pic->blit(buffer, pos);
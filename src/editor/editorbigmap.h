@@ -30,6 +30,7 @@
 #include "bigmap.h"
 #include "Tile.h"
 #include "UniquelyIdentified.h"
+#include "editor-journal.h"
 
 //! Scenario editor.  Specializatoin of the BigMap class for the editor.
 class EditorBigMap: public BigMap
@@ -78,6 +79,18 @@ class EditorBigMap: public BigMap
 
     void smooth_view();
 
+    // take back the last change made to the map, or make it again
+    void undo();
+    void redo();
+    bool can_undo() const {return journal.canUndo();}
+    bool can_redo() const {return journal.canRedo();}
+
+    // forget the changes, after the map was changed behind our back
+    void forget_history();
+
+    // emitted when a change can be undone or redone where it couldn't before
+    sigc::signal<void> history_changed;
+
  private:
     Vector<int> prev_mouse_pos, mouse_pos;
 
@@ -87,6 +100,8 @@ class EditorBigMap: public BigMap
     int pointer_tile_style_id;
     //! moving sets if we're moving objects on the map via the move button
     Vector<int> moving_objects_from;
+    //! the undo and redo history of the changes to the map
+    EditorJournal journal;
 
     enum {
 	NONE, DRAGGING, MOVE_DRAGGING
@@ -96,6 +111,7 @@ class EditorBigMap: public BigMap
     int tile_to_road_type(Vector<int> tile);
     int tile_to_bridge_type(Vector<int> tile);
     void change_map_under_cursor();
+    void end_change();
     std::vector<Vector<int> > get_cursor_tiles();
     Rectangle get_cursor_rectangle();
     std::vector<Vector<int> > get_screen_tiles();
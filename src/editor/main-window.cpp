@@ -210,6 +210,10 @@ MainWindow::MainWindow(Glib::ustring load_filename)
     xml->get_widget("quit_menuitem", quit_menuitem);
     quit_menuitem->signal_activate().connect(method(on_quit_activated));
 
+    xml->get_widget("undo_menuitem", undo_menuitem);
+    undo_menuitem->signal_activate().connect (method(on_undo_activated));
+    xml->get_widget("redo_menuitem", redo_menuitem);
+    redo_menuitem->signal_activate().connect (method(on_redo_activated));
     xml->get_widget("edit_players_menuitem", edit_players_menuitem);
     edit_players_menuitem->signal_activate().connect
       (method(on_edit_players_activated));
@@ -906,6 +910,34 @@ void MainWindow::on_quit_activated()
   quit();
 }
 
+void MainWindow::on_undo_activated()
+{
+  if (!bigmap)
+    return;
+  bigmap->undo();
+  if (smallmap)
+    smallmap->draw();
+  needs_saving = true;
+  update_window_title();
+}
+
+void MainWindow::on_redo_activated()
+{
+  if (!bigmap)
+    return;
+  bigmap->redo();
+  if (smallmap)
+    smallmap->draw();
+  needs_saving = true;
+  update_window_title();
+}
+
+void MainWindow::on_history_changed()
+{
+  undo_menuitem->set_sensitive(bigmap && bigmap->can_undo());
+  redo_menuitem->set_sensitive(bigmap && bigmap->can_redo());
+}
+
 void MainWindow::on_edit_players_activated()
 {
     PlayersDialog d(*window, d_create_scenario_names, d_width, d_height);
@@ -913,6 +945,8 @@ void MainWindow::on_edit_players_activated()
     int response = d.run();
     if (response == Gtk::RESPONSE_ACCEPT)
       {
+        //the stacks we copied might belong to players that are gone.
+        bigmap->forget_history();
 	if (Playerlist::getInstance()->getPlayer(active->getId()))
 	  Playerlist::getInstance()->setActiveplayer(active);
 	needs_saving = true;
@@ -983,6 +1017,7 @@ void MainWindow::on_armyset_saved(guint32 id)
       //but then the armyset* gets changed and the switch has no effect.
       Armysetlist::getInstance()->reload(id);
       GameMap::getInstance()->switchArmysets(Armysetlist::getInstance()->get(id));
+      bigmap->forget_history();
       bigmap->screen_size_changed(bigmap_image->get_allocation()); 
       redraw();
       needs_saving = true;
@@ -1009,6 +1044,7 @@ void MainWindow::on_cityset_saved(guint32 id)
     {
       ImageCache::getInstance()->reset();
       GameMap::getInstance()->reloadCityset();
+      bigmap->forget_history();
       bigmap->screen_size_changed(bigmap_image->get_allocation()); 
       redraw();
       needs_saving = true;
@@ -1026,7 +1062,10 @@ void MainWindow::on_edit_smallmap_activated()
   smallmap->resize();
   redraw();
   if (changed)
-    needs_saving = true;
+    {
+      needs_saving = true;
+      bigmap->forget_history();
+    }
   update_window_title();
 }
 
@@ -1050,6 +1089,7 @@ void MainWindow::on_tileset_saved(guint32 id)
       ImageCache::getInstance()->reset();
       Tilesetlist::getInstance()->reload(id);
       GameMap::getInstance()->switchTileset(Tilesetlist::getInstance()->get(id));
+      bigmap->forget_history();
       smallmap->resize();
       bigmap->screen_size_changed(bigmap_image->get_allocation()); 
       setup_terrain_radiobuttons();
@@ -1300,6 +1340,8 @@ void MainWindow::init_maps()
     bigmap->map_changed.connect(method(on_bigmap_changed));
     bigmap->map_water_changed.connect (method(on_smallmap_water_changed));
     bigmap->bag_selected.connect (method(on_bag_selected));
+    bigmap->history_changed.connect (method(on_history_changed));
+    on_history_changed();
                                        
 
     // grid is on by default
@@ -1454,6 +1496,7 @@ void MainWindow::on_smooth_map_activated()
 {
   GameMap::getInstance()->applyTileStyles(0, 0, GameMap::getHeight(), 
 					  GameMap::getWidth(), true);
+  bigmap->forget_history();
   redraw();
   needs_saving = true;
 }
@@ -1742,6 +1785,7 @@ void MainWindow::on_switch_sets_activated()
       needs_saving = true;
       update_window_title();
       ImageCache::getInstance()->reset();
+      bigmap->forget_history();
       bigmap->screen_size_changed(bigmap_image->get_allocation()); 
       smallmap->resize();
       if (d.get_tileset_changed())
@@ -1827,9 +1871,10 @@ int MainWindow::get_pointer_index()
 void MainWindow::on_bag_selected(Vector<int> tile)
 {
   MapBackpack *bag = 
-    GameMap::getInstance()->getTile(tile)->getBackpack();
+    GameMap::getBackpack(tile);
   BackpackEditorDialog d(*window, dynamic_cast<Backpack*>(bag));
   d.run();
+  GameMap::releaseBackpack(tile);
 }
 
 void MainWindow::on_remove_all_stacks_activated()
@@ -1861,6 +1906,7 @@ void MainWindow::on_remove_all_stacks_activated()
     {
       for (auto p: *Playerlist::getInstance())
         p->clearStacklist();
+      bigmap->forget_history();
       redraw();
       needs_saving = true;
     }
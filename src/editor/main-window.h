@@ -73,6 +73,8 @@ class MainWindow: public sigc::trackable
     Gtk::MenuItem *import_map_from_sav_menuitem;
     Gtk::MenuItem *validate_menuitem;
     Gtk::MenuItem *quit_menuitem;
+    Gtk::MenuItem *undo_menuitem;
+    Gtk::MenuItem *redo_menuitem;
     Gtk::MenuItem *edit_players_menuitem;
     Gtk::MenuItem *edit_map_info_menuitem;
     Gtk::MenuItem *edit_shieldset_menuitem;
@@ -130,6 +132,9 @@ class MainWindow: public sigc::trackable
     void on_quit_activated();
     bool quit();
     void on_edit_map_info_activated();
+    void on_undo_activated();
+    void on_redo_activated();
+    void on_history_changed();
     void on_edit_players_activated();
     void on_edit_shieldset_activated();
     void on_shieldset_saved(guint32 id);
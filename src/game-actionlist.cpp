@@ -17,9 +17,13 @@
 
 #include <sigc++/functors/mem_fun.h>
 
+#include <sstream>
+
 #include "game-actionlist.h"
 #include "network-action.h"
 #include "xmlhelper.h"
+#include "playerlist.h"
+#include "File.h"
 
 Glib::ustring GameActionlist::d_tag = "turnlist";
 //#define debug(x) {std::cerr<<__FILE__<<": "<<__LINE__<<": "<<x<<std::endl<<std::flush;}
@@ -61,6 +65,10 @@ GameActionlist::~GameActionlist()
   for (GameActionlist::iterator it = begin(); it != end(); it++)
     delete *it;
   clear();
+  if (d_log.is_open())
+    d_log.close();
+  if (d_log_filename.empty() == false)
+    File::erase(d_log_filename);
 }
 
 GameActionlist::GameActionlist(XML_Helper* helper)
@@ -74,6 +82,10 @@ bool GameActionlist::save(XML_Helper* helper) const
 
     retval &= helper->openTag(GameActionlist::d_tag);
 
+    //the turns in the log are already saved, so they go in as they are.
+    for (guint32 i = 0; i < d_log_index.size(); i++)
+      retval &= helper->saveRaw(readLog(i));
+
     for (GameActionlist::const_iterator it = begin(); it != end(); it++)
       retval &= (*it)->save(helper);
     
@@ -86,8 +98,9 @@ bool GameActionlist::load(Glib::ustring tag, XML_Helper* helper)
 {
   if (tag == TurnActionlist::d_tag)
     {
+      //the newest turn is still loading, but the older ones are done.
       TurnActionlist *t = new TurnActionlist(helper);
-      push_back(t);
+      add(t);
       return true;
     }
 
@@ -97,4 +110,80 @@ bool GameActionlist::load(Glib::ustring tag, XML_Helper* helper)
 void GameActionlist::add(TurnActionlist *t)
 {
   push_back(t);
+  if (size() > TURNS_IN_MEMORY)
+    pageOut();
+}
+
+void GameActionlist::pageOut()
+{
+  if (d_log.is_open() == false)
+    {
+      d_log_filename = File::get_tmp_file();
+      d_log.open(d_log_filename.c_str(), std::ios::in | std::ios::out |
+                 std::ios::trunc | std::ios::binary);
+      if (d_log.is_open() == false)
+        {
+          d_log_filename = "";
+          return;
+        }
+    }
+  while (size() > TURNS_IN_MEMORY)
+    {
+      std::ostringstream os;
+      XML_Helper helper(&os);
+      TurnActionlist *t = front();
+      if (t->save(&helper) == false)
+        return;
+      helper.close();
+      std::string xml = os.str();
+      d_log.seekp(0, std::ios::end);
+      std::streamoff offset = d_log.tellp();
+      d_log.write(xml.data(), xml.size());
+      if (!d_log)
+        {
+          d_log.clear();
+          return;
+        }
+      d_log_index.push_back(std::make_pair(offset, xml.size()));
+      pop_front();
+      delete t;
+    }
+  d_log.flush();
+}
+
+std::string GameActionlist::readLog(guint32 turn) const
+{
+  std::string xml(d_log_index[turn].second, '\0');
+  d_log.seekg(d_log_index[turn].first);
+  d_log.read(&xml[0], xml.size());
+  d_log.clear();
+  return xml;
+}
+
+TurnActionlist *GameActionlist::getTurn(guint32 turn) const
+{
+  if (turn >= d_log_index.size())
+    {
+      turn -= d_log_index.size();
+      if (turn >= size())
+        return NULL;
+      const_iterator it = begin();
+      std::advance(it, turn);
+      Player *p = Playerlist::getInstance()->getPlayer((*it)->getOwnerId());
+      return new TurnActionlist(p, **it);
+    }
+
+  //load the turn back in the same way as from a saved-game file.
+  std::istringstream is(readLog(turn));
+  XML_Helper helper(&is);
+  GameActionlist list;
+  helper.registerTag(TurnActionlist::d_tag,
+                     sigc::mem_fun(&list, &GameActionlist::load));
+  bool broken = !helper.parseXML();
+  helper.close();
+  if (broken || list.empty())
+    return NULL;
+  TurnActionlist *t = list.front();
+  list.pop_front();
+  return t;
 }
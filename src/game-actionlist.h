@@ -21,6 +21,9 @@
 
 #include <gtkmm.h>
 #include <list>
+#include <vector>
+#include <fstream>
+#include "defs.h"
 #include "turn-actionlist.h"
 #include <sigc++/trackable.h>
 
@@ -35,6 +38,10 @@ class Action;
  * turnactionlist.
  * This object is equivalent to a <turnlist> object in the saved-game file.
  *
+ * Only the most recent turns are kept in memory.  Older ones are appended
+ * to a log file as soon as they fall out of that window, and are read back
+ * one at a time when they're asked for or saved.
+ *
  * Implemented as a singleton.
  */
 class GameActionlist : public std::list<TurnActionlist*>, public sigc::trackable
@@ -43,6 +50,9 @@ class GameActionlist : public std::list<TurnActionlist*>, public sigc::trackable
 	//! The xml tag of this object in a saved-game file.
 	static Glib::ustring d_tag; 
 
+        //! The number of turns that are kept in memory.
+        static const guint32 TURNS_IN_MEMORY = MAX_PLAYERS;
+
         void add(TurnActionlist *t);
 
 	// Methods that operate on the class data but do not modify the class.
@@ -50,6 +60,18 @@ class GameActionlist : public std::list<TurnActionlist*>, public sigc::trackable
         //! Save the list of NetworkAction objects to a saved-game file.
         bool save(XML_Helper* helper) const;
 
+        //! Returns how many turns there are, including the ones in the log.
+        guint32 countTurns() const {return d_log_index.size() + size();};
+
+        //! Make a copy of one of the turns, whether or not it's in memory.
+        /**
+         * @param turn  The index of the turn, where 0 is the first one.
+         *
+         * @return The turn, which the caller must delete, or NULL if there
+         *         is no such turn.
+         */
+        TurnActionlist *getTurn(guint32 turn) const;
+
 	// Static Methods
 
         //! Gets the singleton instance or creates a new one.
@@ -85,8 +107,23 @@ class GameActionlist : public std::list<TurnActionlist*>, public sigc::trackable
         //! Callback for loading the GameActionlist from a saved-game file.
         bool load(Glib::ustring tag, XML_Helper* helper);
 
+        //! Move the oldest turns in memory out to the log.
+        void pageOut();
+
+        //! Read a turn from the log as it was saved.
+        std::string readLog(guint32 turn) const;
+
 	// DATA
 
+        //! The name of the file that turns are paged out to.
+        Glib::ustring d_log_filename;
+
+        //! The log file, opened when the first turn is paged out.
+        mutable std::fstream d_log;
+
+        //! Where each of the turns in the log starts, and how long it is.
+        std::vector<std::pair<std::streamoff, size_t> > d_log_index;
+
         //! A static pointer for the singleton instance.
         static GameActionlist * s_instance;
 };
@@ -29,6 +29,7 @@
 #include "xmlhelper.h"
 #include "GameScenario.h"
 #include "ucompose.hpp"
+#include "network-common.h"
 
 GameClientDecoder::GameClientDecoder()
 {
@@ -60,9 +61,15 @@ int GameClientDecoder::decodeActions(std::list<NetworkAction*> actions)
     if (action->getAction()->getType() == Action::PLAYER_RENAME)
       remote_player_named.emit(action->getOwner());
     else if (action->getAction()->getType() == Action::END_TURN)
-      remote_player_moved.emit((*actions.back()).getOwner());
+      {
+        d_stats.turnFinished(action->getOwnerId());
+        remote_player_moved.emit((*actions.back()).getOwner());
+      }
     else if (action->getAction()->getType() == Action::INIT_TURN)
-      remote_player_starts_move.emit((*actions.back()).getOwner());
+      {
+        d_stats.turnStarted(action->getOwnerId());
+        remote_player_starts_move.emit((*actions.back()).getOwner());
+      }
     count++;
   }
 
@@ -74,6 +81,7 @@ int GameClientDecoder::decodeActions(std::list<NetworkAction*> actions)
 
 void GameClientDecoder::gotActions(const Glib::ustring &payload)
 {
+  Glib::Timer timer;
   std::istringstream is(payload);
 
   ActionLoader loader;
@@ -85,6 +93,7 @@ void GameClientDecoder::gotActions(const Glib::ustring &payload)
   helper.close();
 
   decodeActions(loader.actions);
+  d_stats.decoded(MESSAGE_TYPE_SENDING_ACTIONS, timer.elapsed());
 }
 
 int GameClientDecoder::decodeHistories(std::list<NetworkHistory *> histories)
@@ -113,6 +122,7 @@ int GameClientDecoder::decodeHistories(std::list<NetworkHistory *> histories)
 
 void GameClientDecoder::gotHistories(const Glib::ustring &payload)
 {
+  Glib::Timer timer;
   std::istringstream is(payload);
 
   HistoryLoader loader;
@@ -124,4 +134,5 @@ void GameClientDecoder::gotHistories(const Glib::ustring &payload)
   helper.close();
 
   decodeHistories(loader.histories);
+  d_stats.decoded(MESSAGE_TYPE_SENDING_HISTORY, timer.elapsed());
 }
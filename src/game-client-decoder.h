@@ -30,6 +30,7 @@
 #include "xmlhelper.h"
 #include "network-action.h"
 #include "network-history.h"
+#include "network-stats.h"
 
 class Player;
 
@@ -46,6 +47,9 @@ public:
   sigc::signal<void, Player *> remote_player_named;
   sigc::signal<void, Player *> remote_player_died;
 
+  //! Where the time goes in this networked game.
+  const NetworkStats &getStats() const {return d_stats;};
+
 protected:
   class ActionLoader 
     {
@@ -99,6 +103,8 @@ protected:
   int decodeActions(std::list<NetworkAction*> actions);
   int decodeHistories(std::list<NetworkHistory*> histories);
 
+  NetworkStats d_stats;
+
 };
 
 #endif
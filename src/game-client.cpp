@@ -79,6 +79,7 @@ void GameClient::start(Glib::ustring host, guint32 port, Glib::ustring profile_i
   if (network_connection)
     network_connection->tear_down_connection();
   network_connection = ConnectionManager::create_connection();
+  network_connection->setStats(&d_stats);
   network_connection->torn_down.connect(
     sigc::mem_fun(this, &GameClient::on_torn_down));
   network_connection->connected.connect(
@@ -210,6 +211,7 @@ bool GameClient::onGotMessage(int type, Glib::ustring payload)
   case MESSAGE_TYPE_PARTICIPANT_CONNECT:
   case MESSAGE_TYPE_PARTICIPANT_DISCONNECT:
   case MESSAGE_TYPE_CHAT:
+  case MESSAGE_TYPE_REQUEST_STATS:
     //FIXME: faulty server.
     break;
 
@@ -243,6 +245,10 @@ bool GameClient::onGotMessage(int type, Glib::ustring payload)
     round_begins.emit();
     break;
 
+  case MESSAGE_TYPE_STATS:
+    received_stats.emit(payload);
+    break;
+
   case MESSAGE_TYPE_CHANGE_NICKNAME:
     nickname_changed.emit(d_nickname, payload);
     d_nickname = payload;
@@ -437,6 +443,11 @@ void GameClient::chat(Glib::ustring message)
   network_connection->send(MESSAGE_TYPE_CHAT, d_nickname + ":" + message);
 }
   
+void GameClient::request_stats()
+{
+  network_connection->send(MESSAGE_TYPE_REQUEST_STATS, "");
+}
+
 void GameClient::request_seat_manifest()
 {
   network_connection->send(MESSAGE_TYPE_REQUEST_SEAT_MANIFEST, "");
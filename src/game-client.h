@@ -50,6 +50,10 @@ public:
   void disconnect();
   void request_seat_manifest();
 
+  //! Ask the server how it's doing.  Only works for local connections.
+  void request_stats();
+  sigc::signal<void, Glib::ustring> received_stats;
+
   sigc::signal<void> client_connected;
   sigc::signal<void> client_disconnected; 
   sigc::signal<void> client_forcibly_disconnected; //server went away
@@ -114,6 +114,10 @@ public:
     bool random_turns;
     bool cities_can_produce_allies;
     int difficulty;
+    // how many seconds an EASY or HARD player may think about a turn.
+    // 0 means the player can take as long as it likes.
+    guint32 easy_ai_think_time = 0;
+    guint32 hard_ai_think_time = 0;
     Glib::ustring name;
   static GameParameters::Player::Type player_type_to_player_param(guint32 type)
     {
@@ -0,0 +1,267 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+#include <iterator>
+
+#include "game-replay.h"
+#include "GameScenario.h"
+#include "GameScenarioOptions.h"
+#include "game-actionlist.h"
+#include "turn-actionlist.h"
+#include "network_player.h"
+#include "playerlist.h"
+#include "citylist.h"
+#include "vectoredunitlist.h"
+#include "xmlhelper.h"
+#include "tarhelper.h"
+#include "FogMap.h"
+#include "File.h"
+#include "defs.h"
+
+GameReplay::GameReplay(Glib::ustring start_file, Glib::ustring log_file,
+                       bool &broken)
+ : d_game_scenario(NULL), d_turn(0), d_last_position(-1)
+{
+  broken = false;
+  Tar_Helper t(log_file, std::ios::in, broken);
+  if (broken)
+    return;
+  std::list<Glib::ustring> exts;
+  exts.push_back(SAVE_EXT);
+  Glib::ustring filename = t.getFirstFile(exts, broken);
+  if (broken)
+    {
+      t.Close();
+      return;
+    }
+
+  //we only want the turns out of the later game.
+  XML_Helper helper(filename, std::ios::in);
+  helper.registerTag(TurnActionlist::d_tag,
+                     sigc::mem_fun(this, &GameReplay::loadTurn));
+  broken = !helper.parseXML();
+  helper.close();
+  File::erase(filename);
+  t.Close();
+  if (broken)
+    return;
+
+  Checkpoint start;
+  start.filename = start_file;
+  start.turn = 0;
+  start.start = true;
+  broken = !load(start);
+  if (!broken)
+    d_checkpoints[getRound()] = start;
+}
+
+GameReplay::~GameReplay()
+{
+  for (auto it: d_checkpoints)
+    if (it.second.start == false)
+      File::erase(it.second.filename);
+  for (auto t: d_turns)
+    delete t;
+  delete d_game_scenario;
+}
+
+bool GameReplay::loadTurn(Glib::ustring tag, XML_Helper *helper)
+{
+  if (tag == TurnActionlist::d_tag)
+    {
+      d_turns.push_back(new TurnActionlist(helper));
+      return true;
+    }
+  return false;
+}
+
+bool GameReplay::load(const Checkpoint &checkpoint)
+{
+  delete d_game_scenario;
+  bool broken = false;
+  d_game_scenario = new GameScenario(checkpoint.filename, broken);
+  if (broken)
+    {
+      delete d_game_scenario;
+      d_game_scenario = NULL;
+      return false;
+    }
+
+  Playerlist *pl = Playerlist::getInstance();
+  pl->turnEveryoneIntoNetworkPlayers();
+  d_skip.clear();
+  if (checkpoint.start)
+    {
+      //the turns that were already over when the game was saved are in its
+      //own action list, and the later game has them too.  the actions each
+      //player has done since then are already done as well, and they're at
+      //the start of that player's next turn in the later game.
+      d_turn = GameActionlist::getInstance()->countTurns();
+      for (auto p: *pl)
+        d_skip[p->getId()] = p->countActions();
+      d_last_position = -1;
+      if (Playerlist::getActiveplayer())
+        d_last_position =
+          getPosition(Playerlist::getActiveplayer()->getId()) - 1;
+    }
+  else
+    {
+      //checkpoints are taken at the start of a round.
+      d_turn = checkpoint.turn;
+      d_last_position = -1;
+    }
+  return true;
+}
+
+guint32 GameReplay::getRound() const
+{
+  if (d_game_scenario)
+    return d_game_scenario->getRound();
+  return 0;
+}
+
+int GameReplay::getPosition(guint32 player_id) const
+{
+  int position = 0;
+  for (auto p: *Playerlist::getInstance())
+    {
+      if (p->getId() == player_id)
+        return position;
+      position++;
+    }
+  return -1;
+}
+
+bool GameReplay::startsNewRound()
+{
+  if (d_turn >= d_turns.size())
+    return false;
+  TurnActionlist *t = d_turns[d_turn];
+  if (d_skip[t->getOwnerId()] >= t->size())
+    return false;
+  return getPosition(t->getOwnerId()) <= d_last_position;
+}
+
+void GameReplay::finishRound()
+{
+  //the same things that NextTurnNetworked::finishRound does, and then what
+  //GameScenario and Game do when they get its snextRound signal.
+  Playerlist *pl = Playerlist::getInstance();
+  if (pl->checkPlayers() == true && pl->getNoOfPlayers() <= 1)
+    return;
+
+  if (!d_game_scenario->getTurnmode())
+    {
+      for (auto it: *pl)
+        {
+          if (it->isDead())
+            continue;
+          it->collectTaxesAndPayUpkeep();
+          it->stacksReset();
+          VectoredUnitlist::getInstance()->nextTurn(it);
+          Citylist::getInstance()->nextTurn(it);
+        }
+    }
+
+  pl->getNeutral()->ruinsReset();
+
+  GameScenarioOptions::s_round++;
+  pl->nextRound(GameScenarioOptions::s_diplomacy,
+                &GameScenarioOptions::s_surrender_already_offered);
+  d_last_position = -1;
+
+  guint32 round = getRound();
+  if (round % CHECKPOINT_INTERVAL == 0 && d_checkpoints.count(round) == 0)
+    {
+      Checkpoint c;
+      c.filename = File::get_tmp_file(SAVE_EXT);
+      c.turn = d_turn;
+      c.start = false;
+      if (save(c.filename))
+        d_checkpoints[round] = c;
+      else
+        File::erase(c.filename);
+    }
+}
+
+bool GameReplay::step()
+{
+  if (!d_game_scenario || d_turn >= d_turns.size())
+    return false;
+
+  TurnActionlist *t = d_turns[d_turn];
+  guint32 id = t->getOwnerId();
+  if (startsNewRound())
+    finishRound();
+
+  guint32 skip = d_skip[id];
+  d_skip[id] = 0;
+  d_turn++;
+  if (skip >= t->size())
+    return true;
+
+  Playerlist *pl = Playerlist::getInstance();
+  d_last_position = getPosition(id);
+  NetworkPlayer *p = dynamic_cast<NetworkPlayer*>(pl->getPlayer(id));
+  if (!p)
+    return true;
+
+  pl->setActiveplayer(p);
+  TurnActionlist::iterator it = t->begin();
+  std::advance(it, skip);
+  for (; it != t->end(); it++)
+    p->decodeAction(*it);
+  p->getFogMap()->smooth();
+  return true;
+}
+
+void GameReplay::play()
+{
+  while (step())
+    ;
+}
+
+bool GameReplay::seek(guint32 round)
+{
+  if (d_checkpoints.empty() || round < (*d_checkpoints.begin()).first)
+    return false;
+
+  //start again from the nearest checkpoint if it gets us there sooner.
+  auto it = d_checkpoints.upper_bound(round);
+  it--;
+  if (round < getRound() || (*it).first > getRound())
+    if (load((*it).second) == false)
+      return false;
+
+  while (getRound() < round)
+    {
+      if (startsNewRound())
+        finishRound();
+      else if (step() == false)
+        return false;
+    }
+  return true;
+}
+
+bool GameReplay::save(Glib::ustring filename) const
+{
+  if (!d_game_scenario)
+    return false;
+  return d_game_scenario->saveGame(filename);
+}
+
+// End of file
@@ -0,0 +1,139 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+#pragma once
+#ifndef GAME_REPLAY_H
+#define GAME_REPLAY_H
+
+#include <gtkmm.h>
+#include <map>
+#include <vector>
+
+class GameScenario;
+class TurnActionlist;
+class XML_Helper;
+
+//! Plays the recorded turns of a game back onto an earlier save, quickly.
+/**
+ * The game is loaded from a saved-game file that was made earlier on in
+ * the same game, and every player is turned into a NetworkPlayer.  The
+ * turns in the action list of a later saved-game file are then decoded
+ * onto it one TurnActionlist at a time, the same way a network client
+ * decodes the turns of remote players.  Nothing is connected to the
+ * players' signals, so there is no gui, no fight animation and no delay.
+ *
+ * Every few rounds the game is saved to a checkpoint, so seeking back to
+ * an earlier round only replays the turns since the checkpoint before it.
+ */
+class GameReplay
+{
+    public:
+
+        //! Take a checkpoint every this many rounds.
+        static const guint32 CHECKPOINT_INTERVAL = 10;
+
+        //! Make a new replay.
+        /**
+         * @param start_file  The saved-game file to start from.
+         * @param log_file    A later saved-game file of the same game, with
+         *                    the turns to play back.
+         * @param broken      Gets set to true if either file can't be loaded.
+         */
+        GameReplay(Glib::ustring start_file, Glib::ustring log_file,
+                   bool &broken);
+
+        //! Destructor.  Gets rid of the game and the checkpoints.
+        ~GameReplay();
+
+        //! Returns the game as it stands in the replay.
+        GameScenario *getGameScenario() const {return d_game_scenario;};
+
+        //! Returns the number of turns in the log.
+        guint32 countTurns() const {return d_turns.size();};
+
+        //! Returns the index of the next turn to be played back.
+        guint32 getTurn() const {return d_turn;};
+
+        //! Returns the round that the replay has got to.
+        guint32 getRound() const;
+
+        //! Play back the next turn in the log.
+        /**
+         * @return False if there are no more turns, or the game couldn't
+         *         be loaded from a checkpoint.
+         */
+        bool step();
+
+        //! Play back every turn that's left.
+        void play();
+
+        //! Go to the start of the given round.
+        /**
+         * Going backwards starts again from the nearest checkpoint.
+         *
+         * @return False if the log ends before the round.
+         */
+        bool seek(guint32 round);
+
+        //! Save the game as it stands in the replay.
+        bool save(Glib::ustring filename) const;
+
+    private:
+
+        //! A point in the replay that we can start again from.
+        struct Checkpoint
+          {
+            Glib::ustring filename;
+            guint32 turn;
+            bool start; //the file we were given, rather than one we made
+          };
+
+        //! Load the game and get it ready to decode turns.
+        bool load(const Checkpoint &checkpoint);
+
+        //! Go on to the next round, and take a checkpoint if it's time.
+        void finishRound();
+
+        //! Is the next turn in the log the first one of a new round?
+        bool startsNewRound();
+
+        //! Returns where the player is in the turn order.
+        int getPosition(guint32 player_id) const;
+
+        //! Callback for loading the turns from the later saved-game file.
+        bool loadTurn(Glib::ustring tag, XML_Helper *helper);
+
+        GameScenario *d_game_scenario;
+
+        //! The turns to play back.
+        std::vector<TurnActionlist*> d_turns;
+
+        guint32 d_turn;
+
+        //! Where in the turn order the last turn's player was.
+        int d_last_position;
+
+        //! How many actions of each player's next turn are already done.
+        std::map<guint32, guint32> d_skip;
+
+        //! The checkpoints, by round.
+        std::map<guint32, Checkpoint> d_checkpoints;
+};
+
+#endif // GAME_REPLAY_H
+
+// End of file
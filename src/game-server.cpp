@@ -50,6 +50,9 @@ struct Participant
   Glib::ustring nickname;
   bool departed;
   Glib::ustring profile_id;
+  //what a spectator that fell behind hasn't been given yet, oldest first.
+  std::list<std::pair<int, std::shared_ptr<const Glib::ustring> > > backlog;
+  bool resync; //a spectator that fell too far behind, waiting for the map
 };
 
 GameServer * GameServer::s_instance = 0;
@@ -84,14 +87,15 @@ GameServer::GameServer()
 
 void GameServer::notifyRoundOver()
 {
-  for (auto &i: participants)
-    network_server->send(i->conn, MESSAGE_TYPE_ROUND_OVER, "");
+  sendToParticipants(MESSAGE_TYPE_ROUND_OVER, 
+                     std::shared_ptr<const Glib::ustring>(new Glib::ustring()));
 }
 
 bool GameServer::check_end_of_round()
 {
   if (Playerlist::getInstance()->getNeutral()->hasAlreadyEndedTurn())
     {
+      d_stats.roundFinished();
       Playerlist::getInstance()->getNeutral()->clearActionlist();
       notifyRoundOver();
       round_ends.emit();
@@ -102,6 +106,9 @@ bool GameServer::check_end_of_round()
 
 void GameServer::on_player_finished_turn(Player *player)
 {
+  d_stats.turnFinished(player->getId());
+  if (player->ranOutOfThinkTime())
+    d_stats.thinkTimeRanOut(player->getId());
   if (check_end_of_round() == false)
     {
       //if the end of turn is asynchronous, start a new turn from here
@@ -130,6 +137,8 @@ void GameServer::remove_all_participants()
 
 GameServer::~GameServer()
 {
+  d_stats_timer.disconnect();
+  d_backlog_timer.disconnect();
   if (network_server.get() != NULL)
     {
       if (network_server->isListening())
@@ -154,6 +163,7 @@ void GameServer::start(GameScenario *game_scenario, int port, Glib::ustring prof
   if (network_server.get() != NULL && network_server->isListening())
     return;
   network_server.reset(new NetworkServer());
+  network_server->setStats(&d_stats);
   network_server->port_in_use.connect
     (sigc::mem_fun(port_in_use, &sigc::signal<void, int>::emit));
   network_server->got_message.connect
@@ -176,8 +186,8 @@ bool GameServer::sendNextPlayer()
   Glib::ustring s = 
     String::ucompose("%1", Playerlist::getActiveplayer()->getId());
   //now we can send the start round message, and begin the round ourselves.
-  for (auto &i: participants)
-    network_server->send(i->conn, MESSAGE_TYPE_NEXT_PLAYER, s);
+  sendToParticipants(MESSAGE_TYPE_NEXT_PLAYER, 
+                     std::shared_ptr<const Glib::ustring>(new Glib::ustring(s)));
   Participant *part = findParticipantByPlayerId
     (Playerlist::getActiveplayer()->getId());
   if (!part)
@@ -192,6 +202,7 @@ bool GameServer::nextTurn()
       Player *p = get_next_player.emit();
       if (p)
         {
+          d_stats.turnStarted(p->getId());
           if (p->getType() == Player::NETWORKED)
             {
               sendNextPlayer();
@@ -225,8 +236,8 @@ bool GameServer::sendRoundStart()
 {
   sendTurnOrder();
   //now we can send the start round message, and begin the round ourselves.
-  for (auto &i: participants)
-    network_server->send(i->conn, MESSAGE_TYPE_ROUND_START, "");
+  sendToParticipants(MESSAGE_TYPE_ROUND_START, 
+                     std::shared_ptr<const Glib::ustring>(new Glib::ustring()));
   round_begins.emit();
   Playerlist::getInstance()->setActiveplayer(NULL);
   return nextTurn();
@@ -336,6 +347,12 @@ bool GameServer::onGotMessage(void *conn, int type, Glib::ustring payload)
   case MESSAGE_TYPE_PARTICIPANT_DISCONNECTED:
     break;
 
+  case MESSAGE_TYPE_REQUEST_STATS:
+    if (network_server->is_local_connection(conn))
+      network_server->send(conn, MESSAGE_TYPE_STATS, d_stats.toString());
+    break;
+
+  case MESSAGE_TYPE_STATS:
   case MESSAGE_TYPE_SERVER_DISCONNECT:
   case MESSAGE_TYPE_CHATTED:
   case MESSAGE_TYPE_TURN_ORDER:
@@ -351,6 +368,23 @@ bool GameServer::onGotMessage(void *conn, int type, Glib::ustring payload)
   return true;
 }
 
+void GameServer::dumpStatsPeriodically(Glib::ustring filename, int msecs)
+{
+  d_stats_timer.disconnect();
+  d_stats_file = filename;
+  d_stats_timer = Timing::instance().register_timer
+    (sigc::mem_fun(*this, &GameServer::on_stats_timer), msecs);
+}
+
+bool GameServer::on_stats_timer()
+{
+  XML_Helper helper(d_stats_file, std::ios::out);
+  helper.begin("1");
+  d_stats.save(&helper);
+  helper.close();
+  return Timing::CONTINUE;
+}
+
 void GameServer::onConnectionMade(void *conn)
 {
   (void) conn;
@@ -396,14 +430,9 @@ void GameServer::onLocalNonNetworkedActionDone(NetworkAction *action)
   if (action->getAction()->getType() == Action::INIT_TURN)
     local_player_starts_move.emit(action->getOwner());
 
-  for (auto &i: participants)
-    {
-      i->actions.push_back(new NetworkAction (action->getAction(),
-                                              action->getOwnerId()));
-      sendActions(i);
-    }
-  for (auto &i: participants)
-    clearNetworkActionlist(i->actions);
+  std::list<NetworkAction*> actions;
+  actions.push_back(action);
+  sendToParticipants(MESSAGE_TYPE_SENDING_ACTIONS, encodeActions(actions));
 
   //do it here.
   delete action;
@@ -427,13 +456,9 @@ void GameServer::onLocalNonNetworkedHistoryDone(NetworkHistory *history)
   if (history->getHistory()->getType() == History::PLAYER_VANQUISHED)
     local_player_died(history->getOwner());
 
-  for (auto &i: participants)
-    {
-      i->histories.push_back (new NetworkHistory (history->getHistory(), 
-                                                  history->getOwnerId()));
-      sendHistories(i);
-      clearNetworkHistorylist(i->histories);
-    }
+  std::list<NetworkHistory*> histories;
+  histories.push_back(history);
+  sendToParticipants(MESSAGE_TYPE_SENDING_HISTORY, encodeHistories(histories));
   delete history;
 }
 
@@ -442,22 +467,18 @@ void GameServer::onLocalNetworkedHistoryDone(NetworkHistory *history)
   //okay we only care about two locally generated history events.
   Glib::ustring desc = history->toString();
 
-  for (auto &i: participants)
+  if (history->getHistory()->getType() == History::GOLD_TOTAL ||
+      history->getHistory()->getType() == History::SCORE)
     {
-      i->histories.push_back (new NetworkHistory (history->getHistory(), 
-                                                  history->getOwnerId()));
-      if (history->getHistory()->getType() == History::GOLD_TOTAL ||
-          history->getHistory()->getType() == History::SCORE)
-        {
-          std::cerr << String::ucompose("Game Server got locally generated networked history event: %1", desc) << std::endl;
-          sendHistories(i);
-        }
-      else
-        {
-          std::cerr << String::ucompose("Game Server got locally generated networked history event but not sending: %1", desc) << std::endl;
-        }
-
-      clearNetworkHistorylist(i->histories);
+      std::cerr << String::ucompose("Game Server got locally generated networked history event: %1", desc) << std::endl;
+      std::list<NetworkHistory*> histories;
+      histories.push_back(history);
+      sendToParticipants(MESSAGE_TYPE_SENDING_HISTORY, 
+                         encodeHistories(histories));
+    }
+  else
+    {
+      std::cerr << String::ucompose("Game Server got locally generated networked history event but not sending: %1", desc) << std::endl;
     }
   delete history;
 }
@@ -606,6 +627,7 @@ void GameServer::join(void *conn, Glib::ustring nickname_and_profile_id)
     part->profile_id = profile_id;
     participants.push_back(part);
     part->departed = false;
+    part->resync = false;
     new_participant = true;
   }
   if (new_participant)
@@ -664,6 +686,9 @@ void GameServer::sit(void *conn, Player *player, Glib::ustring nickname)
   if (player->getType() != Player::NETWORKED)
     return;
 
+  //it isn't a spectator any more, so it has to catch up before anything
+  //else gets sent to it.
+  flushBacklog(part);
   add_to_player_list(part->players, player->getId(), player->getName(),
                      GameParameters::player_type_to_player_param(player->getType()));
 
@@ -818,17 +843,19 @@ void GameServer::stand(void *conn, Player *player, Glib::ustring nickname)
 void GameServer::gotRemoteActions(void *conn, const Glib::ustring &payload)
 {
   gotActions(payload);
+  std::shared_ptr<const Glib::ustring> shared(new Glib::ustring(payload));
   for (auto &i: participants)
     if (i->conn != conn)
-      network_server->send(i->conn, MESSAGE_TYPE_SENDING_ACTIONS, payload);
+      sendToParticipant(i, MESSAGE_TYPE_SENDING_ACTIONS, shared);
 }
 
 void GameServer::gotRemoteHistory(void *conn, const Glib::ustring &payload)
 {
   gotHistories(payload);
+  std::shared_ptr<const Glib::ustring> shared(new Glib::ustring(payload));
   for (auto &i: participants)
     if (i->conn != conn)
-      network_server->send(i->conn, MESSAGE_TYPE_SENDING_HISTORY, payload);
+      sendToParticipant(i, MESSAGE_TYPE_SENDING_HISTORY, shared);
 }
 
 void GameServer::sendMap(Participant *part)
@@ -882,7 +909,7 @@ void GameServer::sendMap(Participant *part)
     }
 }
 
-void GameServer::sendActions(Participant *part)
+std::shared_ptr<const Glib::ustring> GameServer::encodeActions(std::list<NetworkAction*> &actions)
 {
   std::ostringstream os;
   XML_Helper helper(&os);
@@ -890,15 +917,15 @@ void GameServer::sendActions(Participant *part)
   helper.begin("1");
   helper.openTag("actions");
 
-  for (auto &i: part->actions)
+  for (auto &i: actions)
     (*i).save(&helper);
 
   helper.closeTag();
 
-  network_server->send(part->conn, MESSAGE_TYPE_SENDING_ACTIONS, os.str());
+  return std::shared_ptr<const Glib::ustring>(new Glib::ustring(os.str()));
 }
 
-void GameServer::sendHistories(Participant *part)
+std::shared_ptr<const Glib::ustring> GameServer::encodeHistories(std::list<NetworkHistory*> &histories)
 {
   std::ostringstream os;
   XML_Helper helper(&os);
@@ -906,15 +933,105 @@ void GameServer::sendHistories(Participant *part)
   helper.begin("1");
   helper.openTag("histories");
 
-  for (auto &i: part->histories)
+  for (auto &i: histories)
     {
-      std::cerr << String::ucompose("sending history %1 from person %2 %3 to person %4", History::historyTypeToString(i->getHistory()->getType()), d_nickname, Playerlist::getInstance()->getPlayer(i->getOwnerId())->getName(), part->nickname) << std::endl;
+      std::cerr << String::ucompose("sending history %1 from person %2 %3", History::historyTypeToString(i->getHistory()->getType()), d_nickname, Playerlist::getInstance()->getPlayer(i->getOwnerId())->getName()) << std::endl;
       (*i).save(&helper);
     }
 
   helper.closeTag();
 
-  network_server->send(part->conn, MESSAGE_TYPE_SENDING_HISTORY, os.str());
+  return std::shared_ptr<const Glib::ustring>(new Glib::ustring(os.str()));
+}
+
+bool GameServer::isSpectator(Participant *part)
+{
+  return part->players.empty();
+}
+
+void GameServer::sendToParticipants(int type, std::shared_ptr<const Glib::ustring> payload)
+{
+  for (auto &i: participants)
+    sendToParticipant(i, type, payload);
+}
+
+void GameServer::sendToParticipant(Participant *part, int type, std::shared_ptr<const Glib::ustring> payload)
+{
+  if (isSpectator(part) == false)
+    {
+      //players have to get everything, so we wait for them.
+      flushBacklog(part);
+      network_server->sendShared(part->conn, type, payload);
+      return;
+    }
+  //the game it's going to be sent already has this payload in it.
+  if (part->resync)
+    return;
+  //a spectator that fell behind gets the messages it missed, in order,
+  //as its queue drains.
+  if (part->backlog.empty() &&
+      network_server->trySendShared(part->conn, type, payload))
+    return;
+  if (part->backlog.size() >= BACKLOG_LIMIT)
+    {
+      //it's too far behind, so it gets the game as it stands instead.
+      //that happens from the timer, because sendMap swaps the players
+      //around and we could be in the middle of somebody's move.
+      part->backlog.clear();
+      part->resync = true;
+    }
+  else
+    {
+      part->backlog.push_back(std::make_pair(type, payload));
+      sendBacklog(part);
+    }
+  if ((part->backlog.empty() == false || part->resync) &&
+      d_backlog_timer.connected() == false)
+    d_backlog_timer = Timing::instance().register_timer
+      (sigc::mem_fun(*this, &GameServer::on_backlog_timer), 
+       BACKLOG_INTERVAL);
+}
+
+void GameServer::flushBacklog(Participant *part)
+{
+  if (part->resync)
+    {
+      part->resync = false;
+      sendMap(part);
+    }
+  for (auto &i: part->backlog)
+    network_server->sendShared(part->conn, i.first, i.second);
+  part->backlog.clear();
+}
+
+void GameServer::sendBacklog(Participant *part)
+{
+  while (part->backlog.empty() == false)
+    {
+      if (network_server->trySendShared(part->conn, part->backlog.front().first,
+                                        part->backlog.front().second) == false)
+        break;
+      part->backlog.pop_front();
+    }
+}
+
+bool GameServer::on_backlog_timer()
+{
+  bool lagging = false;
+  for (auto &i: participants)
+    {
+      if (i->resync)
+        {
+          i->resync = false;
+          sendMap(i);
+        }
+      sendBacklog(i);
+      if (i->backlog.empty() == false)
+        lagging = true;
+    }
+  if (lagging)
+    return Timing::CONTINUE;
+  return Timing::STOP;
 }
 
 bool GameServer::dumpActionsAndHistories(XML_Helper *helper, Player *player)
@@ -1112,8 +1229,9 @@ void GameServer::sendOffPlayer(Player *p)
 {
   std::stringstream player;
   player << p->getId();
-  for (auto &i: participants)
-    network_server->send(i->conn, MESSAGE_TYPE_OFF_PLAYER, player.str());
+  sendToParticipants(MESSAGE_TYPE_OFF_PLAYER, 
+                     std::shared_ptr<const Glib::ustring>
+                     (new Glib::ustring(player.str())));
 
   remote_player_died.emit(p);
 }
@@ -1122,8 +1240,9 @@ void GameServer::sendKillPlayer(Player *p)
 {
   std::stringstream player;
   player << p->getId();
-  for (auto &i: participants)
-    network_server->send(i->conn, MESSAGE_TYPE_KILL_PLAYER, player.str());
+  sendToParticipants(MESSAGE_TYPE_KILL_PLAYER, 
+                     std::shared_ptr<const Glib::ustring>
+                     (new Glib::ustring(player.str())));
 
   remote_player_died.emit(p);
 }
@@ -1137,8 +1256,9 @@ void GameServer::sendTurnOrder()
       players << it->getId() << " ";
       ids.push_back(it->getId());
     }
-  for (auto &i: participants)
-    network_server->send(i->conn, MESSAGE_TYPE_TURN_ORDER, players.str());
+  sendToParticipants(MESSAGE_TYPE_TURN_ORDER, 
+                     std::shared_ptr<const Glib::ustring>
+                     (new Glib::ustring(players.str())));
   playerlist_reorder_received.emit();
 }
 
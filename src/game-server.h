@@ -24,10 +24,12 @@
 
 #include <memory>
 #include <list>
+#include <glibmm/ustring.h>
 #include <sigc++/trackable.h>
 #include <sigc++/signal.h>
 
 #include "game-station.h"
+#include "timing.h"
 
 class NetworkServer;
 class Participant;
@@ -69,6 +71,12 @@ public:
 
   void setGameScenario(GameScenario *scenario) {d_game_scenario = scenario;};
 
+  //! Write the network stats out to the given file every so often.
+  void dumpStatsPeriodically(Glib::ustring filename, int msecs = STATS_INTERVAL);
+
+  //! How often the network stats are written out, in milliseconds.
+  static const int STATS_INTERVAL = 60 * 1000;
+
   bool sendRoundStart();
   bool sendNextPlayer();
   bool gameHasBegun();
@@ -107,8 +115,39 @@ private:
   void sendSeat(void *conn, GameParameters::Player player, Glib::ustring nickname);
   void sendChatRoster(void *conn);
 
-  void sendActions(Participant *part);
-  void sendHistories(Participant *part);
+  //! Serialize actions once, so every participant can share the payload.
+  std::shared_ptr<const Glib::ustring> encodeActions(std::list<NetworkAction*> &actions);
+  std::shared_ptr<const Glib::ustring> encodeHistories(std::list<NetworkHistory*> &histories);
+
+  //! Participants who aren't sitting in any seat are just watching.
+  bool isSpectator(Participant *part);
+
+  //! Give the same payload to everybody.
+  void sendToParticipants(int type, std::shared_ptr<const Glib::ustring> payload);
+
+  //! Give a payload to one participant, in order with everything else.
+  /**
+   * Players get it no matter how long it takes.  A spectator whose queue
+   * is full gets the payload put on its backlog instead of holding up the
+   * game, and the backlog is sent in order as its queue drains.  When the
+   * backlog gets to BACKLOG_LIMIT, it's thrown away and the spectator is
+   * sent the game as it stands from the backlog timer.
+   */
+  void sendToParticipant(Participant *part, int type, std::shared_ptr<const Glib::ustring> payload);
+
+  //! Queue as much of a spectator's backlog as there is room for.
+  void sendBacklog(Participant *part);
+
+  //! Queue all of a participant's backlog, however long it takes.
+  void flushBacklog(Participant *part);
+
+  //! How often to try to send the backlogs, in milliseconds.
+  static const int BACKLOG_INTERVAL = 250;
+
+  //! How many messages a spectator can fall behind by.
+  static const size_t BACKLOG_LIMIT = 256;
+  bool on_backlog_timer();
+  sigc::connection d_backlog_timer;
 
   std::unique_ptr<NetworkServer> network_server;
 
@@ -151,6 +190,10 @@ private:
 
   void remove_all_participants();
 
+  bool on_stats_timer();
+  Glib::ustring d_stats_file;
+  sigc::connection d_stats_timer;
+
   bool d_stop;
   //! A static pointer for the singleton instance.
   static GameServer * s_instance;
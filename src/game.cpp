@@ -1377,14 +1377,15 @@ void Game::endOfGameRoaming(Player *winner)
 
 void Game::stack_arrives_on_tile(Stack *stack, Vector<int> tile)
 {
-  StackTile *stile = GameMap::getInstance()->getTile(tile)->getStacks();
+  StackTile *stile = GameMap::getStacks(tile);
   stile->arriving(stack);
 }
 
 void Game::stack_leaves_tile(Stack *stack, Vector<int> tile)
 {
-  StackTile *stile = GameMap::getInstance()->getTile(tile)->getStacks();
+  StackTile *stile = GameMap::getStacks(tile);
   bool left = stile->leaving(stack);
+  GameMap::releaseStacks(tile);
   if (left == false)
     {
       if (stack == NULL)
@@ -18,6 +18,7 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <stdlib.h>
 
 #include "gamelist-client.h"
 
@@ -56,6 +57,7 @@ void GamelistClient::deleteInstance()
 GamelistClient::GamelistClient()
 {
   network_connection = NULL;
+  d_list_version = 0;
 }
 
 void GamelistClient::start(Glib::ustring host, guint32 port, Profile *p)
@@ -121,6 +123,25 @@ bool GamelistClient::onGotMessage(int type, Glib::ustring payload)
           received_game_list.emit(d_recently_played_game_list, "");
         }
       break;
+    case GLS_MESSAGE_VERSIONED_GAME_LIST:
+        {
+          pos = payload.find(' ');
+          if (pos == Glib::ustring::npos)
+            return false;
+          d_list_version = atoi(payload.substr(0, pos).c_str());
+          std::istringstream is(payload.substr(pos + 1));
+          XML_Helper helper(&is);
+          helper.registerTag
+            (RecentlyPlayedGameList::d_tag, 
+             sigc::mem_fun(*this, &GamelistClient::loadRecentlyPlayedGameList));
+          helper.parseXML();
+          helper.close();
+          received_game_list.emit(d_recently_played_game_list, "");
+        }
+      break;
+    case GLS_MESSAGE_GAME_LIST_UNCHANGED:
+      received_game_list_unchanged.emit(atoi(payload.c_str()));
+      break;
     case GLS_MESSAGE_COULD_NOT_GET_GAME_LIST:
       received_game_list.emit(NULL, payload);
       break;
@@ -157,6 +178,7 @@ bool GamelistClient::onGotMessage(int type, Glib::ustring payload)
     case GLS_MESSAGE_ADVERTISE_GAME:
     case GLS_MESSAGE_UNADVERTISE_GAME:
     case GLS_MESSAGE_REQUEST_GAME_LIST:
+    case GLS_MESSAGE_REQUEST_GAME_LIST_SINCE:
     case GLS_MESSAGE_REQUEST_RELOAD:
     case GLS_MESSAGE_REQUEST_TERMINATION:
       //faulty server
@@ -177,6 +199,12 @@ void GamelistClient::request_game_list()
   network_connection->send(GLS_MESSAGE_REQUEST_GAME_LIST, d_profile_id);
 }
 
+void GamelistClient::request_game_list_since(guint32 version)
+{
+  network_connection->send(GLS_MESSAGE_REQUEST_GAME_LIST_SINCE, 
+                           String::ucompose("%1", version));
+}
+
 void GamelistClient::request_advertising(RecentlyPlayedGame *game)
 {
   if (game)
@@ -49,6 +49,10 @@ public:
   void request_game_list();
   sigc::signal<void, RecentlyPlayedGameList*, Glib::ustring> received_game_list;
 
+  //! Only get the list if it's different than the version we already have.
+  void request_game_list_since(guint32 version);
+  sigc::signal<void, guint32> received_game_list_unchanged;
+
   void request_advertising(RecentlyPlayedGame *game);
   sigc::signal<void, Glib::ustring, Glib::ustring> received_advertising_response;
 
@@ -67,6 +71,7 @@ public:
   
   Glib::ustring getHost() const{return d_host;};
   guint32 getPort() const{return d_port;};
+  guint32 getListVersion() const{return d_list_version;};
 
 protected:
   GamelistClient();
@@ -88,6 +93,7 @@ private:
   bool d_connected;
   Glib::ustring d_profile_id;
   RecentlyPlayedGameList *d_recently_played_game_list;
+  guint32 d_list_version;
  
 };
 
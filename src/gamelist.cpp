@@ -21,7 +21,9 @@
 #include "gamelist.h"
 #include "hosted-game.h"
 #include <limits.h>
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <iostream>
 #include "Configuration.h"
 #include "defs.h"
@@ -32,6 +34,7 @@
 #include "recently-played-game-list.h"
 #include "recently-played-game.h"
 #include "File.h"
+#include "rnd.h"
 
 //#define debug(x) {std::cerr<<__FILE__<<": "<<__LINE__<<": "<<x<<std::endl<<std::flush;}
 #define debug(x)
@@ -92,19 +95,46 @@ void Gamelist::deleteInstance()
 }
 
 Gamelist::Gamelist()
+ : d_version(Rnd::rand() | 1)
 {
+  d_serialized_list_valid[0] = false;
+  d_serialized_list_valid[1] = false;
 }
 
 Gamelist::Gamelist(XML_Helper* helper)
+ : d_version(Rnd::rand() | 1)
 {
+  d_serialized_list_valid[0] = false;
+  d_serialized_list_valid[1] = false;
   helper->registerTag(HostedGame::d_tag, sigc::mem_fun(this, &Gamelist::load_tag));
 }
 
 void Gamelist::remove_all()
 {
   for (Gamelist::iterator it = begin(); it != end(); it++)
-    delete *it;
+    {
+      cancelPing(*it);
+      delete *it;
+    }
   clear();
+  changed();
+}
+
+Gamelist::iterator Gamelist::eraseGame(iterator it)
+{
+  cancelPing(*it);
+  delete *it;
+  changed();
+  return erase(it);
+}
+
+void Gamelist::changed()
+{
+  d_version++;
+  if (d_version == 0) //clients ask since 0 when they have no list yet.
+    d_version++;
+  d_serialized_list_valid[0] = false;
+  d_serialized_list_valid[1] = false;
 }
 
 Gamelist::~Gamelist()
@@ -137,6 +167,7 @@ bool Gamelist::load_tag(Glib::ustring tag, XML_Helper* helper)
     {
       HostedGame *g = new HostedGame(helper);
       push_back(g);
+      changed();
       return true;
     }
   return false;
@@ -149,6 +180,7 @@ void Gamelist::addEntry(AdvertisedGame *advertised_game)
   if (g)
     push_back(g);
   sort(orderByTime);
+  changed();
 }
 
 bool Gamelist::orderByTime(HostedGame*rhs, HostedGame *lhs)
@@ -175,8 +207,7 @@ void Gamelist::pruneTooManyGames(int too_many)
       count++;
       if (count > too_many)
 	{
-	  delete *it;
-	  it = erase (it);
+	  it = eraseGame (it);
 	  continue;
 	}
       it++;
@@ -191,8 +222,7 @@ void Gamelist::pruneOldGames(int stale)
     {
       if ((*it)->getAdvertisedGame()->getTimeOfLastPlay().as_double() + stale < now.as_double())
 	{
-	  delete *it;
-	  it = erase (it);
+	  it = eraseGame (it);
 	  continue;
 	}
       it++;
@@ -209,6 +239,7 @@ void Gamelist::updateEntry(Glib::ustring scenario_id, guint32 round)
           now.assign_current_time();
 	  (*it)->getAdvertisedGame()->setTimeOfLastPlay(now);
 	  (*it)->getAdvertisedGame()->setRound(round);
+          changed();
 	}
     }
 }
@@ -239,6 +270,22 @@ RecentlyPlayedGameList* Gamelist::getList(bool scrub_profile_id) const
   l->pruneGames(100);
   return l;
 }
+
+Glib::ustring Gamelist::getSerializedList(bool scrub_profile_id) const
+{
+  int idx = scrub_profile_id ? 1 : 0;
+  if (d_serialized_list_valid[idx] == false)
+    {
+      std::ostringstream os;
+      XML_Helper helper(&os);
+      RecentlyPlayedGameList *l = getList(scrub_profile_id);
+      l->save(&helper);
+      delete l;
+      d_serialized_list[idx] = os.str();
+      d_serialized_list_valid[idx] = true;
+    }
+  return d_serialized_list[idx];
+}
   
 HostedGame *Gamelist::findGameByScenarioId(Glib::ustring scenario_id) const
 {
@@ -250,15 +297,41 @@ HostedGame *Gamelist::findGameByScenarioId(Glib::ustring scenario_id) const
   return NULL;
 }
 
+HostedGame *Gamelist::findGameByPid(guint32 pid) const
+{
+  for (Gamelist::const_iterator i = begin(); i != end(); i++)
+    {
+      if ((*i)->getPid() == pid)
+        return *i;
+    }
+  return NULL;
+}
+
 bool Gamelist::add(HostedGame *g)
 {
   if (size() >= (guint32) MAX_NUMBER_OF_ADVERTISED_GAMES && 
       MAX_NUMBER_OF_ADVERTISED_GAMES != -1)
     return false;
   push_back(g);
+  changed();
   return true;
 }
 
+void Gamelist::remove(HostedGame *g)
+{
+  cancelPing(g);
+  std::list<HostedGame*>::remove(g);
+  changed();
+}
+
+void Gamelist::replace(HostedGame *old_game, HostedGame *new_game)
+{
+  cancelPing(old_game);
+  std::replace(begin(), end(), old_game, new_game);
+  delete old_game;
+  changed();
+}
+
 void Gamelist::pingGames()
 {
   double stale = (double) FIVE_MINUTES_OLD;
@@ -269,28 +342,65 @@ void Gamelist::pingGames()
       AdvertisedGame *a = (*i)->getAdvertisedGame();
       if (a->getGameLastPingedOn().as_double() + stale < now.as_double())
         {
-          (*i)->cannot_ping_game.connect
-            (sigc::mem_fun(*this, &Gamelist::on_could_not_ping_game));
-          (*i)->ping();
+          if (d_pings_in_flight.find(*i) != d_pings_in_flight.end())
+            continue;
+          if (std::find(d_ping_queue.begin(), d_ping_queue.end(), *i) !=
+              d_ping_queue.end())
+            continue;
+          d_ping_queue.push_back(*i);
         }
     }
+  pingNextGames();
+}
+
+void Gamelist::pingNextGames()
+{
+  while (d_pings_in_flight.size() < (guint32) MAX_CONCURRENT_PINGS &&
+         d_ping_queue.empty() == false)
+    {
+      HostedGame *g = d_ping_queue.front();
+      d_ping_queue.pop_front();
+      d_pings_in_flight[g] = 
+        g->pinged.connect(sigc::mem_fun(*this, &Gamelist::on_game_pinged));
+      //the connection gives up on its own after a few seconds.
+      g->ping();
+    }
+}
+
+void Gamelist::cancelPing(HostedGame *game)
+{
+  d_ping_queue.remove(game);
+  std::map<HostedGame*, sigc::connection>::iterator i = 
+    d_pings_in_flight.find(game);
+  if (i != d_pings_in_flight.end())
+    {
+      (*i).second.disconnect();
+      d_pings_in_flight.erase(i);
+    }
 }
 
 void Gamelist::pruneUnresponsiveGames()
 {
-  for (iterator i = begin(); i != end(); i++)
+  for (iterator i = begin(); i != end();)
     {
       if ((*i)->getUnresponsive())
         {
-          delete *i;
-          i = erase (i);
+          i = eraseGame (i);
+          continue;
         }
+      i++;
     }
 }
 
-void Gamelist::on_could_not_ping_game(HostedGame *game)
+void Gamelist::on_game_pinged(HostedGame *game, bool success)
 {
-  game->setUnresponsive(true);
+  cancelPing(game);
+  if (!success && game->getUnresponsive() == false)
+    {
+      game->setUnresponsive(true);
+      changed();
+    }
+  pingNextGames();
 }
 
 bool Gamelist::upgrade(Glib::ustring filename, Glib::ustring old_version, Glib::ustring new_version)
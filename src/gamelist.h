@@ -21,6 +21,7 @@
 
 #include <gtkmm.h>
 #include <list>
+#include <map>
 #include <sigc++/trackable.h>
 
 class AdvertisedGame;
@@ -46,6 +47,9 @@ class Gamelist: public std::list<HostedGame*>, public sigc::trackable
 
 	static const int MAX_NUMBER_OF_ADVERTISED_GAMES = 100;
 
+        //! How many games we try to ping at the same time.
+        static const int MAX_CONCURRENT_PINGS = 8;
+
 	// Methods that operate on the class data and do not modify the class.
 
         //! Save game list to the game list file.
@@ -60,12 +64,36 @@ class Gamelist: public std::list<HostedGame*>, public sigc::trackable
         //! Get the list, with some identifying information removed.
         RecentlyPlayedGameList* getList(bool scrub_profile_id = true) const;
 
+        //! Get the list as it goes over the wire.
+        /**
+         * The xml is kept around until the list changes, so that it isn't
+         * regenerated for every client that asks for it.
+         */
+        Glib::ustring getSerializedList(bool scrub_profile_id = true) const;
+
+        //! Returns a number that goes up every time the list changes.
+        /**
+         * The number starts off random, so that a client holding a version
+         * from before the server was restarted doesn't get told that its
+         * list is up to date.  It is never 0.
+         */
+        guint32 getVersion() const {return d_version;};
+
         HostedGame *findGameByScenarioId(Glib::ustring scenario_id) const;
 
+        //! Find the hosted game that is being served by the given process.
+        HostedGame *findGameByPid(guint32 pid) const;
+
 	// Methods that operate on the class data and modify the class.
 
         bool add(HostedGame *g);
 
+        //! Take the game out of the list, without deleting it.
+        void remove(HostedGame *g);
+
+        //! Put a new game in place of an old one, and delete the old one.
+        void replace(HostedGame *old_game, HostedGame *new_game);
+
 	//! Load the game list from the games file.
         bool load();
 
@@ -125,10 +153,35 @@ class Gamelist: public std::list<HostedGame*>, public sigc::trackable
 
         void remove_all();
 
-        void on_could_not_ping_game(HostedGame *game);
+        //! Helper method to delete a game in the list.
+        iterator eraseGame(iterator it);
+
+        //! The list has changed, so the serialized copies are stale.
+        void changed();
+
+        //! Ping queued games until we have enough pings outstanding.
+        void pingNextGames();
+
+        //! Stop pinging the given game because it's going away.
+        void cancelPing(HostedGame *game);
+
+        void on_game_pinged(HostedGame *game, bool success);
 
 	// DATA
 
+        //! The number of times the list has changed.
+        guint32 d_version;
+
+        //! The list in xml form, with and without profile ids.
+        mutable Glib::ustring d_serialized_list[2];
+        mutable bool d_serialized_list_valid[2];
+
+        //! Games waiting to be pinged.
+        std::list<HostedGame*> d_ping_queue;
+
+        //! Games that are being pinged right now.
+        std::map<HostedGame*, sigc::connection> d_pings_in_flight;
+
         //! A static pointer for the singleton instance.
         static Gamelist* s_instance;
 };
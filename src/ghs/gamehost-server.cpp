@@ -19,6 +19,8 @@
 #include <fstream>
 #include <sstream>
 #include <list>
+#include <unistd.h>
+#include <fcntl.h>
 
 #include "gamehost-server.h"
 
@@ -46,6 +48,15 @@ struct HostGameRequest
   Glib::ustring scenario_id;
 };
 
+struct GameStartRequest
+{
+  void *conn;
+  HostedGame *game;
+  int ready_fd;
+  sigc::connection ready;
+  sigc::connection timeout;
+};
+
 
 GamehostServer * GamehostServer::s_instance = 0;
 
@@ -76,6 +87,15 @@ GamehostServer::GamehostServer()
 
 GamehostServer::~GamehostServer()
 {
+  for (std::list<GameStartRequest*>::iterator i = game_start_requests.begin();
+       i != game_start_requests.end(); i++)
+    {
+      (*i)->ready.disconnect();
+      (*i)->timeout.disconnect();
+      close((*i)->ready_fd);
+      delete (*i)->game;
+      delete *i;
+    }
   if (network_server.get() != NULL)
     {
       if (network_server->isListening())
@@ -106,7 +126,7 @@ void GamehostServer::start(int port)
   network_server->got_message.connect
     (sigc::mem_fun(this, &GamehostServer::onGotMessage));
   network_server->connection_lost.connect
-    (sigc::hide(sigc::mem_fun(this, &GamehostServer::onConnectionLost)));
+    (sigc::mem_fun(this, &GamehostServer::onConnectionLost));
   network_server->connection_made.connect
     (sigc::hide(sigc::mem_fun(this, &GamehostServer::onConnectionMade)));
 
@@ -116,17 +136,9 @@ void GamehostServer::start(int port)
 
 void GamehostServer::sendList(void *conn)
 {
-  std::ostringstream os;
-  XML_Helper helper(&os);
-  RecentlyPlayedGameList *l;
-  if (network_server->is_local_connection(conn))
-    l = Gamelist::getInstance()->getList(false);
-  else
-    l = Gamelist::getInstance()->getList(true);
-
-  l->save(&helper);
-  network_server->send(conn, GHS_MESSAGE_GAME_LIST, os.str());
-  delete l;
+  bool scrub = !network_server->is_local_connection(conn);
+  network_server->send(conn, GHS_MESSAGE_GAME_LIST, 
+                       Gamelist::getInstance()->getSerializedList(scrub));
 }
 
 void GamehostServer::unhost(void *conn, Glib::ustring profile_id, Glib::ustring scenario_id, Glib::ustring &err)
@@ -148,17 +160,20 @@ void GamehostServer::unhost(void *conn, Glib::ustring profile_id, Glib::ustring
       err = _("could not kill process");
       return;
     }
-  Glib::spawn_close_pid(g->getPid());
+  //the child watch closes the pid when the process goes away.
   Gamelist::getInstance()->remove(g);
+  unadvertise(g);
+  delete g;
+  return;
+}
 
-  //now we unadvertise it.
+void GamehostServer::unadvertise(HostedGame *g)
+{
   GamelistClient *gsc = GamelistClient ::getInstance();
   gsc->client_connected.connect
     (sigc::bind(sigc::mem_fun(*this, &GamehostServer::on_connected_to_gamelist_server_for_advertising_removal), g->getAdvertisedGame()->getId()));
   gsc->start(Configuration::s_gamelist_server_hostname,
              Configuration::s_gamelist_server_port, g->getAdvertisedGame()->getProfile());
-  delete g;
-  return;
 }
 
 void GamehostServer::on_connected_to_gamelist_server_for_advertising_removal(Glib::ustring scenario_id)
@@ -175,7 +190,7 @@ void GamehostServer::on_advertising_removal_response_received()
   return;
 }
 
-void GamehostServer::run_game(GameScenario *game_scenario, Glib::Pid *child_pid, guint32 port, Glib::ustring &err)
+void GamehostServer::run_game(GameScenario *game_scenario, Glib::Pid *child_pid, guint32 port, int ready_fd, Glib::ustring &err)
 {
   Glib::ustring lordsawar = Glib::find_program_in_path(PACKAGE);
   if (lordsawar == "")
@@ -194,79 +209,145 @@ void GamehostServer::run_game(GameScenario *game_scenario, Glib::Pid *child_pid,
   argv.push_back("--host");
   argv.push_back("--port");
   argv.push_back(String::ucompose("%1", port));
+  argv.push_back("--ready-fd");
+  argv.push_back(String::ucompose("%1", ready_fd));
   
-  //run lordsawar <file> --host --port <port>
-  Glib::spawn_async (File::getCacheDir (), argv,
-                     Glib::SPAWN_STDOUT_TO_DEV_NULL | 
-                     Glib::SPAWN_STDERR_TO_DEV_NULL, 
-                     sigc::mem_fun(*this, &GamehostServer::on_child_setup), 
-                     child_pid);
+  //run lordsawar <file> --host --port <port> --ready-fd <fd>
+  try
+    {
+      Glib::spawn_async (File::getCacheDir (), argv,
+                         Glib::SPAWN_STDOUT_TO_DEV_NULL | 
+                         Glib::SPAWN_STDERR_TO_DEV_NULL |
+                         Glib::SPAWN_DO_NOT_REAP_CHILD, 
+                         sigc::bind(sigc::mem_fun(*this, &GamehostServer::on_child_setup), ready_fd), 
+                         child_pid);
+    }
+  catch (Glib::SpawnError &ex)
+    {
+      File::erase(tmpfile);
+      err = _("couldn't run lordsawar binary!");
+      return;
+    }
+
+  //reap the game as soon as it quits, instead of leaving it to a ping.
+  Glib::signal_child_watch().connect
+    (sigc::bind(sigc::mem_fun(*this, &GamehostServer::on_game_exited), 
+                tmpfile), *child_pid);
 }
 
-bool GamehostServer::waitForGameToBeConnectable(guint32 port)
+void GamehostServer::on_game_exited(Glib::Pid pid, int status, Glib::ustring tmpfile)
 {
-  Glib::RefPtr<Gio::SocketClient>client = Gio::SocketClient::create();
-  while (1)
-    {
-      Glib::RefPtr<Gio::SocketConnection> sock;
-      try
-        {
-          sock = client->connect_to_host ("127.0.0.1", port);
-        }
-      catch (Glib::Exception &ex)
-        {
-          ;
-        }
-      if (sock)
-        {
-          sock.reset();
-          break;
-        }
-      Glib::usleep(1000000);
-    }
-  client.reset();
-  return true;
+  debug("game process " << pid << " exited with status " << status);
+  Glib::spawn_close_pid(pid);
+  File::erase(tmpfile);
+  HostedGame *g = Gamelist::getInstance()->findGameByPid((guint32) pid);
+  if (!g)
+    return; //it was unhosted.
+  Gamelist::getInstance()->remove(g);
+  unadvertise(g);
+  delete g;
+  Gamelist::getInstance()->save();
 }
 
-HostedGame * GamehostServer::host(GameScenario *game_scenario, Profile *profile, Glib::ustring &err)
+HostedGame * GamehostServer::host(GameScenario *game_scenario, Profile *profile, void *conn, Glib::ustring &err)
 {
+  int fds[2];
+  if (pipe(fds) != 0)
+    {
+      err = _("could not create pipe!");
+      return NULL;
+    }
+  //the read end stays here, and the child writes to the other one.
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
   guint32 port = get_free_port();
   Glib::Pid child_pid;
-  run_game(game_scenario, &child_pid, port, err);
+  run_game(game_scenario, &child_pid, port, fds[1], err);
+  close(fds[1]);
   if (err != "")
-    return NULL;
-
-  //now we wait to see if everything is okay.
-
-  bool success = waitForGameToBeConnectable(port);
-  if (!success)
     {
-      err = _("Game couldn't be setup properly.");
-      kill (child_pid, SIGQUIT);
-      Glib::spawn_close_pid(child_pid);
+      close(fds[0]);
       return NULL;
     }
 
-  //now we add an entry to the gamelist.
   HostedGame *g = new HostedGame(new AdvertisedGame(game_scenario, profile));
   g->setPid((guint32) child_pid);
   g->getAdvertisedGame()->fillData(getHostname(), port);
-  if (Gamelist::getInstance()->add(g) == false)
+
+  //now we wait for the game to tell us everything is okay.
+  GameStartRequest *request = new GameStartRequest();
+  request->conn = conn;
+  request->game = g;
+  request->ready_fd = fds[0];
+  request->ready = Glib::signal_io().connect
+    (sigc::bind(sigc::mem_fun(*this, &GamehostServer::on_game_ready), 
+                request), fds[0], Glib::IO_IN | Glib::IO_HUP | Glib::IO_ERR);
+  request->timeout = Glib::signal_timeout().connect_seconds
+    (sigc::bind(sigc::mem_fun(*this, &GamehostServer::on_game_startup_timed_out), 
+                request), GAME_STARTUP_TIMEOUT);
+  game_start_requests.push_back(request);
+  return g;
+}
+
+bool GamehostServer::on_game_ready(Glib::IOCondition cond, GameStartRequest *request)
+{
+  char c = 0;
+  if ((cond & Glib::IO_IN) && read(request->ready_fd, &c, 1) == 1)
+    finish_hosting(request, "");
+  else
+    finish_hosting(request, _("Game couldn't be setup properly."));
+  return false;
+}
+
+bool GamehostServer::on_game_startup_timed_out(GameStartRequest *request)
+{
+  finish_hosting(request, _("Game couldn't be setup properly."));
+  return false;
+}
+
+void GamehostServer::finish_hosting(GameStartRequest *request, Glib::ustring err)
+{
+  request->ready.disconnect();
+  request->timeout.disconnect();
+  close(request->ready_fd);
+  game_start_requests.remove(request);
+
+  HostedGame *g = request->game;
+  Glib::ustring scenario_id = g->getAdvertisedGame()->getId();
+  if (err == "")
+    {
+      //now we add an entry to the gamelist.
+      if (Gamelist::getInstance()->add(g) == false)
+        err = _("could not add game to list.");
+    }
+
+  if (err != "")
     {
-      err = _("could not add game to list.");
       kill (g->getPid(), SIGQUIT);
-      Glib::spawn_close_pid(g->getPid());
       delete g;
-      return NULL;
+      if (request->conn)
+        network_server->send(request->conn, GHS_MESSAGE_COULD_NOT_START_GAME, 
+                             scenario_id + " " + err);
+      delete request;
+      return;
     }
 
+  if (request->conn)
+    network_server->send
+      (request->conn, GHS_MESSAGE_GAME_HOSTED, 
+       String::ucompose("%1 %2", scenario_id, 
+                        g->getAdvertisedGame()->getPort()));
+  Gamelist::getInstance()->save();
+  delete request;
+
   //now we advertise it.
   GamelistClient *gsc = GamelistClient ::getInstance();
   gsc->client_connected.connect
     (sigc::bind(sigc::mem_fun(*this, &GamehostServer::on_connected_to_gamelist_server_for_advertising), g));
   gsc->start(Configuration::s_gamelist_server_hostname,
-             Configuration::s_gamelist_server_port, profile);
-  return g;
+             Configuration::s_gamelist_server_port, 
+             g->getAdvertisedGame()->getProfile());
 }
 
 guint32 GamehostServer::get_free_port()
@@ -278,9 +359,10 @@ guint32 GamehostServer::get_free_port()
   return port;
 }
 
-void GamehostServer::on_child_setup()
+void GamehostServer::on_child_setup(int ready_fd)
 {
-  return;
+  //we're in the child now.  let it keep the end of the pipe it reports on.
+  fcntl(ready_fd, F_SETFD, 0);
 }
 
 void GamehostServer::on_connected_to_gamelist_server_for_advertising(HostedGame *game)
@@ -409,17 +491,11 @@ bool GamehostServer::onGotMessage(void *conn, int type, Glib::ustring payload)
               return true;
             }
 
-          HostedGame *g = host(game_scenario, profile, err);
+          //we reply when the game says it's ready, or when it fails to be.
+          host(game_scenario, profile, conn, err);
           if (err != "")
             network_server->send(conn, GHS_MESSAGE_COULD_NOT_START_GAME, 
                                  game_scenario->getId()+ " " + err);
-          else
-            network_server->send
-              (conn, GHS_MESSAGE_GAME_HOSTED, 
-               String::ucompose("%1 %2", game_scenario->getId(), 
-                                g->getAdvertisedGame()->getPort()));
-
-          Gamelist::getInstance()->save();
           delete game_scenario;
           delete profile;
         }
@@ -487,9 +563,16 @@ void GamehostServer::onConnectionMade()
   cleanup_old_profiles_awaiting_maps();
 }
 
-void GamehostServer::onConnectionLost()
+void GamehostServer::onConnectionLost(void *conn)
 {
   debug("connection lost");
+  //games that are still starting up have nobody to report back to now.
+  for (std::list<GameStartRequest*>::iterator i = game_start_requests.begin();
+       i != game_start_requests.end(); i++)
+    {
+      if ((*i)->conn == conn)
+        (*i)->conn = NULL;
+    }
 }
 
 sigc::connection GamehostServer::on_timer_registered(Timing::timer_slot s,
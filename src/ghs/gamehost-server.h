@@ -36,6 +36,7 @@ class Profile;
 class GameScenario;
 class HostedGame;
 class HostGameRequest;
+class GameStartRequest;
 
 class GamehostServer
 {
@@ -47,6 +48,10 @@ public:
   static const int TOO_MANY_PROFILES_AWAITING_MAPS = 100;
   static const int ONE_HOUR_OLD = 60 * 60;
 
+  //! How long a hosted game has to start listening, in seconds.
+  static const int GAME_STARTUP_TIMEOUT = 30;
+
+
   //! Deletes the singleton instance.
   static void deleteInstance();
 
@@ -77,24 +82,30 @@ private:
   std::unique_ptr<NetworkServer> network_server;
   Glib::ustring hostname;
   std::list<HostGameRequest*> host_game_requests;
+  std::list<GameStartRequest*> game_start_requests;
   std::list<Glib::ustring> members;
 
   bool onGotMessage(void *conn, int type, Glib::ustring message);
-  void onConnectionLost();
+  void onConnectionLost(void *conn);
   void onConnectionMade();
   sigc::connection on_timer_registered(Timing::timer_slot s, int msecs_interval);
   void on_connected_to_gamelist_server_for_advertising_removal(Glib::ustring scenario_id);
   void on_advertising_removal_response_received();
   void on_connected_to_gamelist_server_for_advertising(HostedGame *game);
   void on_advertising_response_received();
-  void on_child_setup();
+  void on_child_setup(int ready_fd);
+  bool on_game_ready(Glib::IOCondition cond, GameStartRequest *request);
+  bool on_game_startup_timed_out(GameStartRequest *request);
+  void finish_hosting(GameStartRequest *request, Glib::ustring err);
+  void on_game_exited(Glib::Pid pid, int status, Glib::ustring tmpfile);
   bool loadProfile(Glib::ustring tag, XML_Helper *helper, Profile **profile);
 
   // helpers
   void sendList(void *conn);
+  void unadvertise(HostedGame *g);
   void unhost(void *conn, Glib::ustring profile_id, Glib::ustring scenario_id, Glib::ustring &err);
-  HostedGame* host(GameScenario *game_scenario, Profile *profile, Glib::ustring &err);
-  void run_game(GameScenario *game_scenario, Glib::Pid *child_pid, guint32 port, Glib::ustring &err);
+  HostedGame* host(GameScenario *game_scenario, Profile *profile, void *conn, Glib::ustring &err);
+  void run_game(GameScenario *game_scenario, Glib::Pid *child_pid, guint32 port, int ready_fd, Glib::ustring &err);
   void get_profile_and_scenario_id(Glib::ustring payload, Profile **profile, Glib::ustring &scenario_id, Glib::ustring &err);
   guint32 get_free_port();
   bool is_member(Glib::ustring profile_id);
@@ -102,7 +113,6 @@ private:
   void cleanup_old_profiles_awaiting_maps(int stale = ONE_HOUR_OLD);
   bool add_to_profiles_awaiting_maps(Profile *profile, Glib::ustring scenario_id);
   Profile *remove_from_profiles_awaiting_maps(Glib::ustring scenario_id);
-  bool waitForGameToBeConnectable(guint32 port);
 
   //! A static pointer for the singleton instance.
   static GamehostServer * s_instance;
@@ -62,10 +62,14 @@ GamelistServer::GamelistServer()
   Gamelist::getInstance()->loadFromFile(datafile);
   Gamelist::getInstance()->pruneGames();
   Gamelist::getInstance()->pingGames();
+  maintenance_timer = Timing::instance().register_timer
+    (sigc::mem_fun(*this, &GamelistServer::on_maintenance_timer), 
+     MAINTENANCE_INTERVAL);
 }
 
 GamelistServer::~GamelistServer()
 {
+  maintenance_timer.disconnect();
   if (network_server.get() != NULL)
     {
       if (network_server->isListening())
@@ -106,17 +110,31 @@ void GamelistServer::start(int port)
 
 void GamelistServer::sendList(void *conn)
 {
-  std::ostringstream os;
-  XML_Helper helper(&os);
-  RecentlyPlayedGameList *l;
-  if (network_server->is_local_connection(conn))
-    l = Gamelist::getInstance()->getList(false);
-  else
-    l = Gamelist::getInstance()->getList(true);
+  bool scrub = !network_server->is_local_connection(conn);
+  network_server->send(conn, GLS_MESSAGE_GAME_LIST, 
+                       Gamelist::getInstance()->getSerializedList(scrub));
+}
 
-  l->save(&helper);
-  network_server->send(conn, GLS_MESSAGE_GAME_LIST, os.str());
-  delete l;
+void GamelistServer::sendListSince(void *conn, guint32 version)
+{
+  guint32 current = Gamelist::getInstance()->getVersion();
+  if (version == current)
+    {
+      network_server->send(conn, GLS_MESSAGE_GAME_LIST_UNCHANGED, 
+                           String::ucompose("%1", current));
+      return;
+    }
+  bool scrub = !network_server->is_local_connection(conn);
+  network_server->send(conn, GLS_MESSAGE_VERSIONED_GAME_LIST, 
+                       String::ucompose("%1 %2", current, 
+                                        Gamelist::getInstance()->getSerializedList(scrub)));
+}
+
+bool GamelistServer::on_maintenance_timer()
+{
+  Gamelist::getInstance()->pruneGames();
+  Gamelist::getInstance()->pingGames();
+  return Timing::CONTINUE;
 }
 
 void GamelistServer::unadvertise(void *conn, Glib::ustring profile_id, Glib::ustring scenario_id, Glib::ustring &err)
@@ -177,6 +195,14 @@ bool GamelistServer::onGotMessage(void *conn, int type, Glib::ustring payload)
     case GLS_MESSAGE_REQUEST_GAME_LIST:
       sendList(conn);
       break;
+    case GLS_MESSAGE_REQUEST_GAME_LIST_SINCE:
+        {
+          guint32 version = 0;
+          std::istringstream is(payload);
+          is >> version;
+          sendListSince(conn, version);
+        }
+      break;
     case GLS_MESSAGE_REQUEST_RELOAD:
       if (network_server->is_local_connection(conn))
         {
@@ -202,6 +228,8 @@ bool GamelistServer::onGotMessage(void *conn, int type, Glib::ustring payload)
     case GLS_MESSAGE_COULD_NOT_GET_GAME_LIST:
     case GLS_MESSAGE_COULD_NOT_RELOAD:
     case GLS_MESSAGE_RELOADED:
+    case GLS_MESSAGE_GAME_LIST_UNCHANGED:
+    case GLS_MESSAGE_VERSIONED_GAME_LIST:
       //faulty client
       break;
     }
@@ -211,8 +239,6 @@ bool GamelistServer::onGotMessage(void *conn, int type, Glib::ustring payload)
 void GamelistServer::onConnectionMade()
 {
   debug("connection made");
-  Gamelist::getInstance()->pruneGames();
-  Gamelist::getInstance()->pingGames();
 }
 
 void GamelistServer::onConnectionLost()
@@ -244,8 +270,7 @@ bool GamelistServer::loadAdvertisedGame(Glib::ustring tag, XML_Helper *helper, v
                                    a->getId() + " " + _("permission denied"));
               return true;
             }
-          std::replace(Gamelist::getInstance()->begin(), 
-                       Gamelist::getInstance()->end(), h, new HostedGame(a));
+          Gamelist::getInstance()->replace(h, new HostedGame(a));
               
           network_server->send(conn, GLS_MESSAGE_GAME_ADVERTISED,
                                a->getId()); //no error
@@ -36,6 +36,9 @@ class XML_Helper;
 class GamelistServer
 {
 public:
+
+  //! How often we prune and ping the games in the list, in milliseconds.
+  static const int MAINTENANCE_INTERVAL = 60 * 1000;
         
   //! Returns the singleton instance.  Creates a new one if neccessary.
   static GamelistServer * getInstance();
@@ -58,6 +61,7 @@ protected:
 private:
   std::unique_ptr<NetworkServer> network_server;
   Glib::ustring datafile;
+  sigc::connection maintenance_timer;
 
   bool onGotMessage(void *conn, int type, Glib::ustring message);
   void onConnectionLost();
@@ -66,6 +70,8 @@ private:
 
   void unadvertise(void *conn, Glib::ustring profile_id, Glib::ustring scenario_id, Glib::ustring &err);
   void sendList(void *conn);
+  void sendListSince(void *conn, guint32 version);
+  bool on_maintenance_timer();
   bool loadAdvertisedGame(Glib::ustring tag, XML_Helper *helper, void *conn);
 
   //! A static pointer for the singleton instance.
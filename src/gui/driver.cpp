@@ -20,6 +20,7 @@
 #include <sigc++/bind.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "driver.h"
 
@@ -177,6 +178,18 @@ void Driver::serve (GameScenario *game_scenario)
       return;
     }
   printf("Game Server is now listening on port %d\n", get_port());
+  game_server->dumpStatsPeriodically
+    (Glib::build_filename(File::getCacheDir(), 
+                          String::ucompose("gameserver-%1-stats.xml", 
+                                           get_port())));
+  //tell whoever spawned us that we can be connected to now.
+  if (Main::instance().ready_fd != -1)
+    {
+      if (write(Main::instance().ready_fd, "1", 1) != 1)
+        std::cerr << "Could not signal readiness" << std::endl;
+      close(Main::instance().ready_fd);
+      Main::instance().ready_fd = -1;
+    }
   NextTurnNetworked *next_turn = new NextTurnNetworked(game_scenario->getTurnmode(), game_scenario->s_random_turns);
   game_server->round_ends.connect(sigc::mem_fun(next_turn, &NextTurnNetworked::finishRound));
   game_server->start_player_turn.connect(sigc::mem_fun(next_turn, &NextTurnNetworked::start_player));
@@ -563,6 +576,8 @@ GameScenario *Driver::create_new_scenario(GameParameters &g, GameScenario::PlayM
   GameScenarioOptions::s_intense_combat = g.intense_combat;
   GameScenarioOptions::s_military_advisor = g.military_advisor;
   GameScenarioOptions::s_random_turns = g.random_turns;
+  GameScenarioOptions::s_easy_ai_think_time = g.easy_ai_think_time;
+  GameScenarioOptions::s_hard_ai_think_time = g.hard_ai_think_time;
 
   game_scenario->setName(g.name);
   game_scenario->setPlayMode(m);
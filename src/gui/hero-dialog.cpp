@@ -211,15 +211,16 @@ void HeroDialog::run()
   dialog->show_all();
   show_hero();
   dialog->run();
-  if (gm->getTile(pos)->getBackpack()->size() > 0 && 
-      gm->getTile(pos)->getType() == Tile::WATER)
+  MapBackpack *ground = gm->findBackpack(pos);
+  if (ground && gm->getTile(pos)->getType() == Tile::WATER)
     {
       // splash, items lost forever
-      while (gm->getTile(pos)->getBackpack()->size())
+      while (ground->size())
         {
-	  MapBackpack::iterator i = gm->getTile(pos)->getBackpack()->begin();
-          gm->getTile(pos)->getBackpack()->removeFromBackpack(*i);
+	  MapBackpack::iterator i = ground->begin();
+          ground->removeFromBackpack(*i);
         }
+      GameMap::releaseBackpack(pos);
     }
 }
 
@@ -451,9 +452,10 @@ void HeroDialog::show_hero()
   for (Backpack::iterator i = backpack->begin(); i != backpack->end(); ++i)
     add_item(*i, true);
 
-  MapBackpack *ground = GameMap::getInstance()->getTile(pos)->getBackpack();
-  for (MapBackpack::iterator i = ground->begin(); i != ground->end(); i++)
-    add_item(*i, false);
+  MapBackpack *ground = GameMap::getInstance()->findBackpack(pos);
+  if (ground)
+    for (MapBackpack::iterator i = ground->begin(); i != ground->end(); i++)
+      add_item(*i, false);
 
   return;
 }
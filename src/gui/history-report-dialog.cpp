@@ -44,17 +44,17 @@ HistoryReportDialog::HistoryReportDialog(Gtk::Window &parent, Player *p, History
  : LwDialog(parent, "history-report-dialog.ui")
 {
   d_player = p;
-  generatePastCitylists();
-  generatePastRuinlists();
-  generatePastEventlists();
+  d_index = new HistoryIndex();
+  d_citylist = NULL;
+  d_ruinlist = NULL;
   xml->get_widget("map_image", map_image);
   historymap = new HistoryMap(Citylist::getInstance(), Ruinlist::getInstance());
   historymap->map_changed.connect (method(on_map_changed));
 
   xml->get_widget("turn_scale", turn_scale);
   dialog->set_title(_("History"));
-  turn_scale->set_range(1, past_citylists.size());
-  turn_scale->set_value(past_citylists.size());
+  turn_scale->set_range(1, d_index->getNumberOfTurns());
+  turn_scale->set_value(d_index->getNumberOfTurns());
 
   turn_scale->signal_value_changed().connect (method(on_turn_changed));
 
@@ -115,218 +115,10 @@ HistoryReportDialog::HistoryReportDialog(Gtk::Window &parent, Player *p, History
 
 HistoryReportDialog::~HistoryReportDialog()
 {
-  std::vector<std::list<NetworkHistory *> >::iterator it;
-  it = past_eventlists.begin();
-  for (; it != past_eventlists.end(); it++)
-    {
-      std::list<NetworkHistory*> hist = (*it);
-      std::list<NetworkHistory*>::iterator hit = hist.begin();
-      for (; hit != hist.end(); hit++)
-	delete (*hit);
-    }
   delete historymap;
-}
-
-void HistoryReportDialog::generatePastEventlists()
-{
-  bool last_turn = false;
-  std::list<NetworkHistory*> *elist = new std::list<NetworkHistory*>();
-
-  //keep a set of pointers to remember how far we are into each player's history
-  std::list<History*> *hist[MAX_PLAYERS];
-  Playerlist::iterator pit = Playerlist::getInstance()->begin();
-  for (; pit != Playerlist::getInstance()->end(); ++pit)
-    {
-      if (*pit == Playerlist::getInstance()->getNeutral())
-	continue;
-      hist[(*pit)->getId()] = (*pit)->getHistorylist();
-    }
-  std::list<History*>::iterator hit[MAX_PLAYERS];
-  pit = Playerlist::getInstance()->begin();
-  for (; pit != Playerlist::getInstance()->end(); ++pit)
-    {
-      if (*pit == Playerlist::getInstance()->getNeutral())
-	continue;
-      hit[(*pit)->getId()] = hist[(*pit)->getId()]->begin();
-    }
-
-  unsigned int count = 0;
-  while (1)
-    {
-      //now we see what cities we took this turn
-      pit = Playerlist::getInstance()->begin();
-      for (; pit != Playerlist::getInstance()->end(); ++pit)
-	{
-	  if (*pit == Playerlist::getInstance()->getNeutral())
-	    continue;
-	  //dump everything up to the next turn
-	  guint32 id = (*pit)->getId();
-	  if (hit[id] == hist[id]->end())
-	    continue;
-	  for (; hit[id] != hist[id]->end(); ++hit[id])
-	    {
-	      if ((*hit[id])->getType() == History::START_TURN)
-		{
-		  hit[id]++;
-		  break;
-		}
-	      switch ((*hit[id])->getType())
-		{
-		case History::FOUND_SAGE: 
-		case History::HERO_EMERGES:
-		case History::HERO_QUEST_STARTED:
-		case History::HERO_QUEST_COMPLETED:
-		case History::HERO_KILLED_IN_CITY:
-		case History::HERO_KILLED_IN_BATTLE:
-		case History::HERO_KILLED_SEARCHING:
-		case History::HERO_CITY_WON:
-		case History::HERO_FINDS_ALLIES:
-		case History::PLAYER_VANQUISHED:
-		case History::DIPLOMATIC_TREACHERY:
-		case History::DIPLOMATIC_WAR:
-		case History::DIPLOMATIC_PEACE:
-		case History::HERO_RUIN_EXPLORED:
-		case History::USE_ITEM:
-		  elist->push_back(new NetworkHistory(*hit[id], (*pit)->getId()));
-		  break;
-		case History::START_TURN:
-		case History::GOLD_TOTAL:
-		case History::CITY_WON:
-		case History::CITY_RAZED:
-		case History::SCORE:
-		case History::HERO_REWARD_RUIN:
-		case History::END_TURN:
-		  break;
-		}
-	    }
-	  if (hit[id] == hist[id]->end())
-	    {
-	      count++;
-	      if (count == Playerlist::getInstance()->size() - 2)
-		last_turn = true;
-	    }
-	}
-      //and add it to the list
-      past_eventlists.push_back(*elist);
-      std::list<NetworkHistory*> *new_elist = new std::list<NetworkHistory*>();
-      elist = new_elist;
-      if (last_turn == true)
-	break;
-
-    }
-}
-
-void HistoryReportDialog::generatePastCitylists()
-{
-  bool last_turn = false;
-
-  //keep a set of pointers to remember how far we are into each player's history
-  std::list<History*> *hist[MAX_PLAYERS];
-  Playerlist::iterator pit = Playerlist::getInstance()->begin();
-  for (; pit != Playerlist::getInstance()->end(); ++pit)
-    {
-      if (*pit == Playerlist::getInstance()->getNeutral())
-	continue;
-      hist[(*pit)->getId()] = (*pit)->getHistorylist();
-    }
-  std::list<History*>::iterator hit[MAX_PLAYERS];
-  pit = Playerlist::getInstance()->begin();
-  for (; pit != Playerlist::getInstance()->end(); ++pit)
-    {
-      if (*pit == Playerlist::getInstance()->getNeutral())
-	continue;
-      hit[(*pit)->getId()] = hist[(*pit)->getId()]->begin();
-    }
-
-  //start off with an initial city list where all cities are neutral owned
-  LocationList<City*> *clist = new LocationList<City*>();
-  Citylist *cl = Citylist::getInstance();
-  for (Citylist::iterator it = cl->begin(); it != cl->end(); ++it)
-    clist->push_back(new City(**it));
-  for (LocationList<City*>::iterator it = clist->begin(); it != clist->end(); ++it)
-    {
-      (*it)->setOwner(Playerlist::getInstance()->getNeutral());
-      //is the city burned to begin with?
-      bool no_city_history = true;
-      pit = Playerlist::getInstance()->begin();
-      guint32 age;
-      for (; pit != Playerlist::getInstance()->end(); ++pit)
-	if ((*pit)->conqueredCity(*it, age) == true)
-	  no_city_history = false;
-      if ((*it)->isBurnt() == true && no_city_history)
-	(*it)->setBurnt(true);
-      else
-	(*it)->setBurnt(false);
-    }
-
-  unsigned int count = 0;
-  while (1)
-    {
-      //now we see what cities we took this turn
-      pit = Playerlist::getInstance()->begin();
-      for (; pit != Playerlist::getInstance()->end(); ++pit)
-	{
-	  if (*pit == Playerlist::getInstance()->getNeutral())
-	    continue;
-	  //dump everything up to the next turn
-	  guint32 id = (*pit)->getId();
-	  if (hit[id] == hist[id]->end())
-	    continue;
-	  for (; hit[id] != hist[id]->end(); hit[id]++)
-	    {
-	      if ((*hit[id])->getType() == History::START_TURN)
-		{
-		  hit[id]++;
-		  break;
-		}
-	      else if ((*hit[id])->getType() == History::CITY_WON)
-		{
-		  guint32 city_id;
-		  city_id = dynamic_cast<History_CityWon*>(*hit[id])->getCityId();
-		  //find city with this city id in clist
-		  LocationList<City*>::iterator cit = clist->begin();
-		  for (; cit != clist->end(); ++cit)
-		    if ((*cit)->getId() == city_id)
-		      {
-			(*cit)->setOwner(*pit);
-			break;
-		      }
-		}
-	      else if ((*hit[id])->getType() == History::CITY_RAZED)
-		{
-		  guint32 city_id;
-		  city_id = dynamic_cast<History_CityRazed*>(*hit[id])->getCityId();
-		  //find city with this city id in clist
-		  LocationList<City*>::iterator cit = clist->begin();
-		  for (; cit != clist->end(); ++cit)
-		    if ((*cit)->getId() == city_id)
-		      {
-			//change the owner to neutral 
-			(*cit)->setOwner(Playerlist::getInstance()->getNeutral());
-			(*cit)->setBurnt(true);
-			break;
-		      }
-		}
-	    }
-	  if (hit[id] == hist[id]->end())
-	    {
-	      count++;
-	      if (count == Playerlist::getInstance()->size() - 2)
-		last_turn = true;
-	    }
-	}
-      //and add it to the list
-      past_citylists.push_back(clist);
-      LocationList<City*> *new_clist = new LocationList<City*>();
-      for (LocationList<City*>::iterator it = clist->begin(); 
-	   it != clist->end(); ++it)
-	new_clist->push_back(new City(**it));
-      clist = new_clist;
-      if (last_turn == true)
-	break;
-
-    }
-  past_citylists.erase(--past_citylists.end());
+  delete d_citylist;
+  delete d_ruinlist;
+  delete d_index;
 }
 
 void HistoryReportDialog::run()
@@ -350,10 +142,23 @@ void HistoryReportDialog::on_turn_changed()
 {
   //tell the historymap to show another set of cities
   guint32 turn = (guint32)turn_scale->get_value();
-  if (turn > past_citylists.size() - 1)
-    historymap->updateCities(Citylist::getInstance(), Ruinlist::getInstance());
+  LocationList<City*> *old_citylist = d_citylist;
+  LocationList<Ruin*> *old_ruinlist = d_ruinlist;
+  if (turn >= d_index->getNumberOfTurns())
+    {
+      d_citylist = NULL;
+      d_ruinlist = NULL;
+      historymap->updateCities(Citylist::getInstance(), 
+                               Ruinlist::getInstance());
+    }
   else
-    historymap->updateCities(past_citylists[turn], past_ruinlists[turn]);
+    {
+      d_citylist = d_index->getCitylist(turn);
+      d_ruinlist = d_index->getRuinlist(turn);
+      historymap->updateCities(d_citylist, d_ruinlist);
+    }
+  delete old_citylist;
+  delete old_ruinlist;
   city_chart->set_x_indicator(turn);
   ruin_chart->set_x_indicator(turn);
   gold_chart->set_x_indicator(turn);
@@ -395,12 +200,12 @@ void HistoryReportDialog::fill_in_turn_info(guint32 turn)
   for (unsigned int i = 0; i < kids.size(); i++)
     events_list_box->remove(*kids[i]);
 
-  if (turn <= past_eventlists.size() - 1)
+  std::list<NetworkHistory*> hist = d_index->getEvents(turn);
+  for (std::list<NetworkHistory*>::iterator hit = hist.begin(); 
+       hit != hist.end(); hit++)
     {
-      std::list<NetworkHistory*> hist = past_eventlists[turn];
-      std::list<NetworkHistory*>::iterator hit = hist.begin();
-      for (; hit != hist.end(); hit++)
-	addHistoryEvent(*hit);
+      addHistoryEvent(*hit);
+      delete *hit;
     }
 
   //update the gold chart
@@ -416,7 +221,7 @@ void HistoryReportDialog::fill_in_turn_info(guint32 turn)
 	  break;
 	}
     }
-  turn == past_citylists.size() ?
+  turn == d_index->getNumberOfTurns() ?
     s = String::ucompose(ngettext("On turn %1 you have %2 gold piece!",
 				  "On turn %1 you have %2 gold pieces!",
 				  count), turn, count) :
@@ -437,7 +242,7 @@ void HistoryReportDialog::fill_in_turn_info(guint32 turn)
 	  break;
 	}
     }
-  turn == past_citylists.size() ?
+  turn == d_index->getNumberOfTurns() ?
     s = String::ucompose(ngettext("On turn %1 you have %2 city!",
 				  "On turn %1 you have %2 cities!",
 				  count), turn, count) :
@@ -458,7 +263,7 @@ void HistoryReportDialog::fill_in_turn_info(guint32 turn)
 	  break;
 	}
     }
-  turn == past_ruinlists.size() ?
+  turn == d_index->getNumberOfTurns() ?
   s = String::ucompose(ngettext("By turn %1 you explored %2 ruin!",
                                 "By turn %1 you explored %2 ruins!",
                                 count), turn, count) :
@@ -484,7 +289,7 @@ void HistoryReportDialog::fill_in_turn_info(guint32 turn)
 	    }
 	}
     }
-  turn == past_citylists.size() ?
+  turn == d_index->getNumberOfTurns() ?
     s = String::ucompose(_("On turn %1 you are coming %2!"),
 			 turn, ReportDialog::calculateRank(scores, *scores.begin())):
     s = String::ucompose(_("On turn %1 you were coming %2!"),
@@ -659,24 +464,13 @@ void HistoryReportDialog::addHistoryEvent(NetworkHistory *event)
 
 void HistoryReportDialog::generatePastWinningCounts()
 {
-  //go through the history list looking for score events, per player
+  //the score events, per player
   Playerlist::iterator pit = Playerlist::getInstance()->begin();
-  pit = Playerlist::getInstance()->begin();
   for (; pit != Playerlist::getInstance()->end(); ++pit)
     {
       if (*pit == Playerlist::getInstance()->getNeutral())
 	continue;
-      std::list<History*> *hist = (*pit)->getHistorylist();
-      std::list<History*>::iterator hit = hist->begin();
-      std::list<guint32> line;
-      for (; hit != hist->end(); hit++)
-	{
-	  if ((*hit)->getType() == History::SCORE)
-	    {
-	      History_Score *event = static_cast<History_Score*>(*hit);
-	      line.push_back (event->getScore());
-	    }
-	}
+      std::list<guint32> line = d_index->getScores(*pit);
       line.push_back ((guint32)(*pit)->getScore());
       if (*pit == d_player)
 	past_rankcounts.push_front(line);
@@ -687,58 +481,30 @@ void HistoryReportDialog::generatePastWinningCounts()
 
 void HistoryReportDialog::generatePastCityCounts()
 {
-  // go through the past city list
+  //how many cities did the players have at each turn?
   Playerlist::iterator pit = Playerlist::getInstance()->begin();
-  pit = Playerlist::getInstance()->begin();
   for (; pit != Playerlist::getInstance()->end(); ++pit)
     {
       if (*pit == Playerlist::getInstance()->getNeutral())
 	continue;
-      //go through the past city lists, searching for cities owned by this
-      //player
-
-      std::list<guint32> line;
-      for (unsigned int i = 0; i < past_citylists.size(); i++)
-	{
-	  guint32 total_cities = 0;
-	  LocationList<City*>::iterator it = past_citylists[i]->begin();
-	  for (; it != past_citylists[i]->end(); it++)
-	    {
-	      if ((*it)->getOwner() == *pit)
-		total_cities++;
-	    }
-	  line.push_back(total_cities);
-	}
-
+      std::list<guint32> line = d_index->getCityCounts(*pit);
       line.push_back(Citylist::getInstance()->countCities(*pit));
       if (*pit == d_player)
 	past_citycounts.push_front(line);
       else
 	past_citycounts.push_back(line);
-
     }
 }
 
 void HistoryReportDialog::generatePastGoldCounts()
 {
-  //go through the history list looking for gold events, per player
+  //the gold events, per player
   Playerlist::iterator pit = Playerlist::getInstance()->begin();
-  pit = Playerlist::getInstance()->begin();
   for (; pit != Playerlist::getInstance()->end(); ++pit)
     {
       if (*pit == Playerlist::getInstance()->getNeutral())
 	continue;
-      std::list<History*> *hist = (*pit)->getHistorylist();
-      std::list<History*>::iterator hit = hist->begin();
-      std::list<guint32> line;
-      for (; hit != hist->end(); hit++)
-	{
-	  if ((*hit)->getType() == History::GOLD_TOTAL)
-	    {
-	      History_GoldTotal *event = static_cast<History_GoldTotal*>(*hit);
-	      line.push_back (event->getGold());
-	    }
-	}
+      std::list<guint32> line = d_index->getGoldCounts(*pit);
       line.push_back ((guint32)(*pit)->getGold());
       if (*pit == d_player)
 	past_goldcounts.push_front(line);
@@ -750,32 +516,12 @@ void HistoryReportDialog::generatePastGoldCounts()
 void HistoryReportDialog::generatePastRuinCounts()
 {
   //how many ruins did the players search at each turn?
-
   Playerlist::iterator pit = Playerlist::getInstance()->begin();
-  pit = Playerlist::getInstance()->begin();
   for (; pit != Playerlist::getInstance()->end(); ++pit)
     {
       if (*pit == Playerlist::getInstance()->getNeutral())
         continue;
-      std::list<guint32> line;
-      for (unsigned int i = 0; i < past_citylists.size(); i++)
-        {
-          guint32 total_ruins = 0;
-          LocationList<Ruin*>::iterator it = past_ruinlists[i]->begin();
-          for (; it != past_ruinlists[i]->end(); it++)
-            {
-              Ruin *ruin = *it;
-              if (ruin->isHidden() == true && ruin->getOwner() != *pit)
-                continue;
-              if (ruin->isSearched() == true && 
-                  (*pit)->searchedRuin(ruin) == true)
-                {
-                  ruin->setOwner(*pit);
-                  total_ruins++;
-                }
-            }
-          line.push_back(total_ruins);
-        }
+      std::list<guint32> line = d_index->getRuinCounts(*pit);
       line.push_back(Ruinlist::getInstance()->countExploredRuins(*pit));
       if (*pit == d_player)
 	past_ruincounts.push_front(line);
@@ -783,124 +529,3 @@ void HistoryReportDialog::generatePastRuinCounts()
 	past_ruincounts.push_back(line);
     }
 }
-
-void HistoryReportDialog::generatePastRuinlists()
-{
-  //we don't do this per player
-  //we just count how many ruins are unexplored at every turn.
-  //how do we deal with hidden ruins?
-  //they should pop up when found.
-  bool last_turn = false;
-
-  //keep a set of pointers to remember how far we are into each player's history
-  std::list<History*> *hist[MAX_PLAYERS];
-  Playerlist::iterator pit = Playerlist::getInstance()->begin();
-  for (; pit != Playerlist::getInstance()->end(); ++pit)
-    {
-      if (*pit == Playerlist::getInstance()->getNeutral())
-	continue;
-      hist[(*pit)->getId()] = (*pit)->getHistorylist();
-    }
-  std::list<History*>::iterator hit[MAX_PLAYERS];
-  pit = Playerlist::getInstance()->begin();
-  for (; pit != Playerlist::getInstance()->end(); ++pit)
-    {
-      if (*pit == Playerlist::getInstance()->getNeutral())
-	continue;
-      hit[(*pit)->getId()] = hist[(*pit)->getId()]->begin();
-    }
-
-  //start off with an initial ruin list where all ruins are unexplored and hidden.
-  //all hidden ruins haven't been found yet, unless they started off that way.
-  LocationList<Ruin*> *rlist = new LocationList<Ruin*>();
-  Ruinlist *rl = Ruinlist::getInstance();
-  for (Ruinlist::iterator it = rl->begin(); it != rl->end(); ++it)
-    rlist->push_back(new Ruin(**it));
-  for (LocationList<Ruin*>::iterator it = rlist->begin(); it != rlist->end(); ++it)
-    {
-      //is the ruin searched to begin with?
-      bool no_ruin_history = true;
-      pit = Playerlist::getInstance()->begin();
-      for (; pit != Playerlist::getInstance()->end(); ++pit)
-	if ((*pit)->searchedRuin(*it) == true)
-	  no_ruin_history = false;
-      if ((*it)->isSearched() == true && no_ruin_history)
-        (*it)->setSearched(true);
-      else
-        {
-          (*it)->setSearched(false);
-          if ((*it)->isHidden())
-            (*it)->setOwner(NULL);
-        }
-    }
-
-  unsigned int count = 0;
-  while (1)
-    {
-      //now we see what ruins we took this turn
-      pit = Playerlist::getInstance()->begin();
-      for (; pit != Playerlist::getInstance()->end(); ++pit)
-	{
-	  if (*pit == Playerlist::getInstance()->getNeutral())
-	    continue;
-	  //dump everything up to the next turn
-	  guint32 id = (*pit)->getId();
-	  if (hit[id] == hist[id]->end())
-	    continue;
-	  for (; hit[id] != hist[id]->end(); hit[id]++)
-	    {
-	      if ((*hit[id])->getType() == History::START_TURN)
-		{
-		  hit[id]++;
-		  break;
-		}
-              //when a ruin becomes visible all of a sudden, we mark it as visible
-	      else if ((*hit[id])->getType() == History::HERO_REWARD_RUIN)
-                {
-		  guint32 ruin_id;
-		  ruin_id = 
-                    dynamic_cast<History_HeroRewardRuin*>(*hit[id])->getRuinId();
-		  //find ruin with this ruin id in rlist
-		  LocationList<Ruin*>::iterator rit = rlist->begin();
-		  for (; rit != rlist->end(); ++rit)
-		    if ((*rit)->getId() == ruin_id)
-		      {
-                        (*rit)->setOwner(*pit);
-			break;
-		      }
-                }
-	      else if ((*hit[id])->getType() == History::HERO_RUIN_EXPLORED)
-		{
-		  guint32 ruin_id;
-		  ruin_id = 
-                    dynamic_cast<History_HeroRuinExplored*>(*hit[id])->getRuinId();
-		  //find ruin with this ruin id in rlist
-		  LocationList<Ruin*>::iterator rit = rlist->begin();
-		  for (; rit != rlist->end(); ++rit)
-		    if ((*rit)->getId() == ruin_id)
-		      {
-			(*rit)->setSearched(true);
-			break;
-		      }
-		}
-	    }
-	  if (hit[id] == hist[id]->end())
-	    {
-	      count++;
-	      if (count == Playerlist::getInstance()->size() - 2)
-		last_turn = true;
-	    }
-	}
-      //and add it to the list
-      past_ruinlists.push_back(rlist);
-      LocationList<Ruin*> *new_rlist = new LocationList<Ruin*>();
-      for (LocationList<Ruin*>::iterator it = rlist->begin(); 
-	   it != rlist->end(); ++it)
-	new_rlist->push_back(new Ruin(**it));
-      rlist = new_rlist;
-      if (last_turn == true)
-	break;
-
-    }
-  past_ruinlists.erase(--past_ruinlists.end());
-}
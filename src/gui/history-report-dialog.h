@@ -27,6 +27,7 @@
 #include "LocationList.h"
 #include "historymap.h"
 #include "history.h"
+#include "history-index.h"
 #include "player.h"
 #include "lw-dialog.h"
 
@@ -41,13 +42,10 @@ class HistoryReportDialog: public LwDialog
     HistoryReportDialog(Gtk::Window &parent, Player *p, HistoryReportType type);
     ~HistoryReportDialog();
 
-    void generatePastCitylists(); //data for map
     void generatePastCityCounts(); //data for chart
-    void generatePastRuinlists(); //data for map
     void generatePastRuinCounts(); //data for chart
     void generatePastGoldCounts(); //data for chart
     void generatePastWinningCounts(); //data for chart
-    void generatePastEventlists(); //data for events list
 
     void run();
     void hide() {dialog->hide();};
@@ -67,11 +65,11 @@ class HistoryReportDialog: public LwDialog
     Gtk::Alignment *gold_alignment;
     Gtk::Alignment *winner_alignment;
 
-    std::vector<LocationList<City*>* > past_citylists;
+    HistoryIndex *d_index; //data for the map and the events list
+    LocationList<City*> *d_citylist; //the cities of the turn on the map
+    LocationList<Ruin*> *d_ruinlist; //the ruins of the turn on the map
     LineChart *city_chart;
-    std::vector<std::list<NetworkHistory *> > past_eventlists;
     std::list<std::list<guint32> > past_citycounts;
-    std::vector<LocationList<Ruin*>* > past_ruinlists;
     LineChart *ruin_chart;
     std::list<std::list<guint32> > past_ruincounts;
     std::list<std::list<guint32> > past_goldcounts;
@@ -16,7 +16,16 @@
 //  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
 //  02110-1301, USA.
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <sstream>
+#include <string.h>
+#include <sys/stat.h>
+#include <glib/gstdio.h>
+#include <gdkmm/pixbufloader.h>
 #include "image-helpers.h"
+#include "File.h"
 
 std::vector<PixMask*>
 disassemble_row(const Glib::ustring &file, int no, bool &broken)
@@ -115,6 +124,292 @@ disassemble_row(const Glib::ustring &file, int no, bool first_half_height, bool
     return pixmasks;
 }
 
+namespace
+{
+
+// a cached row is a header of these, followed by the premultiplied ARGB32
+// pixels of each subimage in turn.
+enum CacheHeader
+{
+  CACHE_MAGIC = 0, CACHE_NO, CACHE_ROWS, CACHE_WIDTH, CACHE_HEIGHT,
+  CACHE_UNSCALED_WIDTH, CACHE_UNSCALED_HEIGHT, CACHE_STRIDE, CACHE_HEADER_SIZE
+};
+const guint32 cache_magic = 0x4c574932; //LWI2
+
+// the surfaces made from a cached row hang on to the file they point into.
+const cairo_user_data_key_t cache_file_key = {0};
+
+// how big the cache directory can get before the rows that haven't been
+// used for the longest time are thrown away.
+const gint64 cache_limit = 64 * 1024 * 1024;
+
+// the cache is keyed on the png itself, so a set that changes gets new
+// entries rather than stale pictures.
+std::string get_cache_file(const std::string &dir, const DecodeJob &job)
+{
+  gchar *sum = g_compute_checksum_for_data(G_CHECKSUM_MD5,
+                                           (const guchar *) job.data->data(),
+                                           job.data->size());
+  std::ostringstream os;
+  os << sum << "-" << job.no << "x" << job.rows << "-" << job.frame_width <<
+    "-" << job.width << "x" << job.height << (job.always_scale ? "" : "-fit");
+  g_free(sum);
+  return dir + G_DIR_SEPARATOR_S + os.str();
+}
+
+// the surfaces draw straight out of the mapped file.  it's mapped
+// privately, so drawing on them later doesn't touch the cache.
+bool load_cached_row(DecodeJob &job)
+{
+  GMappedFile *file = g_mapped_file_new(job.cache_file.c_str(), TRUE, NULL);
+  if (!file)
+    return false;
+  gchar *contents = g_mapped_file_get_contents(file);
+  gsize length = g_mapped_file_get_length(file);
+  guint32 header[CACHE_HEADER_SIZE];
+  bool ok = length >= sizeof (header);
+  if (ok)
+    {
+      memcpy(header, contents, sizeof (header));
+      int no = header[CACHE_NO];
+      int w = header[CACHE_WIDTH];
+      int h = header[CACHE_HEIGHT];
+      int stride = header[CACHE_STRIDE];
+      ok = header[CACHE_MAGIC] == cache_magic && no > 0 &&
+        (job.no == 0 || no == job.no) &&
+        (int) header[CACHE_ROWS] == job.rows && w > 0 && h > 0 &&
+        stride == cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, w) &&
+        length == sizeof (header) + (gsize) no * job.rows * h * stride;
+      unsigned char *pixels = (unsigned char *) contents + sizeof (header);
+      for (int i = 0; ok && i < no * job.rows; i++)
+        {
+          cairo_surface_t *surface = cairo_image_surface_create_for_data
+            (pixels + (gsize) i * h * stride, CAIRO_FORMAT_ARGB32, w, h, 
+             stride);
+          job.cached.push_back(surface);
+          ok = cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS &&
+            cairo_surface_set_user_data(surface, &cache_file_key,
+                                        g_mapped_file_ref(file),
+                                        (cairo_destroy_func_t) 
+                                        g_mapped_file_unref) == 
+            CAIRO_STATUS_SUCCESS;
+        }
+      if (ok)
+        job.no = no;
+      job.unscaled_width = header[CACHE_UNSCALED_WIDTH];
+      job.unscaled_height = header[CACHE_UNSCALED_HEIGHT];
+    }
+  g_mapped_file_unref(file);
+  if (ok)
+    g_utime(job.cache_file.c_str(), NULL); //so the pruning passes it over.
+  return ok;
+}
+
+void save_cached_row(const DecodeJob &job, const std::vector<PixMask*> &pics)
+{
+  std::string contents;
+  guint32 header[CACHE_HEADER_SIZE];
+  header[CACHE_MAGIC] = cache_magic;
+  header[CACHE_NO] = job.no;
+  header[CACHE_ROWS] = job.rows;
+  header[CACHE_WIDTH] = pics.front()->get_width();
+  header[CACHE_HEIGHT] = pics.front()->get_height();
+  header[CACHE_UNSCALED_WIDTH] = job.unscaled_width;
+  header[CACHE_UNSCALED_HEIGHT] = job.unscaled_height;
+  header[CACHE_STRIDE] = 
+    cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, 
+                                  header[CACHE_WIDTH]);
+  contents.append((const char *) header, sizeof (header));
+  for (auto pic: pics)
+    {
+      Cairo::RefPtr<Cairo::ImageSurface> surface =
+        Cairo::RefPtr<Cairo::ImageSurface>::cast_dynamic(pic->get_pixmap());
+      if (!surface || surface->get_stride() != (int) header[CACHE_STRIDE])
+        return;
+      surface->flush();
+      contents.append((const char *) surface->get_data(), 
+                      surface->get_stride() * surface->get_height());
+    }
+  try
+    {
+      Glib::file_set_contents(job.cache_file, contents);
+    }
+  catch (const Glib::FileError &ex)
+    {
+      ;
+    }
+}
+
+// the rows are touched whenever they're read back, so the oldest
+// modification times go first.
+void prune_cache(const std::string &dir)
+{
+  GDir *d = g_dir_open(dir.c_str(), 0, NULL);
+  if (!d)
+    return;
+  struct CacheEntry
+  {
+    std::string file;
+    time_t mtime;
+    gint64 size;
+  };
+  std::vector<CacheEntry> entries;
+  gint64 total = 0;
+  const gchar *name;
+  while ((name = g_dir_read_name(d)) != NULL)
+    {
+      std::string file = dir + G_DIR_SEPARATOR_S + name;
+      GStatBuf buf;
+      if (g_stat(file.c_str(), &buf) != 0 || S_ISREG(buf.st_mode) == 0)
+        continue;
+      entries.push_back({file, buf.st_mtime, (gint64) buf.st_size});
+      total += buf.st_size;
+    }
+  g_dir_close(d);
+  if (total <= cache_limit)
+    return;
+  std::sort(entries.begin(), entries.end(),
+            [](const CacheEntry &a, const CacheEntry &b)
+            { return a.mtime < b.mtime; });
+  for (auto &entry: entries)
+    {
+      if (total <= cache_limit)
+        break;
+      if (g_remove(entry.file.c_str()) == 0)
+        total -= entry.size;
+    }
+}
+
+// this runs on a worker thread, so it sticks to the C apis of gdk-pixbuf
+// and cairo.  the C++ wrappers get made afterwards, back on the calling
+// thread.
+void decode_row(DecodeJob &job, const std::string &cache_dir)
+{
+  if (!job.data || job.rows <= 0 || job.no < 0 ||
+      (job.no == 0 && job.frame_width <= 0))
+    {
+      job.broken = true;
+      return;
+    }
+  job.cache_file = get_cache_file(cache_dir, job);
+  if (load_cached_row(job))
+    return;
+  for (auto surface: job.cached)
+    cairo_surface_destroy(surface);
+  job.cached.clear();
+
+  GdkPixbufLoader *loader = gdk_pixbuf_loader_new();
+  bool ok = gdk_pixbuf_loader_write(loader, (const guchar *) job.data->data(),
+                                    job.data->size(), NULL);
+  ok = gdk_pixbuf_loader_close(loader, NULL) && ok;
+  GdkPixbuf *row = ok ? gdk_pixbuf_loader_get_pixbuf(loader) : NULL;
+  if (row && job.no == 0)
+    job.no = gdk_pixbuf_get_width(row) / job.frame_width;
+  int h = row ? gdk_pixbuf_get_height(row) / job.rows : 0;
+  int w = row && job.no > 0 ? gdk_pixbuf_get_width(row) / job.no : 0;
+  if (w <= 0 || h <= 0)
+    {
+      job.broken = true;
+      g_object_unref(loader);
+      return;
+    }
+  job.unscaled_width = w;
+  job.unscaled_height = h;
+  for (int i = 0; i < job.no * job.rows; ++i)
+    {
+      GdkPixbuf *buf = gdk_pixbuf_new(gdk_pixbuf_get_colorspace(row),
+                                      gdk_pixbuf_get_has_alpha(row),
+                                      gdk_pixbuf_get_bits_per_sample(row),
+                                      w, h);
+      gdk_pixbuf_copy_area(row, (i % job.no) * w, (i / job.no) * h, w, h, 
+                           buf, 0, 0);
+      if (job.width > 0 && (job.always_scale || w != job.width))
+        {
+          // the same steps as PixMask::scale, magenta keyed out and all.
+          GdkPixbuf *alpha = gdk_pixbuf_add_alpha(buf, TRUE, 255, 87, 204);
+          g_object_unref(buf);
+          buf = gdk_pixbuf_scale_simple(alpha, job.width, job.height,
+                                        GDK_INTERP_NEAREST);
+          g_object_unref(alpha);
+        }
+      job.decoded.push_back(buf);
+    }
+  g_object_unref(loader);
+}
+
+}
+
+void decode_rows(std::vector<DecodeJob> &jobs)
+{
+  if (Gtk::Main::instance() == NULL)
+    {
+      for (auto &job: jobs)
+        job.broken = true;
+      return;
+    }
+  std::string cache_dir = Glib::build_filename(File::getCacheDir(), "images");
+  static bool pruned = false;
+  if (!pruned)
+    {
+      File::create_dir(cache_dir);
+      prune_cache(cache_dir);
+      pruned = true;
+    }
+  std::atomic<size_t> next(0);
+  auto work = [&jobs, &next, &cache_dir]()
+    {
+      for (size_t i = next++; i < jobs.size(); i = next++)
+        decode_row(jobs[i], cache_dir);
+    };
+  size_t cores = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < std::min(cores, jobs.size()); i++)
+    workers.push_back(std::thread(work));
+  work();
+  for (auto &worker: workers)
+    worker.join();
+
+  for (auto &job: jobs)
+    {
+      for (auto buf: job.decoded)
+        job.images.push_back(Glib::wrap(buf));
+      job.decoded.clear();
+      for (auto surface: job.cached)
+        job.surfaces.push_back(Cairo::RefPtr<Cairo::ImageSurface>
+                               (new Cairo::ImageSurface(surface, true)));
+      job.cached.clear();
+    }
+}
+
+std::vector<PixMask*> to_pixmasks(const DecodeJob &job)
+{
+  std::vector<PixMask*> pixmasks;
+  if (job.broken)
+    return pixmasks;
+  for (auto surface: job.surfaces)
+    pixmasks.push_back(PixMask::create(surface, job.unscaled_width,
+                                       job.unscaled_height));
+  if (job.surfaces.empty() == false)
+    return pixmasks;
+  for (auto buf: job.images)
+    pixmasks.push_back(PixMask::create(buf, job.unscaled_width,
+                                       job.unscaled_height));
+  if (pixmasks.empty() == false && job.cache_file.empty() == false)
+    save_cached_row(job, pixmasks);
+  return pixmasks;
+}
+
+std::vector<PixMask*> load_row(const std::string *data, int no, bool &broken,
+                               int width, int height)
+{
+  std::vector<DecodeJob> jobs(1, DecodeJob(data, no, width, height));
+  decode_rows(jobs);
+  std::vector<PixMask*> pixmasks = to_pixmasks(jobs.front());
+  if (jobs.front().broken)
+    broken = true;
+  return pixmasks;
+}
+
 bool image_width_is_multiple_of_image_height(const Glib::ustring file)
 {
   Glib::RefPtr<Gdk::Pixbuf> row;
@@ -20,6 +20,7 @@
 #ifndef IMAGE_HELPERS_H
 #define IMAGE_HELPERS_H
 
+#include <string>
 #include <vector>
 #include <gdkmm/pixbuf.h>
 #include "PixMask.h"
@@ -31,6 +32,50 @@ disassemble_row(const Glib::ustring &file, int no, bool &broken);
 std::vector<PixMask*>
 disassemble_row(const Glib::ustring &file, int no, bool first_half_height, bool &broken);
 
+// a row of subimages in memory that decode_rows turns into pixbufs.
+struct DecodeJob
+{
+  DecodeJob(const std::string *d, int n, int w = 0, int h = 0)
+    : data(d), no(n), rows(1), frame_width(0), width(w), height(h),
+    always_scale(true), unscaled_width(0), unscaled_height(0),
+    broken(false) {};
+  const std::string *data;
+  int no;
+  // images with masks underneath them have 2 rows.  the subimages of the
+  // first row come first.
+  int rows;
+  // when no is 0, the row has as many subimages as fit this width.
+  int frame_width;
+  // scale the subimages to this size, or leave them alone when it's 0.
+  int width;
+  int height;
+  // when this is false, subimages that are already width wide are left be.
+  bool always_scale;
+  int unscaled_width;
+  int unscaled_height;
+  bool broken;
+  // where the scaled subimages are kept between runs.
+  std::string cache_file;
+  std::vector<Glib::RefPtr<Gdk::Pixbuf> > images;
+  std::vector<Cairo::RefPtr<Cairo::ImageSurface> > surfaces;
+  std::vector<GdkPixbuf*> decoded;
+  std::vector<cairo_surface_t*> cached;
+};
+// decode, split and scale the rows on a thread per core.  the jobs keep
+// their order, so callers that go through them one by one afterwards stop
+// on the same broken image every time.  rows that have been through here
+// before are read back from the cache directory instead of being decoded,
+// and the least recently used ones are pruned when the directory gets big.
+void decode_rows(std::vector<DecodeJob> &jobs);
+// make the pixmasks for a job that decode_rows has finished with, and put
+// them in the cache if they were freshly decoded.
+// this has to happen on the main thread.
+std::vector<PixMask*> to_pixmasks(const DecodeJob &job);
+// decode one row that is in memory, e.g. from Tar_Helper::getFileContents,
+// by way of the cache and on this thread.
+std::vector<PixMask*> load_row(const std::string *data, int no, bool &broken,
+                               int width = 0, int height = 0);
+
 //Cairo::RefPtr<Cairo::Surface> scale (Cairo::RefPtr<Cairo::Surface> pixmap, int w, int h);
 bool image_width_is_multiple_of_image_height(const Glib::ustring file);
 void get_image_width_and_height (const Glib::ustring &file, guint32 &width, guint32 &height, bool &broken);
@@ -49,6 +49,7 @@ class Main: public sigc::trackable
     guint32 random_number_seed;
     bool start_headless_server;
     guint32 port;
+    int ready_fd;
     Glib::Rand rnd;
     int cacheSize;
     std::string configuration_file_path;
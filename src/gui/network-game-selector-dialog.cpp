@@ -35,6 +35,7 @@ NetworkGameSelectorDialog::NetworkGameSelectorDialog(Gtk::Window &parent, Profil
  : LwDialog(parent, "pick-network-game-to-join-dialog.ui")
 {
     profile = p;
+    list_version = 0;
     xml->get_widget("hostname_entry", hostname_entry);
     xml->get_widget("port_spinbutton", port_spinbutton);
     hostname_entry->set_activates_default(true);
@@ -93,6 +94,8 @@ NetworkGameSelectorDialog::NetworkGameSelectorDialog(Gtk::Window &parent, Profil
 
       GamelistClient::getInstance()->received_game_list.connect
         (method(on_game_list_received));
+      GamelistClient::getInstance()->received_game_list_unchanged.connect
+        (method(on_game_list_unchanged));
 
       GamelistClient::getInstance()->start 
         (Configuration::s_gamelist_server_hostname, 
@@ -110,21 +113,28 @@ void NetworkGameSelectorDialog::on_could_not_connect_to_gamelist_server()
 void NetworkGameSelectorDialog::on_connected_to_gamelist_server()
 {
   refresh_button->set_sensitive(false);
-  GamelistClient::getInstance()->request_game_list();
+  GamelistClient::getInstance()->request_game_list_since(list_version);
 }
 
 void NetworkGameSelectorDialog::on_game_list_received(RecentlyPlayedGameList *rpgl, Glib::ustring err)
 {
   if (err == "")
     {
+      games_list->clear();
       fill_games(rpgl, games_list, games_columns, NULL);
       select_first_game();
+      list_version = GamelistClient::getInstance()->getListVersion();
     }
 
   delete rpgl;
   refresh_button->set_sensitive(true);
 }
 
+void NetworkGameSelectorDialog::on_game_list_unchanged(guint32 version)
+{
+  refresh_button->set_sensitive(true);
+}
+
 void NetworkGameSelectorDialog::select_first_game()
 {
   if (games_treeview->get_model()->children().size() > 0)
@@ -259,7 +269,6 @@ void NetworkGameSelectorDialog::update_buttons()
 
 void NetworkGameSelectorDialog::on_refresh_clicked()
 {
-  games_list->clear();
   on_connected_to_gamelist_server();
 }
 
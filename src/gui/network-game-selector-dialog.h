@@ -82,6 +82,10 @@ class NetworkGameSelectorDialog: public LwDialog
     void on_connected_to_gamelist_server();
     void on_could_not_connect_to_gamelist_server();
     void on_game_list_received(RecentlyPlayedGameList *rpgl, Glib::ustring err);
+    void on_game_list_unchanged(guint32 version);
+
+    //! The version of the game list that we're showing, or 0 for none.
+    guint32 list_version;
     void on_recent_game_activated();
     void on_hosted_game_activated();
 };
@@ -0,0 +1,338 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+#include <set>
+
+#include "history-index.h"
+#include "history.h"
+#include "network-history.h"
+#include "playerlist.h"
+#include "citylist.h"
+#include "ruinlist.h"
+#include "city.h"
+#include "ruin.h"
+
+HistoryIndex::HistoryIndex()
+ : d_turns(0)
+{
+  Playerlist *pl = Playerlist::getInstance();
+  guint32 neutral = pl->getNeutral()->getId();
+  std::vector<Player*> players;
+  for (auto p: *pl)
+    if (p != pl->getNeutral())
+      players.push_back(p);
+
+  Citylist *cl = Citylist::getInstance();
+  guint32 idx = 0;
+  for (auto c: *cl)
+    d_city_index[c->getId()] = idx++;
+  Ruinlist *rl = Ruinlist::getInstance();
+  idx = 0;
+  for (auto r: *rl)
+    d_ruin_index[r->getId()] = idx++;
+
+  //look over the whole of each history for the things we need to know up
+  //front, and for the gold and score series.
+  std::set<guint32> conquered, explored;
+  for (auto p: *pl)
+    for (auto h: *p->getHistorylist())
+      {
+        switch (h->getType())
+          {
+          case History::CITY_WON:
+            conquered.insert(static_cast<History_CityWon*>(h)->getCityId());
+            break;
+          case History::HERO_RUIN_EXPLORED:
+            explored.insert
+              (static_cast<History_HeroRuinExplored*>(h)->getRuinId());
+            break;
+          case History::GOLD_TOTAL:
+            d_gold_counts[p->getId()].push_back
+              (static_cast<History_GoldTotal*>(h)->getGold());
+            break;
+          case History::SCORE:
+            d_scores[p->getId()].push_back
+              (static_cast<History_Score*>(h)->getScore());
+            break;
+          default:
+            break;
+          }
+      }
+
+  //the cities all start off neutral, and the only burnt ones are the ones
+  //nobody has ever taken.
+  std::vector<CityState> cities;
+  for (auto c: *cl)
+    {
+      CityState state;
+      state.owner = neutral;
+      state.burnt = c->isBurnt() && conquered.count(c->getId()) == 0;
+      cities.push_back(state);
+    }
+
+  //the ruins start off unexplored, and hidden ones haven't been found.
+  std::vector<RuinState> ruins;
+  for (auto r: *rl)
+    {
+      RuinState state;
+      state.owner = r->getOwner();
+      state.searched = r->isSearched();
+      if (explored.count(r->getId()) > 0)
+        {
+          state.searched = false;
+          if (r->isHidden())
+            state.owner = NULL;
+        }
+      else if (r->isSearched() == false && r->isHidden())
+        state.owner = NULL;
+      ruins.push_back(state);
+    }
+
+  guint32 city_count[MAX_PLAYERS + 1] = {0};
+  city_count[neutral] = cities.size();
+  guint32 ruin_count[MAX_PLAYERS] = {0};
+
+  std::list<History*>::iterator hit[MAX_PLAYERS];
+  for (auto p: players)
+    hit[p->getId()] = p->getHistorylist()->begin();
+
+  d_city_turns.push_back(0);
+  d_ruin_turns.push_back(0);
+  d_event_turns.push_back(0);
+  unsigned int count = 0;
+  bool last_turn = false;
+  for (guint32 turn = 0; last_turn == false; turn++)
+    {
+      if (turn % KEYFRAME_INTERVAL == 0)
+        {
+          d_city_keyframes.push_back(cities);
+          d_ruin_keyframes.push_back(ruins);
+        }
+      bool advanced = false;
+      for (auto p: players)
+        {
+          //dump everything up to the next turn
+          guint32 id = p->getId();
+          std::list<History*>::iterator end = p->getHistorylist()->end();
+          if (hit[id] == end)
+            continue;
+          advanced = true;
+          for (; hit[id] != end; hit[id]++)
+            {
+              History *h = *hit[id];
+              if (h->getType() == History::START_TURN)
+                {
+                  hit[id]++;
+                  break;
+                }
+              switch (h->getType())
+                {
+                case History::CITY_WON:
+                case History::CITY_RAZED:
+                    {
+                      guint32 city_id = h->getType() == History::CITY_WON ?
+                        static_cast<History_CityWon*>(h)->getCityId() :
+                        static_cast<History_CityRazed*>(h)->getCityId();
+                      auto it = d_city_index.find(city_id);
+                      if (it == d_city_index.end())
+                        break;
+                      CityEvent event;
+                      event.city = (*it).second;
+                      event.razed = h->getType() == History::CITY_RAZED;
+                      event.owner = event.razed ? neutral : id;
+                      city_count[cities[event.city].owner]--;
+                      apply(event, cities);
+                      city_count[event.owner]++;
+                      d_city_events.push_back(event);
+                    }
+                  break;
+                case History::HERO_REWARD_RUIN:
+                case History::HERO_RUIN_EXPLORED:
+                    {
+                      guint32 ruin_id = h->getType() == History::HERO_REWARD_RUIN ?
+                        static_cast<History_HeroRewardRuin*>(h)->getRuinId() :
+                        static_cast<History_HeroRuinExplored*>(h)->getRuinId();
+                      auto it = d_ruin_index.find(ruin_id);
+                      if (it != d_ruin_index.end())
+                        {
+                          RuinEvent event;
+                          event.ruin = (*it).second;
+                          event.player = id;
+                          event.explored =
+                            h->getType() == History::HERO_RUIN_EXPLORED;
+                          if (event.explored && !ruins[event.ruin].searched)
+                            ruin_count[id]++;
+                          apply(event, ruins);
+                          d_ruin_events.push_back(event);
+                        }
+                      if (h->getType() == History::HERO_RUIN_EXPLORED)
+                        d_events.push_back(std::make_pair(h, id));
+                    }
+                  break;
+                case History::FOUND_SAGE:
+                case History::HERO_EMERGES:
+                case History::HERO_QUEST_STARTED:
+                case History::HERO_QUEST_COMPLETED:
+                case History::HERO_KILLED_IN_CITY:
+                case History::HERO_KILLED_IN_BATTLE:
+                case History::HERO_KILLED_SEARCHING:
+                case History::HERO_CITY_WON:
+                case History::HERO_FINDS_ALLIES:
+                case History::PLAYER_VANQUISHED:
+                case History::DIPLOMATIC_TREACHERY:
+                case History::DIPLOMATIC_WAR:
+                case History::DIPLOMATIC_PEACE:
+                case History::USE_ITEM:
+                  d_events.push_back(std::make_pair(h, id));
+                  break;
+                case History::START_TURN:
+                case History::GOLD_TOTAL:
+                case History::SCORE:
+                case History::END_TURN:
+                  break;
+                }
+            }
+          if (hit[id] == end)
+            {
+              count++;
+              if (count == pl->size() - 2)
+                last_turn = true;
+            }
+        }
+      if (!advanced)
+        last_turn = true;
+      d_city_turns.push_back(d_city_events.size());
+      d_ruin_turns.push_back(d_ruin_events.size());
+      d_event_turns.push_back(d_events.size());
+      for (auto p: players)
+        {
+          d_city_counts[p->getId()].push_back(city_count[p->getId()]);
+          d_ruin_counts[p->getId()].push_back(ruin_count[p->getId()]);
+        }
+    }
+  //the last turn is the one that's still going on.
+  d_turns = d_event_turns.size() - 2;
+  for (auto p: players)
+    {
+      d_city_counts[p->getId()].resize(d_turns);
+      d_ruin_counts[p->getId()].resize(d_turns);
+    }
+}
+
+void HistoryIndex::apply(const CityEvent &event, std::vector<CityState> &state) const
+{
+  state[event.city].owner = event.owner;
+  if (event.razed)
+    state[event.city].burnt = true;
+}
+
+void HistoryIndex::apply(const RuinEvent &event, std::vector<RuinState> &state) const
+{
+  if (event.explored)
+    state[event.ruin].searched = true;
+  else
+    state[event.ruin].owner = Playerlist::getInstance()->getPlayer(event.player);
+}
+
+void HistoryIndex::getCityStates(guint32 turn, std::vector<CityState> &state) const
+{
+  guint32 keyframe = turn / KEYFRAME_INTERVAL;
+  state = d_city_keyframes[keyframe];
+  for (size_t i = d_city_turns[keyframe * KEYFRAME_INTERVAL];
+       i < d_city_turns[turn + 1]; i++)
+    apply(d_city_events[i], state);
+}
+
+void HistoryIndex::getRuinStates(guint32 turn, std::vector<RuinState> &state) const
+{
+  guint32 keyframe = turn / KEYFRAME_INTERVAL;
+  state = d_ruin_keyframes[keyframe];
+  for (size_t i = d_ruin_turns[keyframe * KEYFRAME_INTERVAL];
+       i < d_ruin_turns[turn + 1]; i++)
+    apply(d_ruin_events[i], state);
+}
+
+LocationList<City*> *HistoryIndex::getCitylist(guint32 turn) const
+{
+  std::vector<CityState> state;
+  getCityStates(turn, state);
+  LocationList<City*> *clist = new LocationList<City*>();
+  guint32 i = 0;
+  for (auto c: *Citylist::getInstance())
+    {
+      City *city = new City(*c);
+      city->setOwner(Playerlist::getInstance()->getPlayer(state[i].owner));
+      city->setBurnt(state[i].burnt);
+      clist->push_back(city);
+      i++;
+    }
+  return clist;
+}
+
+LocationList<Ruin*> *HistoryIndex::getRuinlist(guint32 turn) const
+{
+  std::vector<RuinState> state;
+  getRuinStates(turn, state);
+  LocationList<Ruin*> *rlist = new LocationList<Ruin*>();
+  guint32 i = 0;
+  for (auto r: *Ruinlist::getInstance())
+    {
+      Ruin *ruin = new Ruin(*r);
+      ruin->setOwner(state[i].owner);
+      ruin->setSearched(state[i].searched);
+      rlist->push_back(ruin);
+      i++;
+    }
+  return rlist;
+}
+
+std::list<NetworkHistory*> HistoryIndex::getEvents(guint32 turn) const
+{
+  std::list<NetworkHistory*> events;
+  if (turn + 1 >= d_event_turns.size())
+    return events;
+  for (size_t i = d_event_turns[turn]; i < d_event_turns[turn + 1]; i++)
+    events.push_back(new NetworkHistory(d_events[i].first,
+                                        d_events[i].second));
+  return events;
+}
+
+std::list<guint32> HistoryIndex::getCityCounts(Player *p) const
+{
+  const std::vector<guint32> &v = d_city_counts[p->getId()];
+  return std::list<guint32>(v.begin(), v.end());
+}
+
+std::list<guint32> HistoryIndex::getRuinCounts(Player *p) const
+{
+  const std::vector<guint32> &v = d_ruin_counts[p->getId()];
+  return std::list<guint32>(v.begin(), v.end());
+}
+
+std::list<guint32> HistoryIndex::getGoldCounts(Player *p) const
+{
+  const std::vector<guint32> &v = d_gold_counts[p->getId()];
+  return std::list<guint32>(v.begin(), v.end());
+}
+
+std::list<guint32> HistoryIndex::getScores(Player *p) const
+{
+  const std::vector<guint32> &v = d_scores[p->getId()];
+  return std::list<guint32>(v.begin(), v.end());
+}
+
+// End of file
@@ -0,0 +1,149 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+#pragma once
+#ifndef HISTORY_INDEX_H
+#define HISTORY_INDEX_H
+
+#include <gtkmm.h>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "defs.h"
+#include "LocationList.h"
+
+class City;
+class Ruin;
+class Player;
+class History;
+class NetworkHistory;
+
+//! An index of every player's history, for looking back at past turns.
+/**
+ * The histories are walked once.  The city and ruin events that change the
+ * map go into arrays ordered by turn, and every few turns a keyframe of
+ * who owns each city and which ruins are searched is kept.  The map on any
+ * turn is rebuilt from the keyframe before it, in time proportional to the
+ * events in between.  The chart series are worked out during the walk.
+ *
+ * Turns are counted the way the history report has always counted them:
+ * a turn ends for a player at each History::START_TURN event, and the walk
+ * stops when all but one player have run out of history.
+ */
+class HistoryIndex
+{
+    public:
+
+	//! Walk the history of every player and index it.
+	HistoryIndex();
+
+	//! Destructor.
+        ~HistoryIndex() {};
+
+        //! Returns how many past turns there are to look at.
+        guint32 getNumberOfTurns() const {return d_turns;};
+
+        //! Make a copy of the cities as they were on the given turn.
+        LocationList<City*> *getCitylist(guint32 turn) const;
+
+        //! Make a copy of the ruins as they were on the given turn.
+        LocationList<Ruin*> *getRuinlist(guint32 turn) const;
+
+        //! Make copies of the events that happened on the given turn.
+        std::list<NetworkHistory*> getEvents(guint32 turn) const;
+
+        //! Returns how many cities the player had on each turn.
+        std::list<guint32> getCityCounts(Player *p) const;
+
+        //! Returns how many ruins the player had explored by each turn.
+        std::list<guint32> getRuinCounts(Player *p) const;
+
+        //! Returns the player's gold pieces at the end of each turn.
+        std::list<guint32> getGoldCounts(Player *p) const;
+
+        //! Returns the player's score at the end of each turn.
+        std::list<guint32> getScores(Player *p) const;
+
+    private:
+
+        //! A city changing hands, or being razed.
+        struct CityEvent
+          {
+            guint32 city; //index into the citylist
+            guint32 owner; //player id
+            bool razed;
+          };
+
+        //! A ruin being found, or being explored.
+        struct RuinEvent
+          {
+            guint32 ruin; //index into the ruinlist
+            guint32 player; //player id
+            bool explored;
+          };
+
+        struct CityState
+          {
+            guint32 owner;
+            bool burnt;
+          };
+
+        struct RuinState
+          {
+            Player *owner;
+            bool searched;
+          };
+
+        //! Take a keyframe every this many turns.
+        static const guint32 KEYFRAME_INTERVAL = 16;
+
+        void getCityStates(guint32 turn, std::vector<CityState> &state) const;
+        void getRuinStates(guint32 turn, std::vector<RuinState> &state) const;
+        void apply(const CityEvent &event, std::vector<CityState> &state) const;
+        void apply(const RuinEvent &event, std::vector<RuinState> &state) const;
+
+        guint32 d_turns;
+
+        //! Where the cities and ruins are in their lists, by id.
+        std::map<guint32, guint32> d_city_index;
+        std::map<guint32, guint32> d_ruin_index;
+
+        //! The events of each kind, ordered by turn.
+        std::vector<CityEvent> d_city_events;
+        std::vector<RuinEvent> d_ruin_events;
+        std::vector<std::pair<History*, guint32> > d_events;
+
+        //! Where each turn's events start, with one more for the end.
+        std::vector<size_t> d_city_turns;
+        std::vector<size_t> d_ruin_turns;
+        std::vector<size_t> d_event_turns;
+
+        //! The state before each KEYFRAME_INTERVAL'th turn.
+        std::vector<std::vector<CityState> > d_city_keyframes;
+        std::vector<std::vector<RuinState> > d_ruin_keyframes;
+
+        //! The chart series, by player id.
+        std::vector<guint32> d_city_counts[MAX_PLAYERS + 1];
+        std::vector<guint32> d_ruin_counts[MAX_PLAYERS + 1];
+        std::vector<guint32> d_gold_counts[MAX_PLAYERS + 1];
+        std::vector<guint32> d_scores[MAX_PLAYERS + 1];
+};
+
+#endif // HISTORY_INDEX_H
+
+// End of file
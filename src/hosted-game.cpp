@@ -34,12 +34,14 @@ HostedGame::HostedGame(AdvertisedGame *advertised_game)
   unresponsive = false;
   d_pid = 0;
   //watch out, not copying here.
-  d_advertised_game = advertised_game;
+  d_advertised_game = NULL;
+  setAdvertisedGame(advertised_game);
 }
 
 HostedGame::HostedGame(XML_Helper *helper)
 {
   unresponsive = false;
+  d_advertised_game = NULL;
   helper->getData(d_pid, "pid");
   helper->registerTag(AdvertisedGame::d_tag_name, 
 		      sigc::mem_fun(*this, &HostedGame::loadAdvertisedGame));
@@ -64,16 +66,21 @@ bool HostedGame::loadAdvertisedGame(Glib::ustring tag, XML_Helper *helper)
 {
   if (tag == AdvertisedGame::d_tag_name)
     {
-      d_advertised_game = new AdvertisedGame(helper);
+      setAdvertisedGame(new AdvertisedGame(helper));
       return true;
     }
   return false;
 }
 
+void HostedGame::setAdvertisedGame(AdvertisedGame *g)
+{
+  d_advertised_game = g;
+  if (g)
+    g->pinged.connect(sigc::mem_fun(*this, &HostedGame::on_pinged));
+}
+
 void HostedGame::ping()
 {
-  getAdvertisedGame()->pinged.connect
-    (sigc::mem_fun(*this, &HostedGame::on_pinged));
   getAdvertisedGame()->ping();
 }
 
@@ -81,4 +88,5 @@ void HostedGame::on_pinged(bool success)
 {
   if (!success)
     cannot_ping_game.emit(this);
+  pinged.emit(this, success);
 }
@@ -47,7 +47,7 @@ class HostedGame
 
 
         // Set Methods
-        void setAdvertisedGame(AdvertisedGame *g) {d_advertised_game = g;};
+        void setAdvertisedGame(AdvertisedGame *g);
         void setUnresponsive(bool resp) {unresponsive = resp;};
         void setPid(guint32 pid) {d_pid = pid;};
 
@@ -68,6 +68,7 @@ class HostedGame
         // Signals
   
         sigc::signal<void, HostedGame*> cannot_ping_game;
+        sigc::signal<void, HostedGame*, bool> pinged;
 
     private:
 
@@ -123,6 +123,23 @@ int main(int argc, char* argv[])
                 }
               kit.port = port;
 	    }
+	  else if (parameter == "--ready-fd")
+	    {
+	      i++;
+              if (i - 1 >= argc)
+		{
+                  std::cerr <<_("missing argument for --ready-fd") <<std::endl;
+		  exit(-1);
+                }
+	      char* error = 0;
+	      long fd = strtol(argv[i-1], &error, 10);
+	      if ((error && (*error != '\0')) || fd < 0)
+		{
+                  std::cerr <<_("invalid value for --ready-fd") <<std::endl;
+		  exit(-1);
+		}
+              kit.ready_fd = fd;
+	    }
 	  else if (parameter == "--turn")
 	    {
 	      i++;
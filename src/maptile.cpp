@@ -20,42 +20,14 @@
 
 #include "maptile.h"
 #include <iostream>
+#include <assert.h>
 #include "tileset.h"
-#include "MapBackpack.h"
-#include "stacktile.h"
 #include "army.h"
 #include "GameMap.h"
 
 Maptile::Maptile()
-        :Movable(Vector<int>(-1,-1)), d_index(0), d_building(NONE)
+ : d_tilestyle(NO_TILESTYLE), d_index(0), d_building(NONE)
 {
-    d_tileStyle = NULL;
-    d_stacktile = NULL;
-    d_backpack = NULL;
-}
-
-Maptile::Maptile(int x, int y, guint32 index)
-    :Movable (Vector<int>(x, y)), d_index(index), d_building(NONE)
-{
-    d_tileStyle = NULL;
-    d_stacktile = NULL;
-    d_backpack = NULL;
-}
-
-Maptile::Maptile(int x, int y, Tile::Type type)
-    : Movable (Vector<int>(x, y)), d_index(GameMap::getTileset()->lookupIndexByType (type)), d_building(NONE)
-{
-    d_tileStyle = NULL;
-    d_stacktile = NULL;
-    d_backpack = NULL;
-}
-
-Maptile::~Maptile()
-{
-  if (d_backpack)
-    delete d_backpack;
-  if (d_stacktile)
-    delete d_stacktile;
 }
 
 Gdk::RGBA Maptile::getColor() const
@@ -82,18 +54,17 @@ Gdk::RGBA Maptile::getThirdColor() const
   return (*ts)[d_index]->getSmallTile()->getThirdColor();
 }
 
-MapBackpack *Maptile::getBackpack()
+TileStyle *Maptile::getTileStyle() const
 {
-  if (!d_backpack)
-    d_backpack = new MapBackpack (getPos());
-  return d_backpack;
+  if (d_tilestyle == NO_TILESTYLE)
+    return NULL;
+  return GameMap::getTileset()->getTileStyle(d_tilestyle);
 }
 
-StackTile *Maptile::getStacks()
+void Maptile::setTileStyle(TileStyle *style)
 {
-  if (!d_stacktile)
-    d_stacktile = new StackTile (getPos());
-  return d_stacktile;
+  assert(style == NULL || style->getId() < NO_TILESTYLE);
+  d_tilestyle = style ? style->getId() : NO_TILESTYLE;
 }
 
 Tile::Type Maptile::getType() const
@@ -103,17 +74,17 @@ Tile::Type Maptile::getType() const
 
 guint32 Maptile::getMoves() const
 {
-    if (d_building == Maptile::CITY)
+    if (getBuilding() == Maptile::CITY)
         return 1;
-    else if (d_building == Maptile::ROAD)
+    else if (getBuilding() == Maptile::ROAD)
         return 1;
-    else if (d_building == Maptile::BRIDGE)
+    else if (getBuilding() == Maptile::BRIDGE)
         return 1;
 
     if ((*GameMap::getTileset())[d_index]->getType() == Tile::WATER)
       {
 	// if we're sailing and we're not on shore, then we move faster
-	if (d_tileStyle->getType() == TileStyle::INNERMIDDLECENTER)
+	if (getTileStyle()->getType() == TileStyle::INNERMIDDLECENTER)
 	  return (*GameMap::getTileset())[d_index]->getMoves() / 2;
       }
     return (*GameMap::getTileset())[d_index]->getMoves();
@@ -168,7 +139,7 @@ bool Maptile::isHillyTerrain()
 
 bool Maptile::hasLandBuilding() const
 {
-  switch (d_building)
+  switch (getBuilding())
     {
     case Maptile::NONE:
       return false;
@@ -190,7 +161,7 @@ bool Maptile::hasLandBuilding() const
 
 bool Maptile::hasWaterBuilding() const
 {
-  switch (d_building)
+  switch (getBuilding())
     {
     case Maptile::NONE:
       return false;
@@ -24,10 +24,8 @@
 
 #include <list>
 #include "Tile.h"
-#include "Movable.h"
 #include "SmallTile.h"
 #include "MapBackpack.h"
-class StackTile;
 
 //! A single tile on the game map.
 /** 
@@ -43,8 +41,12 @@ class StackTile;
  *
  * The GameMap contains on Maptile object for every cell of the map.
  *
+ * There can be millions of these on a big map, so a Maptile is packed into
+ * four bytes.  It doesn't know where it is on the map, and the stacks and
+ * the bags of items on the map are kept by GameMap, apart from the tiles.
+ *
  */
-class Maptile: public Movable
+class Maptile
 {
     public:
         //! Enumeration of all possible constructed objects on the maptile.
@@ -72,34 +74,13 @@ class Maptile: public Movable
 	};
 
 	//! Default constructor.
-        Maptile();
-
-	//! Default constructor.
-        /** 
-	 * Make a new Maptile.
-	 *
-         * @param x                The x position of the tile.
-         * @param y                The y position of the tile.
-         * @param type             The terrain type (index in the tileset).
-         *
-         * no tilestyle is set.
-         */
-        Maptile(int x, int y, guint32 type);
-
-	//! Slower constructor.
-        /** 
-	 * Make a new Maptile, but this time using the Tile::Type.
-	 *
-         * @param x                The x position of the tile.
-         * @param y                The y position of the tile.
-         * @param type             The terrain type enumeration Tile::Type.
-         *
-         * no tilestyle is set.
+        /**
+         * The tile is the first one in the tileset, and no tilestyle is set.
          */
-        Maptile(int x, int y, Tile::Type type);
+        Maptile();
 
 	//! Destructor.
-        ~Maptile();
+        ~Maptile() {};
 
         //! Set the type of the terrain (type is an index in the tileset).
         void setIndex(guint32 index);
@@ -111,7 +92,7 @@ class Maptile: public Movable
         guint32 getIndex() const {return d_index;}
 
         //! Get which building is on the maptile.
-        inline Building getBuilding() const {return d_building;}
+        inline Building getBuilding() const {return Building(d_building);}
 
         //! Get the number of moves needed to cross this maptile.
 	/**
@@ -138,15 +119,6 @@ class Maptile: public Movable
         //! Get the tile type (the type of the underlying terrain).
         Tile::Type getType() const;
 
-        //! Get the list of Item objects on this maptile.
-        MapBackpack *getBackpack();
-
-	//! Get the list of Stack objects on this maptile.
-	StackTile *getStacks();
-
-        //! Set the backpack for this tile.
-        void setBackpack(MapBackpack *bag) {if (getBackpack()) delete getBackpack(); d_backpack = bag;};
-        
 	//! Whether or not this map tile considered to be "open terrain".
 	/**
 	 *
@@ -186,36 +158,42 @@ class Maptile: public Movable
         bool hasWaterBuilding() const;
         //! Prints some debug information about this maptile.
 
-	bool d_blocked[8];
-
 	//! Get the TileStyle associated with this Maptile.
-	TileStyle * getTileStyle() const {return d_tileStyle;}
+	TileStyle * getTileStyle() const;
 
 	//! Set the TileStyle associated with this Maptile.
-	void setTileStyle(TileStyle *style) {d_tileStyle = style;}
+        /**
+         * The id of the style has to be lower than NO_TILESTYLE.
+         */
+	void setTileStyle(TileStyle *style);
 
 	static Maptile::Building buildingFromString(const Glib::ustring str);
 	static Glib::ustring buildingToString(const Maptile::Building bldg);
         static Glib::ustring buildingToFriendlyName(const guint32 bldg);
+        //! The value of d_tilestyle when no tilestyle is set.
+        /**
+         * TileStyle ids have to be lower than this to fit in a Maptile.
+         */
+        static const guint16 NO_TILESTYLE = 0xffff;
+
     private:
+
+	//! The look of the maptile.
+        /**
+         * This is the id of a TileStyle in GameMap::s_tileset.  Tilestyle
+         * ids are always less than 65535.
+         */
+        guint16 d_tilestyle;
+
 	//! The index of the Tile within the Tileset (GameMap::s_tileset).
 	/**
 	 * The Maptile has a type, in the form of a Tile.  This Tile is
 	 * identified by it's index within GameMap::s_tileset.
 	 */
-        guint32 d_index;
-
-	//! The look of the maptile.
-	TileStyle *d_tileStyle;
+        guint8 d_index;
 
 	//! The type of constructed object on this maptile.
-        Building d_building;
-
-	//! The list of pointers to items on this maptile.
-	MapBackpack *d_backpack;
-
-	//! The list of pointers to stacks on this maptile.
-	StackTile *d_stacktile;
+        guint8 d_building;
 };
 
 #endif // MAPTILE_H
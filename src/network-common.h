@@ -59,7 +59,9 @@ enum MessageType {
   MESSAGE_TYPE_CHANGE_NICKNAME = 19,
   MESSAGE_TYPE_GAME_MAY_BEGIN = 20,
   MESSAGE_TYPE_OFF_PLAYER = 21,
-  MESSAGE_TYPE_NEXT_PLAYER = 22
+  MESSAGE_TYPE_NEXT_PLAYER = 22,
+  MESSAGE_TYPE_REQUEST_STATS = 23, //local connections only
+  MESSAGE_TYPE_STATS = 24
 };
 
 #endif
@@ -109,7 +109,8 @@ bool NetworkConnection::on_got_input(Glib::IOCondition cond)
 }
 
 NetworkConnection::NetworkConnection(const Glib::RefPtr<Gio::SocketConnection> &c)
- : payload(NULL), d_host(""), d_port(0), d_stop(false),
+ : payload(NULL), d_host(""), d_port(0), d_stats(NULL), d_stats_queue(0),
+    d_stop(false),
     d_cancellable(Gio::Cancellable::create())
 {
   //okay, i've been asked to create a SERVER side network connection.
@@ -124,7 +125,8 @@ NetworkConnection::NetworkConnection(const Glib::RefPtr<Gio::SocketConnection> &
 }
 
 NetworkConnection::NetworkConnection()
- : payload(NULL), d_host(""), d_port(0), d_stop(false),
+ : payload(NULL), d_host(""), d_port(0), d_stats(NULL), d_stats_queue(0),
+    d_stop(false),
     d_cancellable(Gio::Cancellable::create())
 {
   client = Gio::SocketClient::create();
@@ -195,6 +197,8 @@ gssize NetworkConnection::on_payload_received(gssize len)
    */
   int type = payload[1];
   bool keep_going;
+  if (d_stats)
+    d_stats->messageReceived(type, MESSAGE_SIZE_BYTES + payload_size);
   if (type == MESSAGE_TYPE_SENDING_MAP)
     {
       Glib::ustring file = "clientnetwork" + SAVE_EXT;
@@ -270,6 +274,8 @@ void NetworkConnection::sendFileMessage(int type, const Glib::ustring filename)
       fclose (fileptr);
       wrote_all = out->write_all (buffer, bytesread, bytessent);
       free (buffer);
+      if (d_stats)
+        d_stats->messageSent(type, MESSAGE_HEADER_SIZE + bytesread);
     }
   File::erase(filename);
 }
@@ -301,6 +307,8 @@ bool NetworkConnection::sendMessage(int type, const Glib::ustring &pay)
       return false;
     }
   free (buf);
+  if (d_stats)
+    d_stats->messageSent(type, MESSAGE_HEADER_SIZE + pay.size());
   return wrote_all;
 }
   
@@ -334,24 +342,58 @@ void NetworkConnection::disconnect()
 }
 
 void NetworkConnection::queue_message(int type, const Glib::ustring &pay)
+{
+  queue_shared_message 
+    (type, std::shared_ptr<const Glib::ustring>(new Glib::ustring(pay)), true);
+}
+
+void NetworkConnection::sendShared(int type, std::shared_ptr<const Glib::ustring> pay)
+{
+  queue_shared_message (type, pay, true);
+}
+
+bool NetworkConnection::trySendShared(int type, std::shared_ptr<const Glib::ustring> pay)
+{
+  return queue_shared_message (type, pay, false);
+}
+
+bool NetworkConnection::queue_shared_message(int type, std::shared_ptr<const Glib::ustring> pay, bool wait)
 {
   std::unique_lock<std::mutex> lock (mutex);
 
-  while(messages.size() >= 256)
+  while(messages.size() >= MAX_QUEUED_MESSAGES)
     {
-      if (d_stop)
+      if (d_stop || !wait)
         break;
       cond_pop.wait(lock);
       if (d_stop)
         break;
     }
   if (d_stop)
-    return;
+    return false;
+  if (messages.size() >= MAX_QUEUED_MESSAGES)
+    return false;
   struct Message m;
   m.type = type;
   m.payload = pay;
   messages.push(m);
+  if (d_stats)
+    d_stats->queueDepth(d_stats_queue, messages.size());
   cond_push.notify_one();
+  return true;
+}
+
+void NetworkConnection::setStats(NetworkStats *stats)
+{
+  d_stats = stats;
+  if (d_stats)
+    d_stats_queue = d_stats->addQueue();
+}
+
+guint32 NetworkConnection::getQueueLength()
+{
+  std::unique_lock<std::mutex> lock (mutex);
+  return messages.size();
 }
 
 void NetworkConnection::send_queued_messages()
@@ -374,13 +416,15 @@ void NetworkConnection::send_queued_messages()
             break;
           struct Message m = messages.front();
           messages.pop();
+          if (d_stats)
+            d_stats->queueDepth(d_stats_queue, messages.size());
 
           if (d_stop)
             break;
           if (m.type == MESSAGE_TYPE_SENDING_MAP)
-            sendFileMessage (m.type, m.payload);
+            sendFileMessage (m.type, *m.payload);
           else
-            sendMessage (m.type, m.payload);
+            sendMessage (m.type, *m.payload);
           if (d_stop)
             break;
           cond_pop.notify_one();
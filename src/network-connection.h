@@ -23,12 +23,14 @@
 #include <config.h>
 
 #include <queue>
+#include <memory>
 #include <sigc++/signal.h>
 #include <glibmm.h>
 #include <giomm.h>
 #include <gtkmm.h>
 #include <glibmm/threads.h>
 #include "network-common.h"
+#include "network-stats.h"
 #include <mutex>
 #include <condition_variable>
 
@@ -53,6 +55,18 @@ public:
 
   void send(int type, const Glib::ustring &payload);
   void sendFile(int type, const Glib::ustring &filename);
+
+  //! Queue a payload that is shared with other connections, and wait for room.
+  void sendShared(int type, std::shared_ptr<const Glib::ustring> payload);
+
+  //! Queue a shared payload, but give up instead of waiting for room.
+  bool trySendShared(int type, std::shared_ptr<const Glib::ustring> payload);
+
+  //! How many messages are waiting to be written to the socket.
+  guint32 getQueueLength();
+
+  //! Count the messages that go over this connection in the given stats.
+  void setStats(NetworkStats *stats);
   Glib::ustring get_peer_hostname();
 
   void tear_down_connection(bool lockit = false);
@@ -78,6 +92,8 @@ private:
   int header_size;
   Glib::ustring d_host;
   guint32 d_port;
+  NetworkStats *d_stats;
+  guint32 d_stats_queue;
 
   std::mutex mutex;
   std::condition_variable cond_push;
@@ -90,8 +106,9 @@ private:
   struct Message
     {
       int type;
-      Glib::ustring payload;
+      std::shared_ptr<const Glib::ustring> payload;
     };
+  static const guint32 MAX_QUEUED_MESSAGES = 256;
   std::queue<struct Message> messages;
 
   void setup_connection();
@@ -102,6 +119,7 @@ private:
   bool on_connect_timeout();
 
   void queue_message(int type, const Glib::ustring &payload);
+  bool queue_shared_message(int type, std::shared_ptr<const Glib::ustring> payload, bool wait);
   bool sendMessage(int type, const Glib::ustring &payload);
   void sendFileMessage(int type, Glib::ustring filename);
 
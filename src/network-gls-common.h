@@ -35,7 +35,10 @@ enum GlsMessageType
   GLS_MESSAGE_REQUEST_RELOAD = 10, //from client
   GLS_MESSAGE_RELOADED = 11, //from server
   GLS_MESSAGE_COULD_NOT_RELOAD = 12, //from server
-  GLS_MESSAGE_REQUEST_TERMINATION = 13 //from client
+  GLS_MESSAGE_REQUEST_TERMINATION = 13, //from client
+  GLS_MESSAGE_REQUEST_GAME_LIST_SINCE = 14, //from client (lw host or client)
+  GLS_MESSAGE_GAME_LIST_UNCHANGED = 15, //from server
+  GLS_MESSAGE_VERSIONED_GAME_LIST = 16 //from server
 };
 
 #endif
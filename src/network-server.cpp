@@ -27,6 +27,7 @@
 #include "connection-manager.h"
 
 NetworkServer::NetworkServer()
+ : d_stats(NULL)
 {
   connections.clear();
 }
@@ -76,12 +77,31 @@ void NetworkServer::sendFile(void *c, int type, const Glib::ustring &payload)
   conn->sendFile(type, payload);
 }
 
+void NetworkServer::sendShared(void *c, int type, std::shared_ptr<const Glib::ustring> payload)
+{
+  NetworkConnection *conn = static_cast<NetworkConnection *>(c);
+  conn->sendShared(type, payload);
+}
+
+bool NetworkServer::trySendShared(void *c, int type, std::shared_ptr<const Glib::ustring> payload)
+{
+  NetworkConnection *conn = static_cast<NetworkConnection *>(c);
+  return conn->trySendShared(type, payload);
+}
+
+guint32 NetworkServer::getQueueLength(void *c)
+{
+  NetworkConnection *conn = static_cast<NetworkConnection *>(c);
+  return conn->getQueueLength();
+}
+
 bool NetworkServer::gotClientConnection(const Glib::RefPtr<Gio::SocketConnection>& c)
 {
   if (c) 
     {
       c->reference();
       NetworkConnection *conn = ConnectionManager::create_connection(c);
+      conn->setStats(d_stats);
       connections.push_back(conn);
 
       conn->connection_lost.connect
@@ -23,6 +23,7 @@
 #include <config.h>
 
 #include <map>
+#include <memory>
 #include <giomm.h>
 #include <giomm/socketservice.h>
 #include <glibmm.h>
@@ -31,6 +32,7 @@
 #include "network-common.h"
 
 class NetworkConnection;
+class NetworkStats;
 
 //! A helper class to GameServer.
 class NetworkServer
@@ -43,6 +45,12 @@ public:
   void startListening(int port);
   void send(void *conn, int type, const Glib::ustring &payload);
   void sendFile(void *c, int type, const Glib::ustring &payload);
+  void sendShared(void *conn, int type, std::shared_ptr<const Glib::ustring> payload);
+  bool trySendShared(void *conn, int type, std::shared_ptr<const Glib::ustring> payload);
+  guint32 getQueueLength(void *conn);
+
+  //! Count the messages on every connection we accept in the given stats.
+  void setStats(NetworkStats *stats) {d_stats = stats;};
   Glib::ustring get_hostname(void *conn);
   bool is_local_connection(void *conn);
 
@@ -60,6 +68,7 @@ private:
   
   Glib::RefPtr<Gio::SocketService> server;
   std::list<NetworkConnection *> connections;
+  NetworkStats *d_stats;
 };
 
 #endif
@@ -0,0 +1,197 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+//  02110-1301, USA.
+
+#include <sstream>
+#include "network-stats.h"
+#include "xmlhelper.h"
+
+Glib::ustring NetworkStats::d_tag = "networkstats";
+
+NetworkStats::NetworkStats()
+ : d_next_queue(0)
+{
+  reset();
+}
+
+void NetworkStats::reset()
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  d_sent.clear();
+  d_received.clear();
+  d_decoded.clear();
+  d_turns.clear();
+  d_turn_started_at.clear();
+  d_turns_cut_short.clear();
+  d_rounds.count = 0;
+  d_rounds.total = 0;
+  d_rounds.max = 0;
+  d_round_started_at = g_get_monotonic_time();
+  d_queues.clear();
+}
+
+void NetworkStats::add(Duration &d, double secs)
+{
+  d.count++;
+  d.total += secs;
+  if (secs > d.max)
+    d.max = secs;
+}
+
+void NetworkStats::messageSent(int type, guint32 bytes)
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  Counter &c = d_sent[type];
+  c.count++;
+  c.bytes += bytes;
+}
+
+void NetworkStats::messageReceived(int type, guint32 bytes)
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  Counter &c = d_received[type];
+  c.count++;
+  c.bytes += bytes;
+}
+
+guint32 NetworkStats::addQueue()
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  guint32 queue = d_next_queue++;
+  d_queues[queue].depth = 0;
+  d_queues[queue].max = 0;
+  return queue;
+}
+
+void NetworkStats::queueDepth(guint32 queue, guint32 depth)
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  //the queue might have been forgotten by a reset.
+  Queue &q = d_queues[queue];
+  q.depth = depth;
+  if (depth > q.max)
+    q.max = depth;
+}
+
+void NetworkStats::decoded(int type, double secs)
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  add(d_decoded[type], secs);
+}
+
+void NetworkStats::turnStarted(guint32 player_id)
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  d_turn_started_at[player_id] = g_get_monotonic_time();
+}
+
+void NetworkStats::turnFinished(guint32 player_id)
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  std::map<guint32, gint64>::iterator i = d_turn_started_at.find(player_id);
+  //we might hear about the end of a turn more than once.
+  if (i == d_turn_started_at.end())
+    return;
+  double secs = (g_get_monotonic_time() - (*i).second) / 1000000.0;
+  d_turn_started_at.erase(i);
+  add(d_turns[player_id], secs);
+}
+
+void NetworkStats::thinkTimeRanOut(guint32 player_id)
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  d_turns_cut_short[player_id]++;
+}
+
+void NetworkStats::roundFinished()
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  gint64 now = g_get_monotonic_time();
+  add(d_rounds, (now - d_round_started_at) / 1000000.0);
+  d_round_started_at = now;
+}
+
+bool NetworkStats::saveDuration(XML_Helper *helper, Glib::ustring tag, const Duration &d)
+{
+  bool retval = true;
+  retval &= helper->saveData(tag + "_count", d.count);
+  retval &= helper->saveData(tag + "_total", d.total);
+  retval &= helper->saveData(tag + "_max", d.max);
+  return retval;
+}
+
+bool NetworkStats::save(XML_Helper *helper) const
+{
+  std::unique_lock<std::mutex> lock (d_mutex);
+  bool retval = true;
+  retval &= helper->openTag(d_tag);
+  retval &= saveDuration(helper, "round", d_rounds);
+  for (auto &i: d_queues)
+    {
+      retval &= helper->openTag("queue");
+      retval &= helper->saveData("id", i.first);
+      retval &= helper->saveData("depth", i.second.depth);
+      retval &= helper->saveData("max_depth", i.second.max);
+      retval &= helper->closeTag();
+    }
+  for (auto &i: d_sent)
+    {
+      retval &= helper->openTag("sent");
+      retval &= helper->saveData("type", i.first);
+      retval &= helper->saveData("count", i.second.count);
+      retval &= helper->saveData("bytes", i.second.bytes);
+      retval &= helper->closeTag();
+    }
+  for (auto &i: d_received)
+    {
+      retval &= helper->openTag("received");
+      retval &= helper->saveData("type", i.first);
+      retval &= helper->saveData("count", i.second.count);
+      retval &= helper->saveData("bytes", i.second.bytes);
+      retval &= helper->closeTag();
+    }
+  for (auto &i: d_decoded)
+    {
+      retval &= helper->openTag("decoded");
+      retval &= helper->saveData("type", i.first);
+      retval &= saveDuration(helper, "time", i.second);
+      retval &= helper->closeTag();
+    }
+  for (auto &i: d_turns)
+    {
+      retval &= helper->openTag("turn");
+      retval &= helper->saveData("player", i.first);
+      retval &= saveDuration(helper, "time", i.second);
+      std::map<guint32, guint32>::const_iterator j = 
+        d_turns_cut_short.find(i.first);
+      guint32 cut_short = j == d_turns_cut_short.end() ? 0 : (*j).second;
+      retval &= helper->saveData("cut_short", cut_short);
+      retval &= helper->closeTag();
+    }
+  retval &= helper->closeTag();
+  return retval;
+}
+
+Glib::ustring NetworkStats::toString() const
+{
+  std::ostringstream os;
+  XML_Helper helper(&os);
+  helper.begin("1");
+  save(&helper);
+  return os.str();
+}
+
+// End of file
@@ -0,0 +1,137 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+//  02110-1301, USA.
+
+#pragma once
+#ifndef NETWORK_STATS_H
+#define NETWORK_STATS_H
+
+#include <config.h>
+
+#include <map>
+#include <mutex>
+#include <glibmm.h>
+
+class XML_Helper;
+
+//! Counters and timings for a networked game.
+/**
+ * GameServer and GameClient objects keep one of these to show where the
+ * time goes in a networked game: how long each player takes to finish a
+ * turn, how much goes over the wire for each MESSAGE_TYPE, how deep each
+ * connection's outgoing message queue gets, and how long it takes to decode the 
+ * actions and histories that come in.
+ *
+ * Messages are counted from the threads that write to the sockets, so
+ * every method takes a lock.
+ */
+class NetworkStats
+{
+    public:
+
+	//! The xml tag of this object when it is written out.
+        static Glib::ustring d_tag; 
+
+	//! Default constructor.
+        NetworkStats();
+
+	//! Destructor.
+        ~NetworkStats() {};
+
+	// Methods that operate on the class data and modify the class.
+
+        //! A message of the given type went out.
+        void messageSent(int type, guint32 bytes);
+
+        //! A message of the given type came in.
+        void messageReceived(int type, guint32 bytes);
+
+        //! Start keeping track of another outgoing message queue.
+        /**
+         * Returns the id to hand to queueDepth for the new queue.
+         */
+        guint32 addQueue();
+
+        //! The given outgoing message queue now has this many messages in it.
+        void queueDepth(guint32 queue, guint32 depth);
+
+        //! Decoding a message of the given type took this long.
+        void decoded(int type, double secs);
+
+        //! The given player has started a turn.
+        void turnStarted(guint32 player_id);
+
+        //! The given player has finished a turn.
+        void turnFinished(guint32 player_id);
+
+        //! The given computer player ran out of time to think on a turn.
+        void thinkTimeRanOut(guint32 player_id);
+
+        //! Every player has finished a turn.
+        void roundFinished();
+
+        //! Forget everything.
+        void reset();
+
+	// Methods that operate on the class data and do not modify the class.
+
+        //! Write the counters and timings out as xml.
+        bool save(XML_Helper *helper) const;
+
+        //! Return the counters and timings as an xml document.
+        Glib::ustring toString() const;
+
+    private:
+
+        struct Counter
+          {
+            guint32 count;
+            unsigned long int bytes;
+          };
+
+        struct Duration
+          {
+            guint32 count;
+            double total;
+            double max;
+          };
+
+        struct Queue
+          {
+            guint32 depth;
+            guint32 max;
+          };
+
+        static void add(Duration &d, double secs);
+        static bool saveDuration(XML_Helper *helper, Glib::ustring tag, 
+                               const Duration &d);
+
+	// DATA
+
+        mutable std::mutex d_mutex;
+        std::map<int, Counter> d_sent;
+        std::map<int, Counter> d_received;
+        std::map<int, Duration> d_decoded;
+        std::map<guint32, Duration> d_turns;
+        std::map<guint32, gint64> d_turn_started_at;
+        std::map<guint32, guint32> d_turns_cut_short;
+        Duration d_rounds;
+        gint64 d_round_started_at;
+        std::map<guint32, Queue> d_queues;
+        guint32 d_next_queue;
+};
+
+#endif // NETWORK_STATS_H
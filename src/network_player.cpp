@@ -668,7 +668,12 @@ void NetworkPlayer::decodeActionEquip(const Action_Equip *action)
   switch (action->getToBackpackOrToGround())
   {
   case Action_Equip::BACKPACK:
-    item = GameMap::getInstance()->getTile(action->getItemPos())->getBackpack()->getItemById(action->getItemId());
+    {
+      MapBackpack *bag =
+        GameMap::getInstance()->findBackpack(action->getItemPos());
+      if (bag)
+        item = bag->getItemById(action->getItemId());
+    }
     doHeroPickupItem(hero, item, action->getItemPos());
     break;
 
@@ -95,7 +95,8 @@ Player::Player(Glib::ustring name, guint32 armyset, Gdk::RGBA color, int width,
 	       int height, Type type, int player_no)
     :d_color(color), d_name(name), d_armyset(armyset), d_gold(1000),
     d_dead(false), d_immortal(false), d_type(type), d_upkeep(0), d_income(0),
-    d_observable(true), surrendered(false), abort_requested(false)
+    d_observable(true), surrendered(false), abort_requested(false),
+    d_think_deadline(0), d_out_of_think_time(false)
 {
     if (player_no != -1)
 	d_id = player_no;
@@ -129,7 +130,8 @@ Player::Player(const Player& player)
     d_immortal(player.d_immortal), d_type(player.d_type), d_id(player.d_id),
     d_fight_order(player.d_fight_order), d_upkeep(player.d_upkeep),
     d_income(player.d_income), d_observable(player.d_observable),
-    surrendered(player.surrendered),abort_requested(player.abort_requested)
+    surrendered(player.surrendered),abort_requested(player.abort_requested),
+    d_think_deadline(0), d_out_of_think_time(false)
 {
   // as the other player is propably dumped somehow, we need to deep copy
   // everything.
@@ -168,7 +170,8 @@ Player::Player(const Player& player)
 }
 
 Player::Player(XML_Helper* helper)
-    :d_stacklist(0), d_fogmap(0), surrendered(false), abort_requested(false)
+    :d_stacklist(0), d_fogmap(0), surrendered(false), abort_requested(false),
+    d_think_deadline(0), d_out_of_think_time(false)
 {
     helper->getData(d_id, "id");
     helper->getData(d_name, "name");
@@ -1105,7 +1108,8 @@ bool Player::computerSearch(Stack *s, MoveResult *r)
 
   Maptile *tile = GameMap::getInstance()->getTile(s->getPos());
 
-  if (tile->getBackpack()->size() > 0)
+  MapBackpack *backpack = GameMap::getInstance()->findBackpack(s->getPos());
+  if (backpack && backpack->size() > 0)
     {
       if (computerChoosePickupBag(s, s->getPos(), 0, 0) == true)
         {
@@ -1964,7 +1968,7 @@ void Player::doHeroDropItem(Hero *h, Item *i, Vector<int> pos, bool &splash)
     }
   else
     {
-      GameMap::getInstance()->getTile(pos)->getBackpack()->addToBackpack(i);
+      GameMap::getBackpack(pos)->addToBackpack(i);
       h->getBackpack()->removeFromBackpack(i);
       splash = false;
     }
@@ -1995,9 +1999,11 @@ bool Player::doHeroDropAllItems(Hero *h, Vector<int> pos, bool &splash)
 
 void Player::doHeroPickupItem(Hero *h, Item *i, Vector<int> pos)
 {
-  bool found = GameMap::getInstance()->getTile(pos)->getBackpack()->removeFromBackpack(i);
+  MapBackpack *backpack = GameMap::getInstance()->findBackpack(pos);
+  bool found = backpack && backpack->removeFromBackpack(i);
   if (found)
     h->getBackpack()->addToBackpack(i);
+  GameMap::releaseBackpack(pos);
   supdatingStack.emit(0);
 }
 
@@ -2010,17 +2016,24 @@ bool Player::heroPickupItem(Hero *h, Item *i, Vector<int> pos)
 
 bool Player::doHeroPickupAllItems(Hero *h, Vector<int> pos)
 {
-  MapBackpack *backpack = GameMap::getInstance()->getTile(pos)->getBackpack();
-  while (backpack->empty() == false)
-    doHeroPickupItem(h, backpack->front(), pos);
+  //the bag goes away once it's empty.
+  MapBackpack *backpack = GameMap::getInstance()->findBackpack(pos);
+  while (backpack && backpack->empty() == false)
+    {
+      doHeroPickupItem(h, backpack->front(), pos);
+      backpack = GameMap::getInstance()->findBackpack(pos);
+    }
   return true;
 }
 
 bool Player::heroPickupAllItems(Hero *h, Vector<int> pos)
 {
-  MapBackpack *backpack = GameMap::getInstance()->getTile(pos)->getBackpack();
-  while (backpack->empty() == false)
-    heroPickupItem(h, backpack->front(), pos);
+  MapBackpack *backpack = GameMap::getInstance()->findBackpack(pos);
+  while (backpack && backpack->empty() == false)
+    {
+      heroPickupItem(h, backpack->front(), pos);
+      backpack = GameMap::getInstance()->findBackpack(pos);
+    }
   return true;
 }
 
@@ -2222,7 +2235,7 @@ bool Player::heroPlantStandard(Stack* s)
 void Player::doHeroPlantStandard(Hero *hero, Item *item, Vector<int> pos)
 {
   item->setPlanted(true);
-  GameMap::getInstance()->getTile(pos)->getBackpack()->addToBackpack(item);
+  GameMap::getBackpack(pos)->addToBackpack(item);
   hero->getBackpack()->removeFromBackpack(item);
   supdatingStack.emit(0);
 }
@@ -3189,15 +3202,50 @@ bool Player::AI_maybeVector(City *c, guint32 safe_mp, guint32 min_defenders,
   if (c->getActiveProductionSlot() == -1)
     return false;
 
-  //is it safe to vector from this city?
-  bool safe = safeFromAttack(c, safe_mp, min_defenders);
+  VectoringPlan plan;
+  return AI_maybeVector(c, safeFromAttack(c, safe_mp, min_defenders), target,
+                        vector_city, plan);
+}
+
+guint32 Player::AI_turnsToCity(City *c, const ArmyProdBase *proto,
+                               City *target, VectoringPlan &plan)
+{
+  std::vector<guint32> key;
+  key.push_back(c->getId());
+  key.push_back(target->getId());
+  key.push_back(proto->getArmyset());
+  key.push_back(proto->getTypeId());
+  std::map<std::vector<guint32>, guint32>::iterator i = plan.turns.find(key);
+  if (i != plan.turns.end())
+    return (*i).second;
+
+  PathCalculator pc(c->getOwner(), c->getPos(), proto);
+  guint32 moves = 0, turns = 0, left = 0;
+  Path *p = pc.calculate(target->getPos(), moves, turns, left);
+  if (p)
+    delete p;
+  plan.turns[key] = turns;
+  return turns;
+}
+
+bool Player::AI_maybeVector(City *c, bool safe, City *target,
+                            City **vector_city, VectoringPlan &plan)
+{
+  assert (c->getOwner() == this);
+  if (vector_city)
+    *vector_city = NULL;
+
+  //is this city producing anything that we can vector?
+  if (c->getActiveProductionSlot() == -1)
+    return false;
 
+  //is it safe to vector from this city?
   if (!safe)
     return false;
 
   //get the nearest city to the enemy city that can accept vectored units
   City *near_city =
-    Citylist::getInstance()->getNearestFriendlyVectorableCity(target->getPos());
+    Citylist::getInstance()->getNearestFriendlyVectorableCity(target);
   if (!near_city)
     return false;
   assert (near_city->getOwner() == this);
@@ -3228,18 +3276,11 @@ bool Player::AI_maybeVector(City *c, guint32 safe_mp, guint32 min_defenders,
 
   //find turns from source to target city
   const ArmyProdBase *proto = c->getActiveProductionBase();
-  PathCalculator pc1(c->getOwner(), c->getPos(), proto);
-  guint32 moves1 = 0, turns1 = 0, left1 = 0;
-  guint32 moves2 = 0, turns2 = 0, left2 = 0;
-  Path *p = pc1.calculate(target->getPos(), moves1, turns1, left1);
-  if (p)
-    delete p;
+  guint32 turns1 = AI_turnsToCity(c, proto, target, plan);
 
-  //find turns from nearer vectorable city to target city
-  PathCalculator pc2(c->getOwner(), near_city->getPos(), proto);
-  p = pc2.calculate(target->getPos(), moves2, turns2, left2);
-  if (p)
-    delete p;
+  //find turns from nearer vectorable city to target city.
+  //lots of our cities pick the same one, so this is usually in the plan.
+  guint32 turns2 = AI_turnsToCity(near_city, proto, target, plan);
   turns2+=VectoredUnit::get_travel_turns(near_city->getPos(), target->getPos());
   if (turns1 <= turns2)
     return false;
@@ -3252,9 +3293,47 @@ bool Player::AI_maybeVector(City *c, guint32 safe_mp, guint32 min_defenders,
   return true;
 }
 
+void Player::AI_planFronts(VectoringPlan &plan)
+{
+  Citylist *cl = Citylist::getInstance();
+  for (auto c: *cl)
+    {
+      if (c->getOwner() != this || c->isBurnt())
+	continue;
+      City *enemy_city = cl->getNearestEnemyCity(c);
+      plan.front[c->getId()] = enemy_city;
+      if (!enemy_city)
+        continue;
+      PathCalculator pc(this, c->getPos());
+      plan.mp_to_front[c->getId()] = pc.calculate(enemy_city->getPos());
+    }
+}
+
+bool Player::safeFromAttack(City *c, const VectoringPlan &plan, 
+                            guint32 safe_mp, guint32 min_defenders)
+{
+  //this is safeFromAttack(c, safe_mp, min_defenders) without the search.
+  std::map<guint32, int>::const_iterator i = plan.mp_to_front.find(c->getId());
+  if (i == plan.mp_to_front.end())
+    return false;
+  int mp = (*i).second;
+  if (mp <= 0 || mp >= (int)safe_mp)
+    {
+      if (c->countDefenders() >= min_defenders)
+        return true;
+    }
+  return false;
+}
+
 void Player::AI_setupVectoring(guint32 safe_mp, guint32 min_defenders,
 			       guint32 mp_to_front)
 {
+  //work out where the front is from each of our cities in one go.
+  //everything below is decided from it, and cities don't change hands
+  //while we're setting up vectoring.
+  VectoringPlan plan;
+  AI_planFronts(plan);
+
   //turn off vectoring where it isn't safe anymore
   //turn off vectoring for destinations that are far away from the
   //nearest enemy city
@@ -3267,7 +3346,7 @@ void Player::AI_setupVectoring(guint32 safe_mp, guint32 min_defenders,
       Vector<int> dest = c->getVectoring();
       if (dest == Vector<int>(-1, -1))
 	continue;
-      if (safeFromAttack(c, safe_mp, min_defenders) == false)
+      if (safeFromAttack(c, plan, safe_mp, min_defenders) == false)
 	{
 	  //City *target_city = Citylist::getInstance()->getObjectAt(dest);
 	  //debug("stopping vectoring from " << c->getName() <<" to " << target_city->getName() << " because it's not safe to anymore!\n")
@@ -3275,7 +3354,15 @@ void Player::AI_setupVectoring(guint32 safe_mp, guint32 min_defenders,
 	  continue;
 	}
 
-      City *enemy_city = Citylist::getInstance()->getNearestEnemyCity(dest);
+      //we usually vector to one of our own cities, and the plan has that.
+      City *dest_city = GameMap::getCity(dest);
+      bool planned = dest_city && dest_city->getPos() == dest &&
+        plan.front.find(dest_city->getId()) != plan.front.end();
+      City *enemy_city = NULL;
+      if (planned)
+        enemy_city = plan.front[dest_city->getId()];
+      else
+        enemy_city = Citylist::getInstance()->getNearestEnemyCity(dest);
       if (!enemy_city)
 	{
 	  //City *target_city = Citylist::getInstance()->getObjectAt(dest);
@@ -3284,8 +3371,14 @@ void Player::AI_setupVectoring(guint32 safe_mp, guint32 min_defenders,
 	  continue;
 	}
 
-      PathCalculator pc(this, dest, NULL);
-      int mp = pc.calculate(enemy_city->getPos());
+      int mp = 0;
+      if (planned)
+        mp = plan.mp_to_front[dest_city->getId()];
+      else
+        {
+          PathCalculator pc(this, dest, NULL);
+          mp = pc.calculate(enemy_city->getPos());
+        }
       if (mp <= 0 || mp > (int)mp_to_front)
 	{
 
@@ -3301,15 +3394,16 @@ void Player::AI_setupVectoring(guint32 safe_mp, guint32 min_defenders,
       sbusy.emit();
       if (c->getOwner() != this || c->isBurnt())
 	continue;
-      City *enemy_city = Citylist::getInstance()->getNearestEnemyCity(c->getPos());
+      City *enemy_city = plan.front[c->getId()];
       if (!enemy_city)
 	continue;
       City *vector_city = NULL;
       //if the city isn't already vectoring
       if (c->getVectoring() == Vector<int>(-1,-1))
 	{
-	  bool vectored = AI_maybeVector(c, safe_mp, min_defenders, enemy_city,
-					 &vector_city);
+	  bool vectored = 
+            AI_maybeVector(c, safeFromAttack(c, plan, safe_mp, min_defenders),
+                           enemy_city, &vector_city, plan);
 	  if (vectored)
             {
               debug("begin vectoring from " << c->getName() <<" to " << vector_city->getName() << "!\n");
@@ -3418,6 +3512,12 @@ bool Player::vectoredUnitArrives(VectoredUnit *unit)
   return true;
 }
 
+void Player::vectoredUnitsArrive(const std::list<VectoredUnit*> &units)
+{
+  for (auto v: units)
+    vectoredUnitArrives(v);
+}
+
 std::list<Action_Produce *> Player::getUnitsProducedThisTurn() const
 {
   std::list<Action_Produce *> actions;
@@ -3813,6 +3913,24 @@ void Player::setSurrendered(bool surr)
   surrendered = surr;
 }
 
+void Player::startThinking(guint32 secs)
+{
+  d_out_of_think_time = false;
+  if (secs)
+    d_think_deadline = g_get_monotonic_time() + secs * G_GINT64_CONSTANT(1000000);
+  else
+    d_think_deadline = 0;
+}
+
+bool Player::isOutOfThinkTime()
+{
+  if (d_out_of_think_time)
+    return true;
+  if (d_think_deadline && g_get_monotonic_time() >= d_think_deadline)
+    d_out_of_think_time = true;
+  return d_out_of_think_time;
+}
+
 std::list<Hero*> Player::getHeroes() const
 {
   return d_stacklist->getHeroes();
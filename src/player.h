@@ -26,6 +26,7 @@
 #define PLAYER_H
 
 #include <list>
+#include <map>
 #include <vector>
 #include <sigc++/trackable.h>
 #include <sigc++/signal.h>
@@ -246,6 +247,9 @@ class Player: public sigc::trackable
         //! Returns the list of player's events. 
         std::list<History*>* getHistorylist() {return &d_history;}
 
+        //! Returns how many actions the player has taken since the last dump.
+        guint32 countActions() const {return d_actions.size();}
+
         //! Return the Id of the player's Armyset.
         guint32 getArmyset() const {return d_armyset;}
 
@@ -305,6 +309,9 @@ class Player: public sigc::trackable
 
         bool abortRequested() const {return abort_requested;};
 
+        //! Whether or not the player stopped thinking early this turn.
+        bool ranOutOfThinkTime() const {return d_out_of_think_time;};
+
 	// Methods that operate on the player's action list.
 
 	//! Returns a list of the players unit production actions for this turn.
@@ -993,6 +1000,12 @@ class Player: public sigc::trackable
 	//! A player has a vectored army unit arrive somewhere.
 	bool vectoredUnitArrives(VectoredUnit *unit);
 
+	//! A player has a batch of vectored army units arrive.
+	/**
+	 * The units come in the order they were vectored in.
+	 */
+	void vectoredUnitsArrive(const std::list<VectoredUnit*> &units);
+
 	//! Shut down a city's production due to insufficent funds.
 	void cityTooPoorToProduce(City *city, int slot);
 
@@ -1052,6 +1065,19 @@ class Player: public sigc::trackable
 
         virtual void abortTurn() = 0;
 
+        /**
+         * A computer player makes the moves that matter most, and that are
+         * cheapest to work out, first.  When the time is up it stops and
+         * ends the turn with the moves it has made so far.
+         *
+         * @param secs  How many seconds the player gets, or 0 for no limit.
+         */
+        //! Start the clock on how long the player may think this turn.
+        void startThinking(guint32 secs);
+
+        //! Whether or not the time to think about this turn has run out.
+        bool isOutOfThinkTime();
+
         /** 
 	 * This function is called before a player's turn starts.
          * The idea here is that it happens before heroes are recruited,
@@ -1612,6 +1638,12 @@ class Player: public sigc::trackable
         //! Whether or not someone has closed the main game window.
         bool abort_requested;
 
+        //! When the player has to stop thinking this turn, or 0 for never.
+        gint64 d_think_deadline;
+
+        //! Whether or not the player stopped thinking early this turn.
+        bool d_out_of_think_time;
+
 	//! assists in scorekeeping for diplomacy
 	void alterDiplomaticRelationshipScore (Player *player, int amount);
 
@@ -1712,6 +1744,31 @@ class Player: public sigc::trackable
         //! Loads the subdata of a player (actions and stacklist)
         bool load(Glib::ustring tag, XML_Helper* helper);
 
+        //! What AI_setupVectoring has already worked out this turn.
+        struct VectoringPlan
+          {
+            //! The nearest enemy city to each of our cities, by city id.
+            std::map<guint32, City*> front;
+            //! How many movement points it takes a scout to get there.
+            std::map<guint32, int> mp_to_front;
+            //! Turns to a city, by source city, target city, and army type.
+            std::map<std::vector<guint32>, guint32> turns;
+          };
+
+        //! Fill in the fronts for all of our cities.
+        void AI_planFronts(VectoringPlan &plan);
+
+        //! Whether it's safe to vector from a city, going by the plan.
+        static bool safeFromAttack(City *c, const VectoringPlan &plan,
+                                   guint32 safe_mp, guint32 min_defenders);
+
+        //! How many turns it takes the given army type to get to a city.
+        guint32 AI_turnsToCity(City *c, const ArmyProdBase *proto,
+                               City *target, VectoringPlan &plan);
+
+        bool AI_maybeVector(City *c, bool safe, City *target,
+                            City **vector_city, VectoringPlan &plan);
+
         /**
 	 * Returns all heroes in the given list of stacks.
          *
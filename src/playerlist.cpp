@@ -727,6 +727,27 @@ guint32 Playerlist::turnHumansIntoNetworkPlayers()
   return count;
 }
 
+guint32 Playerlist::turnEveryoneIntoNetworkPlayers()
+{
+  guint32 count = 0;
+  std::list<Player*> p;
+  for (iterator i = begin(); i != end(); i++)
+    {
+      if (*i != d_neutral && (*i)->getType() != Player::NETWORKED)
+	{
+          count++;
+	  NetworkPlayer *new_p = new NetworkPlayer(**i);
+          p.push_back(*i);
+	  swap((*i), new_p);
+	  i = begin();
+	  continue;
+	}
+    }
+  for (std::list<Player*>::iterator j = p.begin(); j != p.end(); j++)
+    delete *j;
+  return count;
+}
+
 guint32 Playerlist::turnHumansInto(Player::Type type, int number_of_players)
 {
   int count = 0;
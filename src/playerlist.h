@@ -176,6 +176,9 @@ class Playerlist : public std::list<Player*>, public sigc::trackable
 	//! Converts all of the human players into network players.
 	guint32 turnHumansIntoNetworkPlayers();
 
+	//! Converts all of the players but the neutral into network players.
+	guint32 turnEveryoneIntoNetworkPlayers();
+
 	//! Converts a given number of the human players into a type of player.
 	guint32 turnHumansInto(Player::Type type, int num_players = -1);
 
@@ -140,14 +140,13 @@ void Shield::instantiateImages(Shieldset *s, bool &broken)
     {
       if ((*it)->getImageName().empty() == false)
         {
-          Glib::ustring pngfile = t.getFile((*it)->getImageName() + ".png", 
-                                          broken);
-          if (broken == false)
-            {
-              (*it)->instantiateImages(pngfile, s, broken);
-              File::erase(pngfile);
-            }
+          const std::string *data = 
+            t.getFileContents((*it)->getImageName() + ".png");
+          if (data)
+            (*it)->instantiateImages(data, s, broken);
           else
+            broken = true;
+          if (broken)
             return;
         }
       count++;
@@ -122,6 +122,32 @@ void ShieldStyle::instantiateImages(Glib::ustring filename, Shieldset *s, bool &
 
   int xsize = 0;
   int ysize = 0;
+  getImageSize(s, xsize, ysize);
+  if (xsize > 0 && ysize > 0)
+    {
+      PixMask::scale(half[0], xsize, ysize);
+      PixMask::scale(half[1], xsize, ysize);
+      setImage(half[0]);
+      setMask(half[1]);
+    }
+}
+
+void ShieldStyle::instantiateImages(const std::string *data, Shieldset *s, bool &broken)
+{
+  int xsize = 0;
+  int ysize = 0;
+  getImageSize(s, xsize, ysize);
+  if (xsize <= 0 || ysize <= 0)
+    return;
+  std::vector<PixMask* > half = load_row(data, 2, broken, xsize, ysize);
+  if (broken)
+    return;
+  setImage(half[0]);
+  setMask(half[1]);
+}
+
+void ShieldStyle::getImageSize(Shieldset *s, int &xsize, int &ysize) const
+{
   switch (getType())
     {
     case ShieldStyle::SMALL:
@@ -131,13 +157,6 @@ void ShieldStyle::instantiateImages(Glib::ustring filename, Shieldset *s, bool &
     case ShieldStyle::LARGE:
       xsize = s->getLargeWidth(); ysize = s->getLargeHeight(); break;
     }
-  if (xsize > 0 && ysize > 0)
-    {
-      PixMask::scale(half[0], xsize, ysize);
-      PixMask::scale(half[1], xsize, ysize);
-      setImage(half[0]);
-      setMask(half[1]);
-    }
 }
 
 void ShieldStyle::uninstantiateImages()
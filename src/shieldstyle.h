@@ -107,6 +107,9 @@ class ShieldStyle : public sigc::trackable
 	//! Load the images for this shieldstyle from the given file.
 	void instantiateImages(Glib::ustring filename, Shieldset *s, bool &broke);
 
+	//! Load the images for this shieldstyle from a picture in memory.
+	void instantiateImages(const std::string *data, Shieldset *s, bool &broke);
+
 	//! Destroy the images associated with this shieldstyle.
 	void uninstantiateImages();
 
@@ -116,6 +119,9 @@ class ShieldStyle : public sigc::trackable
 	//! Save the shieldstyle to an opened shieldset configuration file.
 	bool save(XML_Helper *helper) const;
 
+	//! Get the size that the shieldset wants this kind of shield to be.
+	void getImageSize(Shieldset *s, int &xsize, int &ysize) const;
+
 
 	// Static Methods
 	
@@ -0,0 +1,81 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+//  02110-1301, USA.
+
+#pragma once
+#ifndef SORTEDVIEW_H
+#define SORTEDVIEW_H
+
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <stddef.h>
+
+//! A list of items ordered by a key that is worked out once per item.
+/**
+ * Items are added along with their key, and then sorted in one go.  Items
+ * with the same key stay in the order they were added, so this can stand
+ * in for a stable sort.  When only the first few items are wanted, sort()
+ * can be told how many, and the rest are left in no particular order.
+ */
+template <typename Key, typename T>
+class SortedView
+{
+    public:
+
+        //! Add an item with the given key.
+        void add(Key key, T item)
+          {d_entries.push_back(Entry(key, d_entries.size(), item));}
+
+        //! Order the items by key, lowest first.
+        /**
+         * @param count  Only the first count items need to be in order.
+         */
+        void sort(size_t count = (size_t)-1)
+          {
+            if (count >= d_entries.size())
+              std::sort(d_entries.begin(), d_entries.end());
+            else
+              std::partial_sort(d_entries.begin(), d_entries.begin() + count,
+                                d_entries.end());
+          }
+
+        //! Returns how many items are in the view.
+        size_t size() const {return d_entries.size();}
+
+        //! Returns the item at the given place.
+        T operator[](size_t i) const {return std::get<2>(d_entries[i]);}
+
+        //! Returns the key of the item at the given place.
+        Key getKey(size_t i) const {return std::get<0>(d_entries[i]);}
+
+        //! Append the first count items in order to the given container.
+        template <typename Container>
+        void copyTo(Container &items, size_t count = (size_t)-1) const
+          {
+            for (size_t i = 0; i < d_entries.size() && i < count; i++)
+              items.push_back(std::get<2>(d_entries[i]));
+          }
+
+    private:
+        // the key, then the order it was added in to break ties.
+        typedef std::tuple<Key, size_t, T> Entry;
+        std::vector<Entry> d_entries;
+};
+
+#endif // SORTEDVIEW_H
+
+// End of file
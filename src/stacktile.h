@@ -44,10 +44,8 @@ struct StackTileRecord
  * The stacktile object is not saved to disk, instead it is reconstituted 
  * based on the loading of stacklists.
  *
- * Like map backpack objects that exist on every tile, whether they have any 
- * items in them or not, a stacktile object exists on every tile whether any 
- * stacks are present or not.  the parent object in both cases is the maptile 
- * object.
+ * Game map only keeps stacktile objects for the tiles that have stacks on
+ * them, like it does with map backpack objects and items.
  *
  * A stack doesn't know what stacktile it's in but it knows Where it is on the 
  * map.  game map has a quick lookup of position to stacktile.
@@ -22,6 +22,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <fstream>
+#include <algorithm>
 #include "File.h"
 #include <errno.h>
 #include "ucompose.hpp"
@@ -38,13 +39,117 @@
  * using saveFile.  the file gets saved out N seperate times.
  *
  * this class was originally implemented with libtar.
+ *
+ * reading is the common case though, so the first time we're asked about
+ * what's in the archive we go through it once and keep the names and
+ * contents of the files in memory.
  */
 Tar_Helper::Tar_Helper(Glib::ustring file, std::ios::openmode mode, bool &broken)
+ : d_indexed(false), d_indexed_contents(false)
 {
   t = NULL;
   broken = Open(file, mode);
 }
 
+void Tar_Helper::clearIndex()
+{
+  d_names.clear();
+  d_contents.clear();
+  d_indexed = false;
+  d_indexed_contents = false;
+}
+
+bool Tar_Helper::index(bool contents)
+{
+  if (d_indexed && (d_indexed_contents || !contents))
+    return true;
+  if ((openmode & std::ios::in) == 0)
+    return false;
+  clearIndex();
+  reopen(this);
+  if (!t)
+    return false;
+  struct archive_entry *entry = NULL;
+  while (1) 
+    {
+      int r = archive_read_next_header(t, &entry);
+      if (r == ARCHIVE_EOF)
+        break;
+      if (r != ARCHIVE_OK)
+        break;
+      Glib::ustring name = archive_entry_pathname(entry);
+      d_names.push_back(name);
+      if (!contents)
+        continue;
+      //when a name is in there twice, the first one wins.
+      if (d_contents.find(name) != d_contents.end())
+        continue;
+      std::string &data = d_contents[name];
+      if (archive_entry_size(entry) > 0)
+        data.reserve(archive_entry_size(entry));
+      char buff[8192];
+      ssize_t len = archive_read_data(t, buff, sizeof (buff));
+      while (len > 0)
+        {
+          data.append(buff, len);
+          len = archive_read_data(t, buff, sizeof (buff));
+        }
+    }
+  d_indexed = true;
+  d_indexed_contents = contents;
+  return true;
+}
+
+const std::string *Tar_Helper::getFileContents(Glib::ustring filename)
+{
+  if (index(true) == false)
+    return NULL;
+  std::map<Glib::ustring, std::string>::const_iterator i = 
+    d_contents.find(filename);
+  if (i == d_contents.end())
+    return NULL;
+  return &(*i).second;
+}
+
+std::map<Glib::ustring, std::string> Tar_Helper::readFiles(const std::list<Glib::ustring> &filenames)
+{
+  std::map<Glib::ustring, std::string> files;
+  if ((openmode & std::ios::in) == 0)
+    return files;
+  reopen(this);
+  if (!t)
+    return files;
+  struct archive_entry *entry = NULL;
+  while (files.size() < filenames.size())
+    {
+      int r = archive_read_next_header(t, &entry);
+      if (r == ARCHIVE_EOF)
+        break;
+      if (r != ARCHIVE_OK)
+        break;
+      Glib::ustring name = archive_entry_pathname(entry);
+      //when a name is in there twice, the first one wins.
+      if (files.find(name) != files.end() ||
+          std::find(filenames.begin(), filenames.end(), name) == 
+          filenames.end())
+        {
+          archive_read_data_skip(t);
+          continue;
+        }
+      std::string &data = files[name];
+      if (archive_entry_size(entry) > 0)
+        data.reserve(archive_entry_size(entry));
+      char buff[8192];
+      ssize_t len = archive_read_data(t, buff, sizeof (buff));
+      while (len > 0)
+        {
+          data.append(buff, len);
+          len = archive_read_data(t, buff, sizeof (buff));
+        }
+    }
+  return files;
+}
+
 void Tar_Helper::reopen(Tar_Helper *t)
 {
   t->Close(false);
@@ -54,6 +159,7 @@ void Tar_Helper::reopen(Tar_Helper *t)
 bool Tar_Helper::Open(Glib::ustring file, std::ios::openmode mode)
 {
   t = NULL;
+  openmode = mode;
   if (mode == std::ios::in && is_tarfile (file) == false)
     return true;
   //int m;
@@ -147,6 +253,7 @@ bool Tar_Helper::saveFile(Tar_Helper *t, Glib::ustring filename, Glib::ustring d
   t->t = NULL;
   File::copy(tmp, t->pathname);
   File::erase(tmp);
+  t->clearIndex();
   return true;
 }
 
@@ -174,6 +281,8 @@ void Tar_Helper::Close(bool clean)
       if (tmpoutdir != "" && clean)
         File::clean_dir(tmpoutdir);
     }
+  if (clean)
+    clearIndex();
 }
 
 Glib::ustring Tar_Helper::getFirstFile(std::list<Glib::ustring> exts, bool &broken)
@@ -200,57 +309,22 @@ Glib::ustring Tar_Helper::getFile(Tar_Helper *t, Glib::ustring filename, bool &b
   Glib::ustring f = File::getTempFile(tmpoutdir, filename);
   if (File::exists(f) == true)
     return f;
-  struct archive_entry *entry = NULL;
-  bool found = false;
 
-  reopen(t);
-  while (1) 
-    {
-      int r = archive_read_next_header(t->t, &entry);
-      if (r == ARCHIVE_EOF)
-        break;
-      if (r != ARCHIVE_OK)
-        break;
+  const std::string *data = t->getFileContents(filename);
+  if (!data)
+    return "";
 
-      if (filename == archive_entry_pathname(entry))
-        {
-          found = true;
-          break;
-        }
-    }
-  if (found)
+  broken = false;
+  std::ofstream out(f.c_str(), std::ios::out | std::ios::binary);
+  out.write(data->data(), data->size());
+  out.close();
+  if (!out)
     {
-      const void *buff = NULL;
-      size_t size = 0;
-      int64_t offset = 0;
-      broken = false;
-      struct archive *ext = archive_write_disk_new();
-      archive_write_disk_set_options(ext, 
-                                     ARCHIVE_EXTRACT_OWNER |
-                                     ARCHIVE_EXTRACT_PERM);
-      Glib::ustring outfile = File::getTempFile(tmpoutdir, filename);
-      archive_entry_copy_pathname(entry, outfile.c_str());
-
-      archive_write_header(ext, entry);
-
-      while (1)
-        {
-          int r = archive_read_data_block(t->t, &buff, &size, &offset);
-          if (r == ARCHIVE_EOF)
-            break;
-          if (r != ARCHIVE_OK)
-            break;
-          r = archive_write_data_block(ext, buff, size, offset);
-          if (r != ARCHIVE_OK)
-            break;
-        }
-      archive_write_finish_entry(ext);
-      archive_write_close(ext);
-      archive_write_free(ext);
-      return outfile;
+      broken = true;
+      File::erase(f);
+      return "";
     }
-
-  return "";
+  return f;
 }
 
 Glib::ustring Tar_Helper::getFile(Glib::ustring filename, bool &broken)
@@ -260,21 +334,8 @@ Glib::ustring Tar_Helper::getFile(Glib::ustring filename, bool &broken)
 
 std::list<Glib::ustring> Tar_Helper::getFilenames(Tar_Helper *t)
 {
-  reopen(t);
-  std::list<Glib::ustring> result;
-  //archive_seek_data(t, 0, SEEK_SET);
-  struct archive_entry *entry = NULL;
-  while (1) 
-    {
-      int r = archive_read_next_header(t->t, &entry);
-      if (r == ARCHIVE_EOF)
-        break;
-      if (r != ARCHIVE_OK)
-        break;
-
-      result.push_back(archive_entry_pathname(entry));
-    }
-  return result;
+  t->index(false);
+  return t->d_names;
 }
 
 std::list<Glib::ustring> Tar_Helper::getFilenames()
@@ -399,6 +460,7 @@ bool Tar_Helper::replaceFile(Glib::ustring filename, Glib::ustring newfilename)
   t = NULL;
   File::copy(tmp, pathname);
   File::erase(tmp);
+  clearIndex();
   return true;
 }
 
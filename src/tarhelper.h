@@ -23,6 +23,8 @@
 #include <glibmm.h>
 #include <iosfwd>
 #include <list>
+#include <map>
+#include <string>
 #include <cstdio>
 
 //! An interface for operating on tar archive files.
@@ -40,6 +42,26 @@ public:
 
     Glib::ustring getFile(Glib::ustring filename, bool &broken);
 
+    //! Returns the contents of a file in the archive without extracting it.
+    /**
+     * The first time this is called the whole archive is read into
+     * memory, and after that every file comes straight from there.
+     *
+     * @return The contents of the file, or NULL if the archive doesn't
+     *         have it.  The contents go away when the archive is closed.
+     */
+    const std::string *getFileContents(Glib::ustring filename);
+
+    //! Read the contents of some of the files in the archive.
+    /**
+     * Unlike getFileContents, this goes through the archive once without
+     * keeping anything but the given files, and keeps nothing afterwards.
+     *
+     * @return The contents of the given files by name.  Files that the 
+     *         archive doesn't have are left out.
+     */
+    std::map<Glib::ustring, std::string> readFiles(const std::list<Glib::ustring> &filenames);
+
     //Glib::ustring getFirstFile(bool &broken);
     Glib::ustring getFirstFile(Glib::ustring extension, bool &broken);
     Glib::ustring getFirstFile(std::list<Glib::ustring> exts, bool &broken);
@@ -73,11 +95,30 @@ public:
     static int dump_file_entry(Glib::ustring filename, struct archive_entry *entry, Glib::ustring nameinarchive, struct archive *out);
 private:
 
+    //! Go through the archive once and remember what's in it.
+    /**
+     * @param contents  Whether or not to keep the contents of the files
+     *                  as well as their names.
+     */
+    bool index(bool contents);
+
+    //! Forget what index() found.
+    void clearIndex();
+
     // DATA
     struct archive *t;
     std::ios::openmode openmode;
     Glib::ustring tmpoutdir;
     Glib::ustring pathname;
 
+    //! The names of the files in the archive, in order.
+    std::list<Glib::ustring> d_names;
+
+    //! The contents of the files in the archive, by name.
+    std::map<Glib::ustring, std::string> d_contents;
+
+    bool d_indexed;
+    bool d_indexed_contents;
+
 };
 #endif
@@ -0,0 +1,223 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+// Times decoding the army unit pictures of every armyset one after another
+// from extracted files, the way it used to be done, against decode_rows
+// with and without its cache.  Checks that the pictures come out the same
+// size, and that a broken picture is reported in the same place every time.
+
+#include <config.h>
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <stdlib.h>
+#include <gtkmm.h>
+#include "Configuration.h"
+#include "vector.h"
+#include "File.h"
+#include "tarhelper.h"
+#include "armysetlist.h"
+#include "armyset.h"
+#include "gui/image-helpers.h"
+
+int max_vector_width;
+
+// what automake's test driver takes to mean the test was skipped.
+#define SKIPPED 77
+
+static double seconds_since(gint64 start)
+{
+  return (g_get_monotonic_time() - start) / 1000000.0;
+}
+
+struct Picture
+{
+  Glib::ustring archive;
+  Glib::ustring name;
+  int size;
+};
+
+static void free_pixmasks(std::vector<PixMask*> &pixmasks)
+{
+  for (auto p: pixmasks)
+    delete p;
+  pixmasks.clear();
+}
+
+// the pictures the way Armyset::instantiateImages used to load them.
+static double decode_one_by_one(const std::vector<Picture> &pictures,
+                                std::vector<std::vector<PixMask*> > &results)
+{
+  gint64 start = g_get_monotonic_time();
+  for (auto &picture: pictures)
+    {
+      bool broken = false;
+      Tar_Helper t(picture.archive, std::ios::in, broken);
+      Glib::ustring file = t.getFile(picture.name, broken);
+      std::vector<PixMask*> half;
+      if (!broken)
+        half = disassemble_row(file, 2, broken);
+      if (!broken)
+        {
+          PixMask::scale(half[0], picture.size, picture.size);
+          PixMask::scale(half[1], picture.size, picture.size);
+        }
+      File::erase(file);
+      t.Close();
+      results.push_back(half);
+    }
+  return seconds_since(start);
+}
+
+static double decode_together(const std::vector<Picture> &pictures,
+                              std::vector<std::string> &data,
+                              std::vector<DecodeJob> &jobs)
+{
+  gint64 start = g_get_monotonic_time();
+  for (unsigned int i = 0; i < pictures.size(); i++)
+    jobs.push_back(DecodeJob(&data[i], 2, pictures[i].size,
+                             pictures[i].size));
+  decode_rows(jobs);
+  return seconds_since(start);
+}
+
+int main(int argc, char *argv[])
+{
+  // a cache of our own, so the first run of decode_rows really decodes.
+  gchar *cache = g_dir_make_tmp("lordsawar-XXXXXX", NULL);
+  if (!cache)
+    return EXIT_FAILURE;
+  g_setenv("XDG_CACHE_HOME", cache, TRUE);
+
+  // pictures can't be decoded without a display.
+  if (!gtk_init_check(&argc, &argv))
+    {
+      File::erase_dir(cache);
+      g_free(cache);
+      return SKIPPED;
+    }
+  Gtk::Main kit(argc, argv);
+  initialize_configuration();
+  Configuration::s_dataPath = TEST_DATADIR;
+  Vector<int>::setMaximumWidth(1000);
+
+  std::vector<Picture> pictures;
+  std::vector<std::string> data;
+  for (auto armyset: *Armysetlist::getInstance())
+    {
+      bool broken = false;
+      Tar_Helper t(armyset->getConfigurationFile(), std::ios::in, broken);
+      if (broken)
+        continue;
+      for (auto army: *armyset)
+        for (unsigned int c = Shield::WHITE; c <= Shield::NEUTRAL; c++)
+          {
+            Glib::ustring name = army->getImageName(Shield::Colour(c));
+            const std::string *contents = NULL;
+            if (name.empty() == false)
+              contents = t.getFileContents(name + ".png");
+            if (!contents)
+              continue;
+            Picture picture;
+            picture.archive = armyset->getConfigurationFile();
+            picture.name = name + ".png";
+            picture.size = armyset->getTileSize();
+            pictures.push_back(picture);
+            data.push_back(*contents);
+          }
+      t.Close();
+    }
+
+  int err = EXIT_SUCCESS;
+  std::vector<std::vector<PixMask*> > one_by_one;
+  double serial = decode_one_by_one(pictures, one_by_one);
+
+  std::vector<DecodeJob> cold;
+  double uncached = decode_together(pictures, data, cold);
+  //handing them over has to be counted too.  this is when they're cached.
+  gint64 start = g_get_monotonic_time();
+  std::vector<std::vector<PixMask*> > together;
+  for (auto &job: cold)
+    together.push_back(to_pixmasks(job));
+  uncached += seconds_since(start);
+
+  std::vector<DecodeJob> warm;
+  double cached = decode_together(pictures, data, warm);
+  start = g_get_monotonic_time();
+  std::vector<std::vector<PixMask*> > from_cache;
+  for (auto &job: warm)
+    from_cache.push_back(to_pixmasks(job));
+  cached += seconds_since(start);
+
+  for (unsigned int i = 0; i < pictures.size(); i++)
+    {
+      std::vector<PixMask*> &a = one_by_one[i];
+      std::vector<PixMask*> &b = together[i];
+      std::vector<PixMask*> &c = from_cache[i];
+      bool same = a.size() == 2 && b.size() == 2 && c.size() == 2;
+      for (unsigned int j = 0; same && j < 2; j++)
+        same = a[j]->get_width() == b[j]->get_width() &&
+          a[j]->get_height() == b[j]->get_height() &&
+          b[j]->get_width() == c[j]->get_width() &&
+          b[j]->get_height() == c[j]->get_height() &&
+          a[j]->get_unscaled_width() == c[j]->get_unscaled_width();
+      if (!same)
+        {
+          std::cerr << pictures[i].name << " in " << pictures[i].archive <<
+            " didn't come out the same" << std::endl;
+          err = EXIT_FAILURE;
+        }
+      free_pixmasks(a);
+      free_pixmasks(b);
+      free_pixmasks(c);
+    }
+
+  //a broken picture in the middle is the only one that's broken.
+  std::string garbage = "not a png";
+  std::vector<DecodeJob> jobs;
+  for (unsigned int i = 0; i < data.size(); i++)
+    jobs.push_back(DecodeJob(i == data.size() / 2 ? &garbage : &data[i], 2,
+                             pictures[i].size, pictures[i].size));
+  decode_rows(jobs);
+  for (unsigned int i = 0; i < jobs.size(); i++)
+    {
+      std::vector<PixMask*> pixmasks = to_pixmasks(jobs[i]);
+      if (jobs[i].broken != (i == data.size() / 2))
+        {
+          std::cerr << "picture " << i << " was " <<
+            (jobs[i].broken ? "" : "not ") << "broken" << std::endl;
+          err = EXIT_FAILURE;
+        }
+      free_pixmasks(pixmasks);
+    }
+
+  std::cout << pictures.size() << " army unit pictures, " <<
+    std::thread::hardware_concurrency() << " cores" << std::endl;
+  std::cout << "one by one from files: " << serial << "s" << std::endl;
+  std::cout << "decode_rows: " << uncached << "s" << std::endl;
+  std::cout << "decode_rows from the cache: " << cached << "s" << std::endl;
+
+  Armysetlist::deleteInstance();
+  File::clean_dir(Glib::build_filename(File::getCacheDir(), "images"));
+  File::clean_dir(File::getCacheDir());
+  File::erase_dir(cache);
+  g_free(cache);
+  return err;
+}
+
+// End of file
@@ -0,0 +1,110 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+// Times loading every picture in an armyset against loading them as
+// they're needed, and checks that loading on demand leaves the pictures
+// nobody asked for alone.
+
+#include <config.h>
+
+#include <iostream>
+#include <stdlib.h>
+#include <gtkmm.h>
+#include "Configuration.h"
+#include "vector.h"
+#include "armysetlist.h"
+#include "armyset.h"
+
+int max_vector_width;
+
+// what automake's test driver takes to mean the test was skipped.
+#define SKIPPED 77
+
+static double seconds_since(gint64 start)
+{
+  return (g_get_monotonic_time() - start) / 1000000.0;
+}
+
+static guint32 count_pictures(Armyset *armyset)
+{
+  guint32 count = 0;
+  for (auto army: *armyset)
+    for (unsigned int c = Shield::WHITE; c <= Shield::NEUTRAL; c++)
+      if (army->getImage(Shield::Colour(c)))
+        count++;
+  return count;
+}
+
+int main(int argc, char *argv[])
+{
+  // pictures can't be decoded without a display.
+  if (!gtk_init_check(&argc, &argv))
+    return SKIPPED;
+  Gtk::Main kit(argc, argv);
+  initialize_configuration();
+  Configuration::s_dataPath = TEST_DATADIR;
+  Vector<int>::setMaximumWidth(1000);
+
+  Armyset *armyset = Armysetlist::getInstance()->get("default");
+  if (!armyset)
+    return EXIT_FAILURE;
+
+  int err = EXIT_SUCCESS;
+  bool broken = false;
+  gint64 start = g_get_monotonic_time();
+  armyset->instantiateImages(broken);
+  double eager = seconds_since(start);
+  guint32 all = count_pictures(armyset);
+  armyset->uninstantiateImages();
+  if (broken)
+    {
+      std::cerr << "could not load the default armyset" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  start = g_get_monotonic_time();
+  armyset->instantiateImagesOnDemand(broken);
+  double on_demand = seconds_since(start);
+  if (broken || count_pictures(armyset) != 0)
+    {
+      std::cerr << "army units were loaded before they were wanted" <<
+        std::endl;
+      err = EXIT_FAILURE;
+    }
+
+  //what a game with one player and every unit would want.
+  start = g_get_monotonic_time();
+  for (auto army: *armyset)
+    armyset->instantiateArmyImages(army->getId(), Shield::WHITE);
+  double one_colour = seconds_since(start);
+  if (count_pictures(armyset) != armyset->size())
+    {
+      std::cerr << "the wrong number of army units were loaded" << std::endl;
+      err = EXIT_FAILURE;
+    }
+  armyset->uninstantiateImages();
+
+  std::cout << "every picture (" << all << "): " << eager << "s" << std::endl;
+  std::cout << "getting ready to load on demand: " << on_demand << "s" <<
+    std::endl;
+  std::cout << "one colour of every unit (" << armyset->size() << "): " <<
+    one_colour << "s" << std::endl;
+  Armysetlist::deleteInstance();
+  return err;
+}
+
+// End of file
@@ -0,0 +1,118 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+// Checks that the MapGenerator makes the same map from the same seed.
+
+#include <config.h>
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include <gtkmm.h>
+#include "Configuration.h"
+#include "vector.h"
+#include "defs.h"
+#include "MapGenerator.h"
+#include "GameMap.h"
+#include "citysetlist.h"
+#include "citylist.h"
+#include "roadlist.h"
+#include "bridgelist.h"
+#include "portlist.h"
+#include "ruinlist.h"
+#include "templelist.h"
+
+int max_vector_width;
+
+struct Map
+{
+  std::vector<Tile::Type> terrain;
+  std::vector<Maptile::Building> buildings;
+};
+
+static void forget_buildings()
+{
+  Citylist::deleteInstance();
+  Roadlist::deleteInstance();
+  Bridgelist::deleteInstance();
+  Portlist::deleteInstance();
+  Ruinlist::deleteInstance();
+  Templelist::deleteInstance();
+}
+
+static Map make_map(MapGenerator &gen, guint32 seed)
+{
+  int width = MAP_SIZE_SMALL_WIDTH;
+  int height = MAP_SIZE_SMALL_HEIGHT;
+  forget_buildings();
+  gen.setSeed(seed);
+  gen.makeMap(width, height, true);
+  Map map;
+  const Tile::Type *terrain = gen.getMap(width, height);
+  map.terrain.assign(terrain, terrain + width * height);
+  const Maptile::Building *buildings = gen.getBuildings(width, height);
+  map.buildings.assign(buildings, buildings + width * height);
+  return map;
+}
+
+static MapGenerator *make_generator()
+{
+  MapGenerator *gen = new MapGenerator();
+  gen->setCityset(Citysetlist::getInstance()->get("default"));
+  return gen;
+}
+
+int main()
+{
+  initialize_configuration();
+  Configuration::s_dataPath = TEST_DATADIR;
+  Vector<int>::setMaximumWidth(1000);
+  Gtk::Main::init_gtkmm_internals();
+
+  GameMap::getInstance("default", "default", "default");
+
+  guint32 seed = 1234;
+  MapGenerator *first = make_generator();
+  Map a = make_map(*first, seed);
+  delete first;
+
+  //a new generator with the same seed.
+  MapGenerator *second = make_generator();
+  Map b = make_map(*second, seed);
+
+  //the same generator again, which has to start over from the seed.
+  Map c = make_map(*second, seed);
+  delete second;
+
+  forget_buildings();
+  GameMap::deleteInstance();
+
+  int err = EXIT_SUCCESS;
+  if (a.terrain != b.terrain || a.buildings != b.buildings)
+    {
+      std::cerr << "two generators made different maps from one seed" << std::endl;
+      err = EXIT_FAILURE;
+    }
+  if (b.terrain != c.terrain || b.buildings != c.buildings)
+    {
+      std::cerr << "a generator made a different map from the same seed" << std::endl;
+      err = EXIT_FAILURE;
+    }
+  return err;
+}
+
+// End of file
@@ -0,0 +1,137 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+// Times loading the sets at startup, and saving and loading a game, and
+// checks that Tar_Helper hands out the same bytes from memory as it
+// writes to disk.
+
+#include <config.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <gtkmm.h>
+#include "Configuration.h"
+#include "vector.h"
+#include "File.h"
+#include "tarhelper.h"
+#include "armysetlist.h"
+#include "tilesetlist.h"
+#include "citysetlist.h"
+#include "shieldsetlist.h"
+#include "GameScenario.h"
+
+int max_vector_width;
+
+static double seconds_since(gint64 start)
+{
+  return (g_get_monotonic_time() - start) / 1000000.0;
+}
+
+// every file in the archive, read from memory and from an extracted copy.
+static bool check_contents(Glib::ustring archive)
+{
+  bool broken = false;
+  Tar_Helper t(archive, std::ios::in, broken);
+  if (broken)
+    return false;
+  bool same = true;
+  for (auto name: t.getFilenames())
+    {
+      const std::string *contents = t.getFileContents(name);
+      Glib::ustring file = t.getFile(name, broken);
+      if (!contents || broken)
+        {
+          same = false;
+          break;
+        }
+      std::ifstream in(file.c_str(), std::ios::binary);
+      std::ostringstream os;
+      os << in.rdbuf();
+      File::erase(file);
+      if (os.str() != *contents)
+        {
+          std::cerr << name << " in " << archive <<
+            " differs from its extracted copy" << std::endl;
+          same = false;
+        }
+    }
+  t.Close();
+  return same;
+}
+
+int main()
+{
+  initialize_configuration();
+  Configuration::s_dataPath = TEST_DATADIR;
+  Vector<int>::setMaximumWidth(1000);
+  Gtk::Main::init_gtkmm_internals();
+
+  int err = EXIT_SUCCESS;
+  gint64 start = g_get_monotonic_time();
+  Armysetlist::getInstance();
+  Tilesetlist::getInstance();
+  Citysetlist::getInstance();
+  Shieldsetlist::getInstance();
+  std::cout << "loading the sets: " << seconds_since(start) << "s" <<
+    std::endl;
+
+  Armyset *armyset = Armysetlist::getInstance()->get("default");
+  if (!armyset || !check_contents(armyset->getConfigurationFile()))
+    err = EXIT_FAILURE;
+
+  Glib::ustring map = Glib::build_filename(TEST_DATADIR, "map", "dol",
+                                           "dol.map");
+  bool broken = false;
+  start = g_get_monotonic_time();
+  GameScenario *scenario = new GameScenario(map, broken);
+  std::cout << "loading " << map << ": " << seconds_since(start) << "s" <<
+    std::endl;
+  if (broken)
+    {
+      std::cerr << "could not load " << map << std::endl;
+      delete scenario;
+      return EXIT_FAILURE;
+    }
+
+  Glib::ustring save = File::get_tmp_file(SAVE_EXT);
+  start = g_get_monotonic_time();
+  if (scenario->saveGame(save) == false)
+    {
+      std::cerr << "could not save " << save << std::endl;
+      err = EXIT_FAILURE;
+    }
+  std::cout << "saving the game: " << seconds_since(start) << "s" <<
+    std::endl;
+  delete scenario;
+
+  start = g_get_monotonic_time();
+  scenario = new GameScenario(save, broken);
+  std::cout << "loading the saved game: " << seconds_since(start) << "s" <<
+    std::endl;
+  if (broken)
+    {
+      std::cerr << "could not load the saved game" << std::endl;
+      err = EXIT_FAILURE;
+    }
+  delete scenario;
+  File::erase(save);
+  return err;
+}
+
+// End of file
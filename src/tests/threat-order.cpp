@@ -0,0 +1,134 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+//  02110-1301, USA.
+
+// Times Threatlist::sortByDistance on a late-game sized list of threats,
+// next to the bubble sort it replaced, and checks that they agree.
+
+#include <config.h>
+
+#include <iostream>
+#include <list>
+#include <vector>
+#include <stdlib.h>
+#include <gtkmm.h>
+#include "Configuration.h"
+#include "vector.h"
+#include "GameMap.h"
+#include "Threat.h"
+#include "Threatlist.h"
+#include "ruin.h"
+#include "rnd.h"
+
+int max_vector_width;
+
+// how many threats there are, and how often the AI asks for them in order.
+static const int THREATS = 600;
+static const int LOOKUPS = 200;
+
+// the way Threatlist::sortByDistance used to do it.
+static void bubble_sort(std::list<Threat*> &threats, Vector<int> pos)
+{
+  std::list<int> distances;
+  for (auto threat: threats)
+    distances.push_back(dist(threat->getClosestPoint(pos), pos));
+
+  bool sorted = false;
+  while (!sorted)
+    {
+      sorted = true;
+      std::list<int>::iterator dit = distances.begin();
+      std::list<int>::iterator dnextit = distances.begin();
+      dnextit++;
+      std::list<Threat*>::iterator it = threats.begin();
+      std::list<Threat*>::iterator nextit = it;
+      nextit++;
+      for (; nextit != threats.end(); it++, nextit++, dit++, dnextit++)
+        if ((*dit) > (*dnextit))
+          {
+            sorted = false;
+            Threat *tmp = *nextit;
+            threats.erase(nextit);
+            nextit = it;
+            it = threats.insert(nextit, tmp);
+            int dtmp = *dnextit;
+            distances.erase(dnextit);
+            dnextit = dit;
+            dit = distances.insert(dnextit, dtmp);
+          }
+    }
+}
+
+static Vector<int> random_pos()
+{
+  return Vector<int>(Rnd::rand() % GameMap::getWidth(),
+                     Rnd::rand() % GameMap::getHeight());
+}
+
+int main()
+{
+  initialize_configuration();
+  Configuration::s_dataPath = TEST_DATADIR;
+  Vector<int>::setMaximumWidth(1000);
+  Gtk::Main::init_gtkmm_internals();
+  GameMap::getInstance("default", "default", "default");
+  Rnd::set_seed(1234);
+
+  std::vector<Ruin*> ruins;
+  Threatlist threats;
+  for (int i = 0; i < THREATS; i++)
+    {
+      ruins.push_back(new Ruin(random_pos(), 1));
+      threats.add(new Threat(ruins.back()));
+    }
+  std::list<Threat*> old_threats(threats.begin(), threats.end());
+  std::vector<Vector<int> > lookups;
+  for (int i = 0; i < LOOKUPS; i++)
+    lookups.push_back(random_pos());
+
+  int err = EXIT_SUCCESS;
+  gint64 sorted_view = 0;
+  gint64 bubble = 0;
+  for (auto pos: lookups)
+    {
+      gint64 start = g_get_monotonic_time();
+      threats.sortByDistance(pos);
+      sorted_view += g_get_monotonic_time() - start;
+
+      start = g_get_monotonic_time();
+      bubble_sort(old_threats, pos);
+      bubble += g_get_monotonic_time() - start;
+
+      if (std::list<Threat*>(threats.begin(), threats.end()) != old_threats)
+        {
+          std::cerr << "threats came out in a different order from " <<
+            pos.x << "," << pos.y << std::endl;
+          err = EXIT_FAILURE;
+        }
+    }
+  std::cout << LOOKUPS << " orderings of " << THREATS << " threats: " <<
+    sorted_view / 1000.0 << "ms, bubble sort " << bubble / 1000.0 << "ms" <<
+    std::endl;
+
+  for (auto threat: threats)
+    delete threat;
+  for (auto ruin: ruins)
+    delete ruin;
+  GameMap::deleteInstance();
+  return err;
+}
+
+// End of file
@@ -22,6 +22,7 @@
 #include <iostream>
 
 #include "tileset.h"
+#include "maptile.h"
 
 #include "defs.h"
 #include "File.h"
@@ -159,7 +160,7 @@ Tileset::Tileset (const Tileset& t)
 	{
 	  for (std::vector<TileStyle*>::const_iterator k = (*j)->begin(); k != (*j)->end(); k++)
             {
-              d_tilestyles[(*k)->getId()] = *k;
+              indexTileStyle((*k)->getId(), *k);
             }
         }
     }
@@ -281,7 +282,7 @@ bool Tileset::loadTile(Glib::ustring tag, XML_Helper* helper)
       // put it on the latest tilestyleset
       TileStyle* tilestyle = new TileStyle(helper);
       tilestyleset->push_back(tilestyle);
-      d_tilestyles[tilestyle->getId()] = tilestyle;
+      indexTileStyle(tilestyle->getId(), tilestyle);
 
       return true;
     }
@@ -402,6 +403,9 @@ bool Tileset::validate() const
 {
   if (size() == 0)
     return false;
+  //the maptiles only have room for ids below this.
+  if ((guint32) getLargestTileStyleId() >= Maptile::NO_TILESTYLE)
+    return false;
   for (Tileset::const_iterator i = begin(); i != end(); i++)
     if ((*i)->validate() == false)
       return false;
@@ -573,189 +577,138 @@ void Tileset::uninstantiateImages()
     }
 }
 
-void Tileset::instantiateImages(Glib::ustring explosion_filename,
-				Glib::ustring roads_filename,
-				Glib::ustring bridges_filename,
-				Glib::ustring fog_filename,
-				Glib::ustring flags_filename,
-				Glib::ustring selector_filename,
-				Glib::ustring small_selector_filename,
-                                bool &broken)
+void Tileset::instantiateImages(bool &broken)
 {
-  if (explosion_filename.empty() == false && !broken)
-    setExplosionImage (PixMask::create(explosion_filename, broken));
+  int siz = getTileSize();
+  debug("Loading images for tileset " << getName());
+  uninstantiateImages();
+  broken = false;
+  Tar_Helper t(getConfigurationFile(), std::ios::in, broken);
+  if (broken)
+    return;
+  //decode the tile styles of every tile at once, and then hand out the
+  //pictures in order.
+  std::vector<DecodeJob> jobs;
+  std::vector<TileStyleSet*> sets;
+  for (iterator it = begin(); it != end(); it++)
+    for (Tile::iterator i = (*it)->begin(); i != (*it)->end(); i++)
+      {
+        if ((*i)->getName().empty() == true)
+          continue;
+        const std::string *data = t.getFileContents((*i)->getName() + ".png");
+        if (!data)
+          continue;
+        jobs.push_back(DecodeJob(data, (*i)->size(), siz, siz));
+        sets.push_back(*i);
+      }
 
-  if (roads_filename.empty() == false && !broken)
-    {
-      std::vector<PixMask* > roadpics;
-      roadpics = disassemble_row(roads_filename, ROAD_TYPES, broken);
-      if (!broken)
+  //the rest of the pictures go along in the same batch.  flags and
+  //selectors have their masks underneath them, and selectors have as many
+  //frames as fit the tile size.
+  enum {EXPLOSION, ROADS, BRIDGES, FOG, FLAGS, SELECTOR, SMALL_SELECTOR, MISC};
+  Glib::ustring names[MISC] = 
+    {getExplosionFilename(), getRoadsFilename(), getBridgesFilename(), 
+      getFogFilename(), getFlagsFilename(), getLargeSelectorFilename(), 
+      getSmallSelectorFilename()};
+  int nos[MISC] = 
+    {1, ROAD_TYPES, BRIDGE_TYPES, FOG_TYPES, FLAG_TYPES, 0, 0};
+  int misc[MISC];
+  for (int i = 0; i < MISC; i++)
+    {
+      misc[i] = -1;
+      if (names[i].empty() == true || broken)
+        continue;
+      const std::string *data = t.getFileContents(names[i] + ".png");
+      if (!data)
         {
-          for (unsigned int i = 0; i < ROAD_TYPES ; i++)
-            {
-              if (roadpics[i]->get_width() != (int)getTileSize())
-                PixMask::scale(roadpics[i], getTileSize(), getTileSize());
-              setRoadImage(i, roadpics[i]);
-            }
+          broken = true;
+          continue;
         }
-
+      misc[i] = jobs.size();
+      if (i == EXPLOSION)
+        jobs.push_back(DecodeJob(data, nos[i]));
+      else
+        jobs.push_back(DecodeJob(data, nos[i], siz, siz));
+      jobs.back().always_scale = false;
+      if (i >= FLAGS)
+        jobs.back().rows = 2;
+      if (nos[i] == 0)
+        jobs.back().frame_width = siz;
     }
-
-  if (bridges_filename.empty() == false && !broken)
+  if (broken)
     {
-      std::vector<PixMask* > bridgepics;
-      bridgepics = disassemble_row(bridges_filename, BRIDGE_TYPES, broken);
-      if (!broken)
-        {
-          for (unsigned int i = 0; i < BRIDGE_TYPES ; i++)
-            {
-              if (bridgepics[i]->get_width() != (int)getTileSize())
-                PixMask::scale(bridgepics[i], getTileSize(), getTileSize());
-              setBridgeImage(i, bridgepics[i]);
-            }
-        }
+      t.Close();
+      return;
     }
 
-  if (fog_filename.empty() == false && !broken)
+  decode_rows(jobs);
+  for (unsigned int i = 0; i < sets.size() && !broken; i++)
     {
-      std::vector<PixMask* > fogpics;
-      fogpics = disassemble_row(fog_filename, FOG_TYPES, broken);
-      if (!broken)
-        {
-          for (unsigned int i = 0; i < FOG_TYPES ; i++)
-            {
-              if (fogpics[i]->get_width() != (int)getTileSize())
-                PixMask::scale(fogpics[i], getTileSize(), getTileSize());
-              setFogImage(i, fogpics[i]);
-            }
-        }
+      std::vector<PixMask*> styles = to_pixmasks(jobs[i]);
+      if (jobs[i].broken)
+        broken = true;
+      else
+        for (unsigned int j = 0; j < styles.size(); j++)
+          (*sets[i])[j]->setImage(styles[j]);
     }
-
-  if (flags_filename.empty() == false && !broken)
+  std::vector<PixMask*> pics[MISC];
+  for (int i = 0; i < MISC && !broken; i++)
+    if (misc[i] >= 0)
+      {
+        pics[i] = to_pixmasks(jobs[misc[i]]);
+        if (jobs[misc[i]].broken)
+          broken = true;
+      }
+  t.Close();
+  if (broken)
     {
-      std::vector<PixMask* > flagpics;
-      std::vector<PixMask* > maskpics;
-      bool success;
-      success = FlagPixMaskCacheItem::loadFlagImages (flags_filename, getTileSize(), flagpics, maskpics);
-      if (success)
-        {
-          for (unsigned int i = 0; i < flagpics.size(); i++)
-            setFlagImage(i, flagpics[i]);
-          for (unsigned int i = 0; i < maskpics.size(); i++)
-            setFlagMask(i, maskpics[i]);
-        }
-      else
-        broken = true;
+      for (int i = 0; i < MISC; i++)
+        for (unsigned int j = 0; j < pics[i].size(); j++)
+          delete pics[i][j];
+      return;
     }
 
-  std::vector<PixMask* > images;
-  std::vector<PixMask* > masks;
-  if (selector_filename.empty() == false && !broken)
+  if (pics[EXPLOSION].empty() == false)
+    setExplosionImage(pics[EXPLOSION][0]);
+  for (unsigned int i = 0; i < pics[ROADS].size(); i++)
+    setRoadImage(i, pics[ROADS][i]);
+  for (unsigned int i = 0; i < pics[BRIDGES].size(); i++)
+    setBridgeImage(i, pics[BRIDGES][i]);
+  for (unsigned int i = 0; i < pics[FOG].size(); i++)
+    setFogImage(i, pics[FOG][i]);
+  for (unsigned int i = 0; i < pics[FLAGS].size() / 2; i++)
     {
-      bool success;
-      success = SelectorPixMaskCacheItem::loadSelectorImages (selector_filename, 
-                                                   getTileSize(), 
-                                                   images, masks);
-      if (success)
+      setFlagImage(i, pics[FLAGS][i]);
+      setFlagMask(i, pics[FLAGS][i + FLAG_TYPES]);
+    }
+  guint32 frames = pics[SELECTOR].size() / 2;
+  if (frames)
+    {
+      setNumberOfSelectorFrames(frames);
+      for (unsigned int i = 0; i < frames; i++)
         {
-          setNumberOfSelectorFrames(images.size());
-          for (unsigned int i = 0; i < images.size(); i++)
-            {
-              setSelectorImage(i, images[i]);
-              setSelectorMask(i, masks[i]);
-            }
+          setSelectorImage(i, pics[SELECTOR][i]);
+          setSelectorMask(i, pics[SELECTOR][i + frames]);
         }
-      else
-        broken = true;
     }
-
-  images.clear();
-  masks.clear();
-  if (small_selector_filename.empty() == false && !broken)
+  frames = pics[SMALL_SELECTOR].size() / 2;
+  if (frames)
     {
-      bool success;
-      success = SelectorPixMaskCacheItem::loadSelectorImages (small_selector_filename, 
-                                                   getTileSize(), images, masks);
-      if (success)
+      setNumberOfSmallSelectorFrames(frames);
+      for (unsigned int i = 0; i < frames; i++)
         {
-          setNumberOfSmallSelectorFrames(images.size());
-          for (unsigned int i = 0; i < images.size(); i++)
-            {
-              setSmallSelectorImage(i, images[i]);
-              setSmallSelectorMask(i, masks[i]);
-            }
+          setSmallSelectorImage(i, pics[SMALL_SELECTOR][i]);
+          setSmallSelectorMask(i, pics[SMALL_SELECTOR][i + frames]);
         }
-      else
-        broken = true;
     }
-}
-
-void Tileset::instantiateImages(bool &broken)
-{
-  int siz = getTileSize();
-  debug("Loading images for tileset " << getName());
-  uninstantiateImages();
-  broken = false;
-  Tar_Helper t(getConfigurationFile(), std::ios::in, broken);
-  if (broken)
-    return;
-  for (iterator it = begin(); it != end(); it++)
-    {
-      if (!broken)
-        (*it)->instantiateImages(siz, &t, broken);
-    }
-  Glib::ustring explosion_filename = "";
-  Glib::ustring roads_filename = "";
-  Glib::ustring bridges_filename = "";
-  Glib::ustring fog_filename = "";
-  Glib::ustring flags_filename = "";
-  Glib::ustring selector_filename = "";
-  Glib::ustring small_selector_filename = "";
-
-  if (getExplosionFilename().empty() == false && !broken)
-    explosion_filename = t.getFile(getExplosionFilename() + ".png", broken);
-  if (getRoadsFilename().empty() == false && !broken)
-    roads_filename = t.getFile(getRoadsFilename() + ".png", broken);
-  if (getBridgesFilename().empty() == false && !broken)
-    bridges_filename = t.getFile(getBridgesFilename() + ".png", broken);
-  if (getFogFilename().empty() == false && !broken)
-    fog_filename = t.getFile(getFogFilename() + ".png", broken);
-  if (getFlagsFilename().empty() == false && !broken)
-    flags_filename = t.getFile(getFlagsFilename() + ".png", broken);
-  if (getLargeSelectorFilename().empty() == false && !broken)
-    selector_filename = t.getFile(getLargeSelectorFilename() + ".png", broken);
-  if (getSmallSelectorFilename().empty() == false && !broken)
-    small_selector_filename = 
-      t.getFile(getSmallSelectorFilename() + ".png", broken);
-  if (!broken)
-    instantiateImages(explosion_filename, roads_filename, bridges_filename, 
-                      fog_filename, flags_filename, selector_filename, 
-                      small_selector_filename, broken);
-  if (explosion_filename.empty() == false)
-    File::erase(explosion_filename);
-  if (roads_filename.empty() == false)
-    File::erase(roads_filename);
-  if (bridges_filename.empty() == false)
-    File::erase(bridges_filename);
-  if (fog_filename.empty() == false)
-    File::erase(fog_filename);
-  if (flags_filename.empty() == false)
-    File::erase(flags_filename);
-  if (selector_filename.empty() == false)
-    File::erase(selector_filename);
-  if (small_selector_filename.empty() == false)
-    File::erase(small_selector_filename);
-  t.Close();
   return;
 }
 
-TileStyle *Tileset::getTileStyle(guint32 id) const
+void Tileset::indexTileStyle(guint32 id, TileStyle *style)
 {
-  TileStyleIdMap::const_iterator it = d_tilestyles.find(id);
-  if (it == d_tilestyles.end())
-    return NULL;
-  else
-    return (*it).second;
+  if (id >= d_tilestyles.size())
+    d_tilestyles.resize(id + 1, NULL);
+  d_tilestyles[id] = style;
 }
 
 void Tileset::reload(bool &broken)
@@ -836,7 +789,7 @@ bool Tileset::addTileStyleSet(Tile *tile, Glib::ustring filename)
   for (TileStyleSet::iterator it = set->begin(); it != set->end(); it++)
     {
       guint32 tile_style_id = getFreeTileStyleId();
-      d_tilestyles[tile_style_id] = (*it);
+      indexTileStyle(tile_style_id, *it);
       (*it)->setId(tile_style_id);
     }
   return success;
@@ -256,7 +256,8 @@ class Tileset : public sigc::trackable, public std::vector<Tile*>, public Set
         int lookupIndexByType(Tile::Type type) const;
 
 	//! Lookup tilestyle by it's id in this tileset.
-	TileStyle *getTileStyle(guint32 id) const;
+	TileStyle *getTileStyle(guint32 id) const
+          {return id < d_tilestyles.size() ? d_tilestyles[id] : NULL;};
 
 	//! Lookup a random tile style.
 	/**
@@ -314,15 +315,9 @@ class Tileset : public sigc::trackable, public std::vector<Tile*>, public Set
         //! Callback to load Tile objects into the Tileset.
         bool loadTile(Glib::ustring, XML_Helper* helper);
 
-	//! Load the various images from the given filenames.
-	void instantiateImages(Glib::ustring explosion_filename,
-			       Glib::ustring roads_filename,
-			       Glib::ustring bridges_filename,
-			       Glib::ustring fog_filename,
-			       Glib::ustring flags_filename,
-			       Glib::ustring selector_filename,
-			       Glib::ustring small_selector_filename,
-                               bool &broken);
+        //! Make the given TileStyle the one with the given id.
+        void indexTileStyle(guint32 id, TileStyle *style);
+
         // DATA
 
 	//! The basename of the small selector image.
@@ -417,9 +412,12 @@ class Tileset : public sigc::trackable, public std::vector<Tile*>, public Set
 	 */
 	Glib::ustring d_flags;
 
-        typedef std::map<guint32, TileStyle*> TileStyleIdMap;
-	//! A map that provides a TileStyle when supplying a TileStyle id.
-        TileStyleIdMap d_tilestyles;
+	//! The TileStyle objects in this tileset, indexed by TileStyle id.
+        /**
+         * The ids are small numbers, so this is a plain vector rather than
+         * a map.  Every Maptile looks up its TileStyle in here by id.
+         */
+        std::vector<TileStyle*> d_tilestyles;
 
         typedef std::map<Tile::Type, int> TileTypeIndexMap;
 	//! A map that provides an index when supplying a type of Tile.
@@ -0,0 +1,117 @@
+// Copyright (C) 2026 agent
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Library General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 
+//  02110-1301, USA.
+
+#include <config.h>
+
+#include <iostream>
+#include <stdlib.h>
+#include "Configuration.h"
+#include "File.h"
+#include "ucompose.hpp"
+#include "vector.h"
+#include "game-replay.h"
+
+int max_vector_width;
+
+int main(int argc, char* argv[])
+{
+  int err = EXIT_SUCCESS;
+  std::list<Glib::ustring> files;
+  Glib::ustring output;
+  int round = -1;
+  initialize_configuration();
+  Vector<int>::setMaximumWidth(1000);
+
+  #if ENABLE_NLS
+  setlocale(LC_ALL, Configuration::s_lang.c_str());
+  bindtextdomain (GETTEXT_PACKAGE, LOCALEDIR);
+  bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
+  textdomain (GETTEXT_PACKAGE);
+  #endif
+
+  Gtk::Main kit(argc, argv);
+  if (argc > 1)
+    {
+      for (int i = 2; i <= argc; i++)
+	{
+          Glib::ustring parameter(argv[i-1]); 
+	  if ((parameter == "--round" || parameter == "-r") && i < argc)
+            {
+              i++;
+              round = atoi(argv[i-1]);
+            }
+          else if ((parameter == "--output" || parameter == "-o") && i < argc)
+            {
+              i++;
+              output = argv[i-1];
+            }
+	  else if (parameter == "--help" || parameter == "-?")
+	    {
+              std::cout << File::get_basename(argv[0], true) << " [OPTION]... START-FILE LATER-FILE" << std::endl << std::endl;
+              std::cout << "LordsAWar! Game Replaying Tool " << _("version") << 
+                " " << VERSION << std::endl << std::endl;
+              std::cout << _("Options:") << std::endl << std::endl; 
+              std::cout << "  -?, --help                 " << _("Display this help and exit") <<std::endl;
+              std::cout << "  -r, --round NUM            " << _("Stop at the start of the given round") << std::endl;
+              std::cout << "  -o, --output FILE          " << _("Save the game where the replay stops") << std::endl;
+              std::cout << std::endl;
+              std::cout << _("Report bugs to") << " <" << PACKAGE_BUGREPORT ">." << std::endl;
+	      exit(0);
+	    }
+	  else
+	    files.push_back(parameter);
+	}
+    }
+
+  if (files.size() != 2)
+    {
+      std::cout << _("Error: A starting saved-game file and a later one are needed.") << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  bool broken = false;
+  GameReplay replay(files.front(), files.back(), broken);
+  if (broken)
+    {
+      std::cout << String::ucompose(_("Error: %1 could not be replayed onto %2."),
+                                    files.back(), files.front()) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  if (round >= 0)
+    {
+      if (replay.seek(round) == false)
+        {
+          std::cout << String::ucompose(_("Error: The game doesn't get to round %1."), round) << std::endl;
+          err = EXIT_FAILURE;
+        }
+    }
+  else
+    replay.play();
+
+  std::cout << String::ucompose(_("Replayed %1 of %2 turns, up to round %3."),
+                                replay.getTurn(), replay.countTurns(),
+                                replay.getRound()) << std::endl;
+
+  if (output != "" && replay.save(output) == false)
+    {
+      std::cout << String::ucompose(_("Error: %1 could not be saved."), 
+                                    output) << std::endl;
+      err = EXIT_FAILURE;
+    }
+  return err;
+}
@@ -99,10 +99,11 @@ Army *VectoredUnit::armyArrives(Stack *& stack) const
 	return NULL;
 	}
       printf ("uhh... no city at %d,%d?\n", d_destination.x, d_destination.y);
-      Maptile *tile = GameMap::getInstance()->getTile(d_destination);
-      if (tile)
+      MapBackpack *backpack =
+        GameMap::getInstance()->findBackpack(d_destination);
+      if (backpack)
 	{
-	  if (tile->getBackpack()->getPlantedItem(d_owner))
+	  if (backpack->getPlantedItem(d_owner))
 	    {
 	      //army arrives on a planted standard
 	      Army *a = new Army(*d_army, d_owner);
@@ -129,9 +130,7 @@ Army *VectoredUnit::armyArrives(Stack *& stack) const
 bool VectoredUnit::nextTurn()
 {
   d_duration--;
-  if (d_duration == 0)
-    return d_owner->vectoredUnitArrives(this);
-  return false;
+  return d_duration == 0;
 }
 
 int VectoredUnit::get_travel_turns (Vector<int> src, Vector<int> dest)
@@ -124,9 +124,12 @@ class VectoredUnit: public Ownable, public LocationBox, public sigc::trackable
 
 	// Methods that operate on class data and modify the class.
 
-        //! Process the vectored unit at the start of a new turn.
+        //! Count down the turns until the vectored unit arrives.
 	/**
-	 * @return True when this vectored unit has shown up at the destination
+	 * The unit isn't put on the map here.  VectoredUnitlist::nextTurn
+	 * hands the units that are due to their owners all at once.
+	 *
+	 * @return True when this vectored unit is due at the destination
 	 *         position on the game map.  Otherwise false.
 	 */
         bool nextTurn();
@@ -16,6 +16,7 @@
 //  02110-1301, USA.
 
 #include <assert.h>
+#include <map>
 #include <sigc++/functors/mem_fun.h>
 
 #include "vectoredunitlist.h"
@@ -109,17 +110,19 @@ void VectoredUnitlist::nextTurn(Player* p)
 {
   debug("next_turn(" <<p->getName() <<")");
 
+  // count down every unit first, and then let each player take delivery
+  // of all of their arrivals at once.
+  std::map<Player*, std::list<VectoredUnit*> > arrivals;
   for (VectoredUnitlist::iterator it = begin(); it != end(); it++)
     {
       City *c = GameMap::getCity((*it)->getPos());
-      if (c)
-	{
-	  if (c->getOwner() == p)
-	    (*it)->nextTurn();
-	}
-      else //must be a standard
-	(*it)->nextTurn();
+      if (c && c->getOwner() != p) //no city means it must be a standard
+        continue;
+      if ((*it)->nextTurn())
+        arrivals[(*it)->getOwner()].push_back(*it);
     }
+  for (auto a: arrivals)
+    a.first->vectoredUnitsArrive(a.second);
 
   for (VectoredUnitlist::iterator it = begin(); it != end();)
     {
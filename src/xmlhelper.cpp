@@ -136,8 +136,9 @@ bool XML_Helper::openTag(Glib::ustring name)
 
     addTabs();
 
-    // append the version strin got the first opened tag
-    if (d_tags.empty())
+    // append the version strin got the first opened tag, unless this is
+    // a fragment that never had begin() called on it.
+    if (d_tags.empty() && d_version != "")
         (*d_out) <<"<" <<name <<" version=\"" <<d_version <<"\">\n";
     else
         (*d_out) <<"<" <<name <<">\n";
@@ -311,6 +312,18 @@ bool XML_Helper::saveData(Glib::ustring name, unsigned long int value)
     return saveData(name, static_cast<guint32>(value));
 }
 
+bool XML_Helper::saveRaw(const std::string &xml)
+{
+    if (!d_out)
+    {
+        std::cerr << "XML_Helper: no output stream given.\n";
+        return false;
+    }
+
+    (*d_out) << xml;
+    return true;
+}
+
 bool XML_Helper::close()
 {
     if (d_outbuf)        
@@ -129,6 +129,9 @@ class XML_Helper: public xmlpp::SaxParser
 
         //! Closes the most recently opened tag
         bool closeTag();
+
+        //! Writes out a tag that was already saved by another XML_Helper.
+        bool saveRaw(const std::string &xml);
         
         /** Save data
           * 